@@ -14,7 +14,7 @@ void main()
 {
     gpi.texCoord = a_texCoord;
     gpi.texIndex = a_texIndex;
-    gpi.color = a_color;
+    gpi.color = decode_color(a_color);
 
     #ifdef SKELETAL
     vec4 vtx = u_viewProjection * u_modelMatrix * u_bones[int(a_boneIndex)] * vec4(a_position, 1);
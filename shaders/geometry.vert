@@ -1,6 +1,7 @@
 #define VTX_INPUT_NORMAL
 #define VTX_INPUT_TEXCOORD
 #define VTX_INPUT_TEXCOORD_QUAD
+#define VTX_INPUT_SPRITE_CENTER
 #ifdef SKELETAL
 #define VTX_INPUT_BONE_INDEX
 #endif
@@ -21,23 +22,26 @@ void main()
     #endif
     mat4 mv = u_view * mm;
 
+    // a_spriteCenter is only set for batched and instanced sprites, it defaults to zero for everything else
+    vec4 spriteCenter = mv * vec4(a_spriteCenter, 0);
     if (u_isSprite != 0) {
         mv[0].xyz = vec3(1, 0, 0);
         mv[2].xyz = vec3(0, 0, 1);
     }
 
-    vec4 tmp = mv * vec4(a_position, 1);
-    gpi.vertexPosWorld = vec3(mm * vec4(a_position, 1));
+    vec4 tmp = mv * vec4(a_position, 1) + spriteCenter;
+    gpi.vertexPosWorld = vec3(mm * vec4(a_position + a_spriteCenter, 1));
     gl_Position = u_projection * tmp;
     gpi.texCoord = a_texCoord;
     gpi.texIndex = a_texIndex;
-    gpi.color = a_color;
+    gpi.color = decode_color(a_color);
 
-    gpi.normal = normalize(mat3(mm) * a_normal);
-    gpi.hbaoNormal = normalize(mat3(mv) * a_normal);
+    vec3 normal = decode_normal(a_normal);
+    gpi.normal = normalize(mat3(mm) * normal);
+    gpi.hbaoNormal = normalize(mat3(mv) * normal);
     gpi.vertexPos = tmp.xyz;
     float dist = 16 * clamp(1.0 - dot(normalize(u_csmLightDir), gpi.normal), 0.0, 1.0);
-    vec4 pos = vec4(a_position + dist * gpi.normal, 1);
+    vec4 pos = vec4(a_position + a_spriteCenter + dist * gpi.normal, 1);
     for (int i=0; i<CSMSplits; ++i)
     {
         #ifdef SKELETAL
@@ -49,23 +53,20 @@ void main()
         gpi.vertexPosLight[i] = (tmp.xyz / tmp.w) * 0.5 + 0.5;
     }
 
-    gpi.isQuad = a_isQuad;
-    if (a_isQuad != 0)
+    int quadIndex = int(a_quadIndex) - 1;
+    gpi.isQuad = quadIndex >= 0 ? 1 : 0;
+    if (quadIndex >= 0)
     {
         mat4 mvp = u_projection * mv;
 
-        vec4 tmp = mvp * vec4(a_quadVert1, 1);
-        gpi.quadVerts[0] = vec3(tmp.xy / tmp.w, tmp.w);
-        tmp = mvp * vec4(a_quadVert2, 1);
-        gpi.quadVerts[1] = vec3(tmp.xy / tmp.w, tmp.w);
-        tmp = mvp * vec4(a_quadVert3, 1);
-        gpi.quadVerts[2] = vec3(tmp.xy / tmp.w, tmp.w);
-        tmp = mvp * vec4(a_quadVert4, 1);
-        gpi.quadVerts[3] = vec3(tmp.xy / tmp.w, tmp.w);
+        for (int i=0; i<4; ++i) {
+            vec4 tmp = mvp * vec4(quads[quadIndex].vertices[i].xyz, 1);
+            gpi.quadVerts[i] = vec3(tmp.xy / tmp.w, tmp.w);
+        }
 
-        gpi.quadUvs[0] = a_quadUv1;
-        gpi.quadUvs[1] = a_quadUv2;
-        gpi.quadUvs[2] = a_quadUv3;
-        gpi.quadUvs[3] = a_quadUv4;
+        gpi.quadUvs[0] = quads[quadIndex].uvs[0].xy;
+        gpi.quadUvs[1] = quads[quadIndex].uvs[0].zw;
+        gpi.quadUvs[2] = quads[quadIndex].uvs[1].xy;
+        gpi.quadUvs[3] = quads[quadIndex].uvs[1].zw;
     }
 }
@@ -0,0 +1,24 @@
+#include "flat_pipeline_interface.glsl"
+
+layout(bindless_sampler) uniform sampler2D u_depth;
+
+layout(location=0) out float out_depth;
+
+// must match HiZPass::BlockSize
+const int BlockSize = 8;
+
+void main()
+{
+    // keeping the farthest depth of each block makes occlusion tests against the result conservative
+    ivec2 inSize = textureSize(u_depth, 0);
+    ivec2 base = ivec2(gl_FragCoord.xy) * BlockSize;
+    float d = 0;
+    for (int y = 0; y < BlockSize; ++y)
+    {
+        for (int x = 0; x < BlockSize; ++x)
+        {
+            d = max(d, texelFetch(u_depth, min(base + ivec2(x, y), inSize - 1), 0).r);
+        }
+    }
+    out_depth = d;
+}
@@ -1,7 +1,17 @@
 layout(location=0) in vec3 a_position;
 
 #ifdef VTX_INPUT_NORMAL
-layout(location=1) in vec3 a_normal;
+// octahedral encoded
+layout(location=1) in vec2 a_normal;
+
+vec3 decode_normal(in vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0 ? 1.0 : -1.0, n.y >= 0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
 #endif
 
 #ifdef VTX_INPUT_TEXCOORD
@@ -9,16 +19,27 @@ layout(location=2) in vec4 a_color;
 layout(location=3) in vec2 a_texCoord;
 layout(location=4) in float a_texIndex;
 
+// vertex colors are stored with 8 bits per channel, scaled down to fit brightness values above 1
+const float ColorScale = 2.0;
+
+vec4 decode_color(in vec4 c)
+{
+    return vec4(c.rgb * ColorScale, c.a);
+}
+
 #ifdef VTX_INPUT_TEXCOORD_QUAD
-layout(location=6) in float a_isQuad;
-layout(location=7) in vec3 a_quadVert1;
-layout(location=8) in vec3 a_quadVert2;
-layout(location=9) in vec3 a_quadVert3;
-layout(location=10) in vec3 a_quadVert4;
-layout(location=11) in vec2 a_quadUv1;
-layout(location=12) in vec2 a_quadUv2;
-layout(location=13) in vec2 a_quadUv3;
-layout(location=14) in vec2 a_quadUv4;
+// 1-based index into b_quads, 0 if the vertex doesn't belong to a distorted quad
+layout(location=6) in float a_quadIndex;
+
+struct DistortedQuad
+{
+    vec4 vertices[4];
+    vec4 uvs[2];
+};
+
+layout(std430, binding=4) readonly restrict buffer b_quads {
+    DistortedQuad quads[];
+};
 #endif
 #endif
 
@@ -26,6 +47,10 @@ layout(location=14) in vec2 a_quadUv4;
 layout(location=5) in float a_boneIndex;
 #endif
 
+#ifdef VTX_INPUT_SPRITE_CENTER
+layout(location=7) in vec3 a_spriteCenter;
+#endif
+
 #ifdef VTX_INPUT_COLOR_QUAD
 #ifdef VTX_INPUT_TEXCOORD_QUAD
 #error "Cannot use quad texcoord with color quad"
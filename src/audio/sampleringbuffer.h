@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <boost/assert.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace audio
+{
+/**
+ * @brief A lock-free queue of audio frames for exactly one producer and one consumer thread.
+ *
+ * Samples are stored deinterleaved, one plane per channel, so the consumer only needs to copy them. Positions are
+ * counted in frames since the buffer was created, and never wrap.
+ */
+class SampleRingBuffer final
+{
+public:
+  explicit SampleRingBuffer(size_t channels, size_t capacity)
+      : m_channels{channels}
+      , m_capacity{capacity}
+      , m_samples(channels * capacity)
+  {
+    BOOST_ASSERT(channels > 0 && capacity > 0);
+  }
+
+  [[nodiscard]] size_t getChannels() const noexcept
+  {
+    return m_channels;
+  }
+
+  //! Producer side.
+  [[nodiscard]] uint64_t getWritePosition() const noexcept
+  {
+    return m_writePosition.load(std::memory_order_relaxed);
+  }
+
+  //! Producer side.
+  [[nodiscard]] size_t getFreeFrames() const noexcept
+  {
+    return m_capacity
+           - (m_writePosition.load(std::memory_order_relaxed) - m_readPosition.load(std::memory_order_acquire));
+  }
+
+  //! Producer side; appends interleaved @a frames, returns the number of frames that fit into the buffer.
+  size_t writeInterleaved(const float* frames, size_t count)
+  {
+    const auto writePosition = m_writePosition.load(std::memory_order_relaxed);
+    count = std::min(count, getFreeFrames());
+    for(size_t i = 0; i < count; ++i)
+    {
+      const auto offset = (writePosition + i) % m_capacity;
+      for(size_t c = 0; c < m_channels; ++c)
+        m_samples[c * m_capacity + offset] = *frames++;
+    }
+    m_writePosition.store(writePosition + count, std::memory_order_release);
+    return count;
+  }
+
+  //! Consumer side.
+  [[nodiscard]] uint64_t getReadPosition() const noexcept
+  {
+    return m_readPosition.load(std::memory_order_relaxed);
+  }
+
+  //! Consumer side; copies up to @a count frames, channel c starting at @a dst + c * @a stride.
+  size_t read(float* dst, size_t count, size_t stride)
+  {
+    const auto readPosition = m_readPosition.load(std::memory_order_relaxed);
+    count = std::min<size_t>(count, m_writePosition.load(std::memory_order_acquire) - readPosition);
+
+    const auto offset = readPosition % m_capacity;
+    const auto head = std::min(count, m_capacity - offset);
+    for(size_t c = 0; c < m_channels; ++c)
+    {
+      const auto* plane = &m_samples[c * m_capacity];
+      std::copy_n(plane + offset, head, dst + c * stride);
+      std::copy_n(plane, count - head, dst + c * stride + head);
+    }
+
+    m_readPosition.store(readPosition + count, std::memory_order_release);
+    return count;
+  }
+
+  //! Consumer side; drops all frames before @a position, which must have been written already.
+  void skipTo(uint64_t position)
+  {
+    BOOST_ASSERT(position >= m_readPosition.load(std::memory_order_relaxed));
+    BOOST_ASSERT(position <= m_writePosition.load(std::memory_order_acquire));
+    m_readPosition.store(position, std::memory_order_release);
+  }
+
+private:
+  const size_t m_channels;
+  const size_t m_capacity;
+  std::vector<float> m_samples;
+  std::atomic<uint64_t> m_writePosition{0};
+  std::atomic<uint64_t> m_readPosition{0};
+};
+} // namespace audio
@@ -1,77 +1,129 @@
 #include "soundengine.h"
 
+#include <algorithm>
 #include <glm/gtx/string_cast.hpp>
+#include <numeric>
 
 namespace audio
 {
+namespace
+{
+//! Voices being mixed are preferred by this factor, so voices of similar volume don't keep replacing each other.
+constexpr float RealVoiceBias = 1.25f;
+} // namespace
+
 void SoundEngine::update()
 {
+  const auto now = std::chrono::steady_clock::now();
+  const auto elapsed = std::chrono::duration<double>(now - m_lastUpdate).count();
+  m_lastUpdate = now;
+
+  glm::vec3 listenerPos{0};
   if(m_listener != nullptr)
   {
-    const auto pos = m_listener->getPosition();
-    m_soLoud->set3dListenerPosition(pos.x, pos.y, pos.z);
+    listenerPos = m_listener->getPosition();
+    m_soLoud->set3dListenerPosition(listenerPos.x, listenerPos.y, listenerPos.z);
     const auto front = m_listener->getFrontVector();
     m_soLoud->set3dListenerAt(front.x, front.y, front.z);
     const auto up = m_listener->getUpVector();
     m_soLoud->set3dListenerUp(up.x, up.y, up.z);
   }
 
-  for(auto& [emitter, sourcesAndVoices] : m_voices)
+  m_voices.erase(std::remove_if(m_voices.begin(),
+                                m_voices.end(),
+                                [](const VoiceEntry& entry) { return !entry.voice->isValid(); }),
+                 m_voices.end());
+
+  for(auto& entry : m_voices)
   {
-    glm::vec3 pos;
-    if(emitter != nullptr)
-      pos = emitter->getPosition();
+    auto& voice = *entry.voice;
+    voice.advance(elapsed);
+    // only stored here, it's passed to SoLoud below if the voice is mixed
+    if(entry.emitter != nullptr)
+      voice.m_position = entry.emitter->getPosition();
+
+    entry.audibleVolume = voice.getAudibleVolume(listenerPos);
+    if(!voice.isVirtual())
+      entry.audibleVolume *= RealVoiceBias;
+  }
 
-    for(auto& [source, voices] : sourcesAndVoices)
-    {
-      auto old = std::move(voices);
-      std::copy_if(old.begin(), old.end(), std::back_inserter(voices), [](const auto& h) { return h->isValid(); });
+  const auto realCount = std::min(m_voiceBudget, m_voices.size());
+  m_voiceOrder.resize(m_voices.size());
+  std::iota(m_voiceOrder.begin(), m_voiceOrder.end(), 0);
+  std::nth_element(m_voiceOrder.begin(),
+                   std::next(m_voiceOrder.begin(), realCount),
+                   m_voiceOrder.end(),
+                   [this](size_t a, size_t b) { return m_voices[a].audibleVolume > m_voices[b].audibleVolume; });
 
-      if(emitter == nullptr)
-        continue;
+  // free the slots first, so SoLoud never has more voices than the budget
+  for(size_t i = realCount; i < m_voiceOrder.size(); ++i)
+  {
+    if(auto& voice = *m_voices[m_voiceOrder[i]].voice; !voice.isVirtual())
+      voice.makeVirtual();
+  }
+
+  bool anyStarted = false;
+  for(size_t i = 0; i < realCount; ++i)
+  {
+    auto& voice = *m_voices[m_voiceOrder[i]].voice;
+    if(m_voices[m_voiceOrder[i]].audibleVolume <= 0)
+    {
+      if(!voice.isVirtual())
+        voice.makeVirtual();
+      continue;
+    }
 
-      for(const auto& voice : voices)
-      {
-        voice->setPosition(pos);
-      }
+    if(voice.isVirtual())
+    {
+      voice.makeReal();
+      anyStarted = true;
+    }
+    else if(voice.m_positional)
+    {
+      voice.setPosition(voice.m_position);
     }
   }
 
   m_soLoud->update3dAudio();
+
+  // started voices are only unpaused after their 3d parameters are applied, so they don't start at the wrong volume
+  if(anyStarted)
+  {
+    for(size_t i = 0; i < realCount; ++i)
+    {
+      if(auto& voice = *m_voices[m_voiceOrder[i]].voice; !voice.isVirtual())
+        voice.unpauseReal();
+    }
+  }
 }
 
 std::vector<gsl::not_null<std::shared_ptr<Voice>>>
   SoundEngine::getVoicesForAudioSource(Emitter* emitter, const std::shared_ptr<SoLoud::AudioSource>& audioSource) const
 {
-  const auto it1 = m_voices.find(emitter);
-  if(it1 == m_voices.end())
-    return {};
-
-  const auto it2 = it1->second.find(audioSource);
-  if(it2 == it1->second.end())
-    return {};
-
-  return it2->second;
+  std::vector<gsl::not_null<std::shared_ptr<Voice>>> result;
+  for(const auto& entry : m_voices)
+  {
+    if(entry.emitter == emitter && entry.source == audioSource)
+      result.emplace_back(entry.voice);
+  }
+  return result;
 }
 
 bool SoundEngine::stop(const std::shared_ptr<SoLoud::AudioSource>& audioSource, Emitter* emitter)
 {
-  auto it1 = m_voices.find(emitter);
-  if(it1 == m_voices.end())
-    return false;
-
-  const auto it2 = it1->second.find(audioSource);
-  if(it2 == it1->second.end())
-    return false;
-
-  bool any = !it2->second.empty();
-  for(const auto& src : it2->second)
-  {
-    src->stop();
-  }
-
-  it1->second.erase(it2);
-
+  bool any = false;
+  m_voices.erase(std::remove_if(m_voices.begin(),
+                                m_voices.end(),
+                                [&any, &audioSource, emitter](const VoiceEntry& entry)
+                                {
+                                  if(entry.emitter != emitter || entry.source != audioSource)
+                                    return false;
+
+                                  entry.voice->stop();
+                                  any = true;
+                                  return true;
+                                }),
+                 m_voices.end());
   return any;
 }
 
@@ -80,38 +132,59 @@ gsl::not_null<std::shared_ptr<Voice>> SoundEngine::play(const std::shared_ptr<So
                                                         float volume,
                                                         Emitter* emitter)
 {
-  std::shared_ptr<Voice> voice;
+  auto voice = std::make_shared<Voice>(m_soLoud, audioSource, emitter != nullptr, volume, pitch);
   if(emitter != nullptr)
+    voice->m_position = emitter->getPosition();
+  m_voices.emplace_back(VoiceEntry{emitter, audioSource, voice});
+
+  // waiting for the next update would delay the sound noticeably, so start it right away if the budget allows
+  const auto realCount = std::count_if(
+    m_voices.begin(), m_voices.end(), [](const VoiceEntry& entry) { return !entry.voice->isVirtual(); });
+  if(gsl::narrow<size_t>(realCount) < m_voiceBudget)
   {
-    const auto pos = emitter->getPosition();
-    voice = std::make_shared<Voice>(
-      m_soLoud, audioSource, m_soLoud->play3d(*audioSource, pos.x, pos.y, pos.z, 0, 0, 0, volume, true));
-    voice->init3dParams();
-  }
-  else
-  {
-    voice = std::make_shared<Voice>(m_soLoud, audioSource, m_soLoud->play(*audioSource, volume, 0, true));
+    voice->makeReal();
+    m_soLoud->update3dAudio();
+    voice->unpauseReal();
   }
-  Ensures(voice != nullptr);
 
-  voice->setRelativePlaySpeed(pitch);
-  m_voices[emitter][audioSource].emplace_back(voice);
-  m_soLoud->update3dAudio();
-  voice->play();
   return voice;
 }
 
 void SoundEngine::dropEmitter(Emitter* emitter)
 {
-  const auto it = m_voices.find(emitter);
-  if(it == m_voices.end())
-    return;
+  m_voices.erase(std::remove_if(m_voices.begin(),
+                                m_voices.end(),
+                                [emitter](const VoiceEntry& entry)
+                                {
+                                  if(entry.emitter != emitter)
+                                    return false;
+
+                                  entry.voice->stop();
+                                  return true;
+                                }),
+                 m_voices.end());
+}
+
+void SoundEngine::setVoiceBudget(size_t budget)
+{
+  // soloud needs at least one active voice, and supports less than VOICE_COUNT of them
+  static constexpr size_t MaxVoiceBudget = VOICE_COUNT - 1 - StreamVoices;
+  if(const auto clamped = std::clamp(budget, size_t{1}, MaxVoiceBudget); clamped != budget)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Voice budget " << budget << " is out of range, using " << clamped << " instead";
+    budget = clamped;
+  }
 
-  for(const auto& [source, voices] : it->second)
-    for(const auto& voice : voices)
-      voice->stop();
+  if(const auto result = m_soLoud->setMaxActiveVoiceCount(gsl::narrow<unsigned int>(budget + StreamVoices));
+     result != SoLoud::SO_NO_ERROR)
+  {
+    BOOST_LOG_TRIVIAL(error) << "Failed to set the voice budget to " << budget << ": "
+                             << m_soLoud->getErrorString(result);
+    return;
+  }
 
-  m_voices.erase(it);
+  BOOST_LOG_TRIVIAL(info) << "Mixing at most " << budget << " voices";
+  m_voiceBudget = budget;
 }
 
 SoundEngine::~SoundEngine()
@@ -159,6 +232,7 @@ SoundEngine::SoundEngine()
                           << m_soLoud->getBackendBufferSize();
 
   m_soLoud->setGlobalVolume(0.0f);
+  setVoiceBudget(DefaultVoiceBudget);
   m_underwaterFilter.setParams(SoLoud::BiquadResonantFilter::LOWPASS, 250, 1);
 }
 
@@ -3,11 +3,12 @@
 #include "util.h"
 #include "voice.h"
 
+#include <chrono>
 #include <glm/glm.hpp>
 #include <gsl/gsl-lite.hpp>
 #include <soloud_biquadresonantfilter.h>
-#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace audio
 {
@@ -64,12 +65,21 @@ private:
   mutable SoundEngine* m_engine = nullptr;
 };
 
+/**
+ * @brief Plays sounds, mixing only the most audible voices.
+ *
+ * At most a budget of voices is mixed at the same time, chosen by their volume as heard by the listener. All other
+ * voices are virtual until they are audible enough again. Background streams are always mixed and don't count
+ * against the budget.
+ */
 class SoundEngine final
 {
   friend class Emitter;
   friend class Listener;
 
 public:
+  static constexpr size_t DefaultVoiceBudget = 32;
+
   SoundEngine();
 
   ~SoundEngine();
@@ -102,10 +112,14 @@ public:
     m_listener = listener;
   }
 
+  //! Updates listener and voice positions, and selects the voices to mix.
   void update();
 
   void dropEmitter(Emitter* emitter);
 
+  //! Out of range budgets are clamped to what the mixer supports; the budget is left unchanged if it can't be applied.
+  void setVoiceBudget(size_t budget);
+
   void reset();
 
   SoLoud::Filter& getUnderwaterFilter()
@@ -120,11 +134,23 @@ public:
   }
 
 private:
+  //! Voices reserved for background streams.
+  static constexpr size_t StreamVoices = 2;
+
+  struct VoiceEntry
+  {
+    Emitter* emitter;
+    std::shared_ptr<SoLoud::AudioSource> source;
+    gsl::not_null<std::shared_ptr<audio::Voice>> voice;
+    float audibleVolume = 0;
+  };
+
   gsl::not_null<std::shared_ptr<SoLoud::Soloud>> m_soLoud;
-  std::unordered_map<
-    Emitter*,
-    std::unordered_map<std::shared_ptr<SoLoud::AudioSource>, std::vector<gsl::not_null<std::shared_ptr<audio::Voice>>>>>
-    m_voices;
+  std::vector<VoiceEntry> m_voices;
+  //! Indices into m_voices, ordered by audibility; only kept to avoid allocations.
+  std::vector<size_t> m_voiceOrder;
+  size_t m_voiceBudget = DefaultVoiceBudget;
+  std::chrono::steady_clock::time_point m_lastUpdate = std::chrono::steady_clock::now();
   const Listener* m_listener = nullptr;
 
   std::unordered_set<Emitter*> m_emitters;
@@ -0,0 +1,246 @@
+#include "streamsource.h"
+
+#include "sampleringbuffer.h"
+#include "sndfile/helpers.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/log/trivial.hpp>
+#include <boost/throw_exception.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <gsl/gsl-lite.hpp>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <sndfile.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace audio
+{
+namespace
+{
+// CDAUDIO.WAD step size defines CDAUDIO's header stride, on which each track
+// info is placed. Also CDAUDIO count specifies static amount of tracks existing
+// in CDAUDIO.WAD file. Name length specifies maximum string size for trackname.
+constexpr size_t WADStride = 268;
+constexpr size_t WADNameLength = 260;
+
+//! How much audio is decoded ahead.
+constexpr std::chrono::seconds BufferDuration{2};
+//! The maximum number of frames decoded at once.
+constexpr size_t ChunkFrames = 4096;
+//! Wake-ups may get lost, as the mixer doesn't lock the mutex, so the decoder checks for work at least this often.
+constexpr std::chrono::milliseconds PollInterval{20};
+constexpr uint64_t NoEnd = std::numeric_limits<uint64_t>::max();
+} // namespace
+
+class WadStreamInstance::Decoder final
+{
+public:
+  Decoder(const std::filesystem::path& filename, size_t trackIndex)
+      : m_wadFile{filename, std::ios::in | std::ios::binary}
+  {
+    BOOST_LOG_TRIVIAL(trace) << "Creating WAD stream source from " << filename << ", track " << trackIndex;
+
+    if(!m_wadFile.is_open())
+      BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open WAD file"));
+
+    m_wadFile.seekg(trackIndex * WADStride, std::ios::beg);
+
+    std::array<char, WADNameLength> trackName{};
+    m_wadFile.read(trackName.data(), WADNameLength);
+
+    BOOST_LOG_TRIVIAL(info) << "Loading WAD track " << trackIndex << ": " << trackName.data();
+
+    uint32_t offset = 0;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_wadFile.read(reinterpret_cast<char*>(&offset), 4);
+
+    uint32_t length = 0;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_wadFile.read(reinterpret_cast<char*>(&length), 4);
+
+    m_wadFile.seekg(offset, std::ios::beg);
+    m_wrapper = std::make_unique<sndfile::InputStreamViewWrapper>(m_wadFile, offset, offset + length);
+
+    m_sndFile = sf_open_virtual(m_wrapper.get(), SFM_READ, &m_sfInfo, m_wrapper.get());
+    if(m_sndFile == nullptr)
+    {
+      BOOST_LOG_TRIVIAL(error) << "Failed to open WAD file: " << sf_strerror(nullptr);
+      BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open WAD file"));
+    }
+
+    m_buffer.emplace(gsl::narrow<size_t>(m_sfInfo.channels),
+                     gsl::narrow<size_t>(m_sfInfo.samplerate * BufferDuration.count()));
+    m_chunk.resize(ChunkFrames * m_sfInfo.channels);
+  }
+
+  ~Decoder()
+  {
+    sf_close(m_sndFile);
+  }
+
+  Decoder(const Decoder&) = delete;
+  Decoder(Decoder&&) = delete;
+  Decoder& operator=(const Decoder&) = delete;
+  Decoder& operator=(Decoder&&) = delete;
+
+  [[nodiscard]] const SF_INFO& getInfo() const noexcept
+  {
+    return m_sfInfo;
+  }
+
+  //! Decodes as much as fits into the buffer; returns false if there was nothing to do.
+  bool decode()
+  {
+    if(const auto generation = requestedSeekGeneration.load(std::memory_order_acquire);
+       generation != handledSeekGeneration.load(std::memory_order_relaxed))
+    {
+      sf_seek(m_sndFile, seekFrame.load(std::memory_order_relaxed), SF_SEEK_SET);
+      m_atEnd = false;
+      endPosition.store(NoEnd, std::memory_order_relaxed);
+      flushPosition.store(m_buffer->getWritePosition(), std::memory_order_relaxed);
+      handledSeekGeneration.store(generation, std::memory_order_release);
+    }
+
+    const auto frames = std::min(m_buffer->getFreeFrames(), ChunkFrames);
+    if(m_atEnd || frames == 0)
+      return false;
+
+    const auto readFrames = sf_readf_float(m_sndFile, m_chunk.data(), gsl::narrow<sf_count_t>(frames));
+    if(readFrames > 0)
+      m_buffer->writeInterleaved(m_chunk.data(), gsl::narrow<size_t>(readFrames));
+
+    if(gsl::narrow<size_t>(std::max<sf_count_t>(readFrames, 0)) < frames)
+    {
+      // continuing right away avoids the gap a rewind request from the mixer would cause
+      if(looping.load(std::memory_order_relaxed))
+      {
+        sf_seek(m_sndFile, 0, SF_SEEK_SET);
+      }
+      else
+      {
+        m_atEnd = true;
+        endPosition.store(m_buffer->getWritePosition(), std::memory_order_release);
+      }
+    }
+
+    return true;
+  }
+
+  void run()
+  {
+    while(!stop.load(std::memory_order_relaxed))
+    {
+      if(decode())
+        continue;
+
+      std::unique_lock lock{m_mutex};
+      m_wakeup.wait_for(lock, PollInterval);
+    }
+  }
+
+  //! Never blocks, so it's safe to be called by the mixer.
+  void wakeUp()
+  {
+    m_wakeup.notify_one();
+  }
+
+  SampleRingBuffer& getBuffer()
+  {
+    return *m_buffer;
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<bool> looping{false};
+  //! Set by the mixer; the frame is set before the generation is incremented.
+  std::atomic<sf_count_t> seekFrame{0};
+  std::atomic<uint64_t> requestedSeekGeneration{0};
+  //! Set by the decoder; when a seek is handled, all frames before the flush position are outdated.
+  std::atomic<uint64_t> handledSeekGeneration{0};
+  std::atomic<uint64_t> flushPosition{0};
+  //! The buffer position at which the track ends, if it was decoded to its end.
+  std::atomic<uint64_t> endPosition{NoEnd};
+
+private:
+  std::ifstream m_wadFile;
+  std::unique_ptr<sndfile::InputStreamViewWrapper> m_wrapper;
+  SF_INFO m_sfInfo{};
+  SNDFILE* m_sndFile = nullptr;
+  std::optional<SampleRingBuffer> m_buffer;
+  //! Interleaved frames as read from the file.
+  std::vector<float> m_chunk;
+  bool m_atEnd = false;
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+};
+
+WadStreamInstance::WadStreamInstance(const std::filesystem::path& filename, const size_t trackIndex)
+    : m_decoder{std::make_shared<Decoder>(filename, trackIndex)}
+{
+  mChannels = m_decoder->getInfo().channels;
+  mBaseSamplerate = static_cast<float>(m_decoder->getInfo().samplerate);
+
+  // the instance is created outside of the mixer, so the first samples can be decoded here without causing a gap
+  m_decoder->decode();
+  std::thread{[decoder = m_decoder]() { decoder->run(); }}.detach();
+}
+
+WadStreamInstance::~WadStreamInstance()
+{
+  // the mixer may destroy the instance, and must not wait for the decoder to finish its current file I/O
+  m_decoder->stop.store(true, std::memory_order_relaxed);
+  m_decoder->wakeUp();
+}
+
+unsigned int WadStreamInstance::getAudio(float* aBuffer, unsigned int aSamplesToRead, unsigned int aBufferSize)
+{
+  m_decoder->looping.store((mFlags & SoLoud::AudioSourceInstance::FLAGS::LOOPING) != 0, std::memory_order_relaxed);
+
+  auto& buffer = m_decoder->getBuffer();
+  size_t frames = 0;
+  if(m_decoder->handledSeekGeneration.load(std::memory_order_acquire) == m_seekGeneration)
+  {
+    if(m_flushedGeneration != m_seekGeneration)
+    {
+      buffer.skipTo(m_decoder->flushPosition.load(std::memory_order_relaxed));
+      m_flushedGeneration = m_seekGeneration;
+    }
+    frames = buffer.read(aBuffer, aSamplesToRead, aBufferSize);
+  }
+
+  m_decoder->wakeUp();
+
+  // a pending seek or a decoder that fell behind is heard as a short silence, instead of stalling the mixer
+  for(size_t c = 0; c < buffer.getChannels(); ++c)
+    std::fill_n(aBuffer + c * aBufferSize + frames, aSamplesToRead - frames, 0.0f);
+
+  return aSamplesToRead;
+}
+
+bool WadStreamInstance::hasEnded()
+{
+  return m_decoder->handledSeekGeneration.load(std::memory_order_acquire) == m_seekGeneration
+         && m_flushedGeneration == m_seekGeneration
+         && m_decoder->getBuffer().getReadPosition() >= m_decoder->endPosition.load(std::memory_order_acquire);
+}
+
+SoLoud::result WadStreamInstance::seek(SoLoud::time aSeconds, float* /*mScratch*/, unsigned int /*mScratchSize*/)
+{
+  m_decoder->seekFrame.store(static_cast<sf_count_t>(m_decoder->getInfo().samplerate * aSeconds),
+                             std::memory_order_relaxed);
+  m_decoder->requestedSeekGeneration.store(++m_seekGeneration, std::memory_order_release);
+  m_decoder->wakeUp();
+  return SoLoud::SO_NO_ERROR;
+}
+
+SoLoud::result WadStreamInstance::rewind()
+{
+  return seek(0, nullptr, 0);
+}
+} // namespace audio
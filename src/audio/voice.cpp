@@ -0,0 +1,97 @@
+#include "voice.h"
+
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <cmath>
+#include <soloud_wav.h>
+
+namespace audio
+{
+Voice::Voice(gsl::not_null<std::shared_ptr<SoLoud::Soloud>> soLoud,
+             gsl::not_null<std::shared_ptr<SoLoud::AudioSource>> source,
+             bool positional,
+             float volume,
+             float speed)
+    : m_soLoud{std::move(soLoud)}
+    , m_source{std::move(source)}
+    , m_positional{positional}
+    , m_volume{volume}
+    , m_speed{speed}
+{
+  // streams don't have a length, and simply continue where they were when becoming audible again
+  if(const auto wav = std::dynamic_pointer_cast<SoLoud::Wav>(m_source.get()))
+    m_length = wav->getLength();
+}
+
+void Voice::makeReal()
+{
+  BOOST_ASSERT(isVirtual());
+
+  if(m_positional)
+  {
+    m_voiceHandle
+      = m_soLoud->play3d(*m_source, m_position.x, m_position.y, m_position.z, 0, 0, 0, m_volume, true);
+    m_soLoud->set3dSourceAttenuation(*m_voiceHandle, SoLoud::AudioSource::LINEAR_DISTANCE, 1);
+    m_soLoud->set3dSourceMinMaxDistance(*m_voiceHandle, 0, MaxDistance);
+  }
+  else
+  {
+    m_voiceHandle = m_soLoud->play(*m_source, m_volume, 0, true);
+  }
+
+  m_soLoud->setLooping(*m_voiceHandle, m_looping);
+  m_soLoud->setRelativePlaySpeed(*m_voiceHandle, m_speed);
+  if(m_streamPosition > 0)
+    m_soLoud->seek(*m_voiceHandle, m_streamPosition);
+}
+
+void Voice::makeVirtual()
+{
+  BOOST_ASSERT(!isVirtual());
+
+  m_streamPosition = m_soLoud->getStreamPosition(*m_voiceHandle);
+  m_soLoud->stop(*m_voiceHandle);
+  m_voiceHandle.reset();
+}
+
+void Voice::unpauseReal()
+{
+  BOOST_ASSERT(!isVirtual());
+
+  if(!m_paused)
+    m_soLoud->setPause(*m_voiceHandle, false);
+}
+
+void Voice::advance(double seconds)
+{
+  if(!isVirtual() || m_paused || m_stopped)
+    return;
+
+  m_streamPosition += seconds * m_speed;
+  if(m_looping && m_length.has_value() && *m_length > 0)
+    m_streamPosition = std::fmod(m_streamPosition, *m_length);
+}
+
+float Voice::getAudibleVolume(const glm::vec3& listenerPos) const
+{
+  if(m_paused || m_stopped)
+    return 0;
+
+  if(!m_positional)
+    return m_volume;
+
+  // the same attenuation as set up for real voices
+  return m_volume * std::clamp(1 - glm::distance(m_position, listenerPos) / MaxDistance, 0.0f, 1.0f);
+}
+
+bool Voice::isValid() const
+{
+  if(m_stopped)
+    return false;
+
+  if(m_voiceHandle.has_value())
+    return m_soLoud->isValidVoiceHandle(*m_voiceHandle);
+
+  return m_looping || !m_length.has_value() || m_streamPosition < *m_length;
+}
+} // namespace audio
@@ -5,68 +5,127 @@
 #include <chrono>
 #include <glm/glm.hpp>
 #include <gsl/gsl-lite.hpp>
+#include <optional>
 #include <soloud.h>
 
 namespace audio
 {
+class SoundEngine;
+
+/**
+ * @brief A playing sound.
+ *
+ * Voices managed by the SoundEngine may be virtual, i.e. they are tracked, but not mixed. All state is kept here, so a
+ * virtual voice continues at the position it would have reached when it becomes audible again.
+ */
 class Voice
 {
+  friend class SoundEngine;
+
 private:
   const gsl::not_null<std::shared_ptr<SoLoud::Soloud>> m_soLoud;
   const gsl::not_null<std::shared_ptr<SoLoud::AudioSource>> m_source;
-  const SoLoud::handle m_voiceHandle;
+  //! Empty while the voice is virtual.
+  std::optional<SoLoud::handle> m_voiceHandle;
+  //! The length of the source, if known.
+  std::optional<double> m_length;
+  bool m_positional = false;
+  bool m_looping = false;
+  bool m_paused = false;
+  bool m_stopped = false;
+  float m_volume = 1;
+  float m_speed = 1;
+  glm::vec3 m_position{0};
+  //! The playback position in seconds, only maintained while the voice is virtual.
+  double m_streamPosition = 0;
 
   static constexpr float MaxDistance = 12 * core::SectorSize.get<float>();
 
+  //! Starts mixing the voice; it is paused by SoLoud until unpauseReal() is called.
+  void makeReal();
+  //! Stops mixing the voice, but keeps track of its state.
+  void makeVirtual();
+  void unpauseReal();
+  //! Advances the playback position of a virtual voice.
+  void advance(double seconds);
+  //! The volume the listener at @a listenerPos would hear.
+  [[nodiscard]] float getAudibleVolume(const glm::vec3& listenerPos) const;
+
+  [[nodiscard]] bool isVirtual() const noexcept
+  {
+    return !m_voiceHandle.has_value();
+  }
+
 public:
+  //! A voice that is always mixed, for voices not managed by the SoundEngine.
   explicit Voice(gsl::not_null<std::shared_ptr<SoLoud::Soloud>> soLoud,
                  gsl::not_null<std::shared_ptr<SoLoud::AudioSource>> source,
                  SoLoud::handle voiceHandle)
       : m_soLoud{std::move(soLoud)}
-      , m_source{source}
+      , m_source{std::move(source)}
       , m_voiceHandle{voiceHandle}
   {
   }
 
+  //! A voice that starts virtual.
+  explicit Voice(gsl::not_null<std::shared_ptr<SoLoud::Soloud>> soLoud,
+                 gsl::not_null<std::shared_ptr<SoLoud::AudioSource>> source,
+                 bool positional,
+                 float volume,
+                 float speed);
+
+  Voice(const Voice&) = delete;
+  Voice(Voice&&) = delete;
+  Voice& operator=(const Voice&) = delete;
+  Voice& operator=(Voice&&) = delete;
+
   void setLooping(bool looping)
   {
-    m_soLoud->setLooping(m_voiceHandle, looping);
+    m_looping = looping;
+    if(m_voiceHandle.has_value())
+      m_soLoud->setLooping(*m_voiceHandle, looping);
   }
 
   void pause(bool paused = true)
   {
-    m_soLoud->setPause(m_voiceHandle, paused);
+    m_paused = paused;
+    if(m_voiceHandle.has_value())
+      m_soLoud->setPause(*m_voiceHandle, paused);
   }
 
   void stop()
   {
-    m_soLoud->stop(m_voiceHandle);
+    m_stopped = true;
+    if(m_voiceHandle.has_value())
+      m_soLoud->stop(*m_voiceHandle);
   }
 
   void setVolume(float volume)
   {
-    m_soLoud->setVolume(m_voiceHandle, volume);
+    m_volume = volume;
+    if(m_voiceHandle.has_value())
+      m_soLoud->setVolume(*m_voiceHandle, volume);
   }
 
   void fadeVolume(float volume, std::chrono::milliseconds time)
   {
-    m_soLoud->fadeVolume(m_voiceHandle, volume, time.count() / 1000.0);
+    m_volume = volume;
+    if(m_voiceHandle.has_value())
+      m_soLoud->fadeVolume(*m_voiceHandle, volume, time.count() / 1000.0);
   }
 
   void setRelativePlaySpeed(float factor)
   {
-    m_soLoud->setRelativePlaySpeed(m_voiceHandle, factor);
+    m_speed = factor;
+    if(m_voiceHandle.has_value())
+      m_soLoud->setRelativePlaySpeed(*m_voiceHandle, factor);
   }
 
   void setPosition(const glm::vec3& pos)
   {
-    m_soLoud->set3dSourcePosition(m_voiceHandle, pos.x, pos.y, pos.z);
-  }
-
-  void init3dParams()
-  {
-    m_soLoud->set3dSourceAttenuation(m_voiceHandle, SoLoud::AudioSource::LINEAR_DISTANCE, 1);
-    m_soLoud->set3dSourceMinMaxDistance(m_voiceHandle, 0, MaxDistance);
+    m_position = pos;
+    if(m_voiceHandle.has_value())
+      m_soLoud->set3dSourcePosition(*m_voiceHandle, pos.x, pos.y, pos.z);
   }
 
   void play()
@@ -76,18 +135,19 @@ public:
 
   void restart()
   {
-    m_soLoud->seek(m_voiceHandle, 0);
+    m_stopped = false;
+    m_streamPosition = 0;
+    if(m_voiceHandle.has_value())
+      m_soLoud->seek(*m_voiceHandle, 0);
     pause(false);
   }
 
-  bool isValid() const
-  {
-    return m_soLoud->isValidVoiceHandle(m_voiceHandle);
-  }
+  [[nodiscard]] bool isValid() const;
 
   void setProtect(bool protect)
   {
-    m_soLoud->setProtectVoice(m_voiceHandle, protect);
+    if(m_voiceHandle.has_value())
+      m_soLoud->setProtectVoice(*m_voiceHandle, protect);
   }
 
   virtual ~Voice()
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <gsl/gsl-lite.hpp>
+#include <limits>
+#include <vector>
+
+namespace core
+{
+/**
+ * @brief Stores values contiguously and references them by generational handles.
+ *
+ * Lookups by handle are O(1), and handles of erased values become invalid even if their slot is reused. Erasing
+ * is deferred: values are only marked by scheduleErase(), and removed by a single pass of applyErasures(), which
+ * keeps the remaining values in their insertion order.
+ */
+template<typename T>
+class SlotMap final
+{
+public:
+  struct Handle
+  {
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool operator==(const Handle& rhs) const noexcept
+    {
+      return index == rhs.index && generation == rhs.generation;
+    }
+
+    [[nodiscard]] bool operator!=(const Handle& rhs) const noexcept
+    {
+      return !(*this == rhs);
+    }
+  };
+
+  using iterator = typename std::vector<T>::iterator;
+  using const_iterator = typename std::vector<T>::const_iterator;
+
+  Handle insert(T value)
+  {
+    uint32_t index;
+    if(m_freeSlots.empty())
+    {
+      index = gsl::narrow<uint32_t>(m_slots.size());
+      m_slots.emplace_back();
+    }
+    else
+    {
+      index = m_freeSlots.back();
+      m_freeSlots.pop_back();
+    }
+
+    auto& slot = m_slots[index];
+    slot.denseIndex = gsl::narrow<uint32_t>(m_values.size());
+    slot.occupied = true;
+    slot.scheduledForErase = false;
+    m_values.emplace_back(std::move(value));
+    m_denseSlots.emplace_back(index);
+    return Handle{index, slot.generation};
+  }
+
+  //! Like insert(), but places @a value before the value at @a denseIndex instead of appending it.
+  Handle insertAt(size_t denseIndex, T value)
+  {
+    Expects(denseIndex <= m_values.size());
+
+    const auto handle = insert(std::move(value));
+    std::rotate(m_values.begin() + denseIndex, std::prev(m_values.end()), m_values.end());
+    std::rotate(m_denseSlots.begin() + denseIndex, std::prev(m_denseSlots.end()), m_denseSlots.end());
+    for(size_t i = denseIndex; i < m_denseSlots.size(); ++i)
+      m_slots[m_denseSlots[i]].denseIndex = gsl::narrow<uint32_t>(i);
+    return handle;
+  }
+
+  [[nodiscard]] bool contains(const Handle& handle) const noexcept
+  {
+    return handle.index < m_slots.size() && m_slots[handle.index].occupied
+           && m_slots[handle.index].generation == handle.generation;
+  }
+
+  [[nodiscard]] T* get(const Handle& handle) noexcept
+  {
+    if(!contains(handle))
+      return nullptr;
+    return &m_values[m_slots[handle.index].denseIndex];
+  }
+
+  [[nodiscard]] const T* get(const Handle& handle) const noexcept
+  {
+    if(!contains(handle))
+      return nullptr;
+    return &m_values[m_slots[handle.index].denseIndex];
+  }
+
+  [[nodiscard]] Handle getHandle(size_t denseIndex) const
+  {
+    const auto index = m_denseSlots.at(denseIndex);
+    return Handle{index, m_slots[index].generation};
+  }
+
+  void scheduleErase(const Handle& handle)
+  {
+    if(!contains(handle))
+      return;
+
+    m_slots[handle.index].scheduledForErase = true;
+    m_hasScheduledErasures = true;
+  }
+
+  [[nodiscard]] bool isScheduledForErase(const Handle& handle) const noexcept
+  {
+    return contains(handle) && m_slots[handle.index].scheduledForErase;
+  }
+
+  void applyErasures()
+  {
+    applyErasures([](const T& /*value*/) {});
+  }
+
+  //! Like applyErasures(), but calls @a onErase for each value before it is removed.
+  template<typename F>
+  void applyErasures(const F& onErase)
+  {
+    if(!m_hasScheduledErasures)
+      return;
+
+    size_t dst = 0;
+    for(size_t src = 0; src < m_values.size(); ++src)
+    {
+      const auto index = m_denseSlots[src];
+      auto& slot = m_slots[index];
+      if(slot.scheduledForErase)
+      {
+        onErase(m_values[src]);
+        slot.occupied = false;
+        slot.scheduledForErase = false;
+        ++slot.generation;
+        m_freeSlots.emplace_back(index);
+        continue;
+      }
+
+      if(dst != src)
+      {
+        m_values[dst] = std::move(m_values[src]);
+        m_denseSlots[dst] = index;
+        slot.denseIndex = gsl::narrow<uint32_t>(dst);
+      }
+      ++dst;
+    }
+
+    m_values.erase(m_values.begin() + dst, m_values.end());
+    m_denseSlots.erase(m_denseSlots.begin() + dst, m_denseSlots.end());
+    m_hasScheduledErasures = false;
+  }
+
+  void clear()
+  {
+    for(const auto index : m_denseSlots)
+    {
+      auto& slot = m_slots[index];
+      slot.occupied = false;
+      slot.scheduledForErase = false;
+      ++slot.generation;
+      m_freeSlots.emplace_back(index);
+    }
+    m_values.clear();
+    m_denseSlots.clear();
+    m_hasScheduledErasures = false;
+  }
+
+  [[nodiscard]] size_t size() const noexcept
+  {
+    return m_values.size();
+  }
+
+  [[nodiscard]] bool empty() const noexcept
+  {
+    return m_values.empty();
+  }
+
+  [[nodiscard]] T& operator[](size_t denseIndex)
+  {
+    return m_values.at(denseIndex);
+  }
+
+  [[nodiscard]] const T& operator[](size_t denseIndex) const
+  {
+    return m_values.at(denseIndex);
+  }
+
+  [[nodiscard]] iterator begin() noexcept
+  {
+    return m_values.begin();
+  }
+
+  [[nodiscard]] iterator end() noexcept
+  {
+    return m_values.end();
+  }
+
+  [[nodiscard]] const_iterator begin() const noexcept
+  {
+    return m_values.begin();
+  }
+
+  [[nodiscard]] const_iterator end() const noexcept
+  {
+    return m_values.end();
+  }
+
+private:
+  struct Slot
+  {
+    uint32_t denseIndex = 0;
+    uint32_t generation = 0;
+    bool occupied = false;
+    bool scheduledForErase = false;
+  };
+
+  std::vector<T> m_values;
+  //! Maps each value to the slot referencing it.
+  std::vector<uint32_t> m_denseSlots;
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_freeSlots;
+  bool m_hasScheduledErasures = false;
+};
+} // namespace core
@@ -2,6 +2,7 @@
 
 #include "angle.h"
 #include "boundingbox.h"
+#include "slotmap.h"
 
 #include <boost/test/included/unit_test.hpp>
 
@@ -63,4 +64,62 @@ BOOST_AUTO_TEST_CASE(test_bounding_box_intersects)
   BOOST_CHECK(!f.intersects(f));
 }
 
+BOOST_AUTO_TEST_CASE(test_slotmap_erase)
+{
+  core::SlotMap<int> map;
+  const auto a = map.insert(1);
+  const auto b = map.insert(2);
+  const auto c = map.insert(3);
+  BOOST_CHECK_EQUAL(map.size(), 3);
+
+  map.scheduleErase(b);
+  BOOST_CHECK(map.contains(b));
+  BOOST_CHECK(map.isScheduledForErase(b));
+  map.applyErasures();
+  BOOST_CHECK(!map.contains(b));
+  BOOST_CHECK(map.get(b) == nullptr);
+  BOOST_CHECK_EQUAL(*map.get(a), 1);
+  BOOST_CHECK_EQUAL(*map.get(c), 3);
+  BOOST_CHECK((std::vector<int>{map.begin(), map.end()} == std::vector<int>{1, 3}));
+  BOOST_CHECK(map.getHandle(1) == c);
+}
+
+BOOST_AUTO_TEST_CASE(test_slotmap_stale_handles)
+{
+  core::SlotMap<int> map;
+  const auto a = map.insert(1);
+  map.scheduleErase(a);
+  map.applyErasures();
+
+  const auto b = map.insert(2);
+  BOOST_CHECK_EQUAL(a.index, b.index);
+  BOOST_CHECK(a != b);
+  BOOST_CHECK(!map.contains(a));
+  BOOST_CHECK_EQUAL(*map.get(b), 2);
+
+  map.scheduleErase(a);
+  map.applyErasures();
+  BOOST_CHECK(map.contains(b));
+
+  map.clear();
+  BOOST_CHECK(map.empty());
+  BOOST_CHECK(!map.contains(b));
+}
+
+BOOST_AUTO_TEST_CASE(test_slotmap_insert_at)
+{
+  core::SlotMap<int> map;
+  const auto a = map.insert(1);
+  const auto c = map.insert(3);
+  const auto b = map.insertAt(1, 2);
+  BOOST_CHECK((std::vector<int>{map.begin(), map.end()} == std::vector<int>{1, 2, 3}));
+  BOOST_CHECK(map.getHandle(1) == b);
+  BOOST_CHECK(map.getHandle(2) == c);
+
+  map.scheduleErase(a);
+  map.applyErasures();
+  BOOST_CHECK_EQUAL(*map.get(b), 2);
+  BOOST_CHECK_EQUAL(*map.get(c), 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
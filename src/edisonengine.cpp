@@ -1,6 +1,7 @@
 #include "engine/engine.h"
 #include "engine/player.h"
 #include "engine/script/reflection.h"
+#include "engine/simulationbenchmark.h"
 
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/log/core.hpp>
@@ -28,9 +29,51 @@ void terminateHandler()
   if(oldTerminateHandler != nullptr)
     oldTerminateHandler();
 }
+
+std::optional<engine::SimulationBenchmarkOptions> parseBenchmarkOptions(int argc, char** argv)
+{
+  std::optional<engine::SimulationBenchmarkOptions> options;
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg{argv[i]};
+    const auto next = [&i, argc, argv, &arg]() -> std::string
+    {
+      if(i + 1 >= argc)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Missing value for command line option " + arg));
+      return argv[++i];
+    };
+
+    if(arg == "--benchmark")
+    {
+      options = engine::SimulationBenchmarkOptions{};
+      options->level = next();
+    }
+    else if(arg == "--ticks" && options.has_value())
+    {
+      options->ticks = std::stoul(next());
+    }
+    else if(arg == "--input" && options.has_value())
+    {
+      options->inputScript = next();
+    }
+    else if(arg == "--report" && options.has_value())
+    {
+      options->report = next();
+    }
+    else if(arg == "--verify-path-searches" && options.has_value())
+    {
+      options->verifyPathSearches = true;
+    }
+    else
+    {
+      BOOST_THROW_EXCEPTION(std::runtime_error("Unexpected command line option " + arg));
+    }
+  }
+  return options;
+}
 } // namespace
 
-int main()
+int main(int argc, char** argv)
 {
   std::signal(SIGSEGV, &stacktrace_handler);
   std::signal(SIGABRT, &stacktrace_handler);
@@ -39,6 +82,12 @@ int main()
   boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
 #endif
 
+  if(const auto benchmarkOptions = parseBenchmarkOptions(argc, argv))
+  {
+    engine::Engine engine{std::filesystem::current_path(), {1280, 800}, true};
+    return engine::runSimulationBenchmark(engine, *benchmarkOptions);
+  }
+
   engine::Engine engine{std::filesystem::current_path()};
   size_t levelSequenceIndex = 0;
   const size_t levelSequenceLength = pybind11::len(pybind11::globals()["level_sequence"]);
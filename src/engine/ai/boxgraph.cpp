@@ -0,0 +1,46 @@
+#include "boxgraph.h"
+
+namespace engine::ai
+{
+BoxGraph::BoxGraph(const std::vector<world::Box>& boxes,
+                   const world::ZoneId world::Box::*zoneRef,
+                   const core::Length& step,
+                   const core::Length& drop)
+{
+  m_offsets.reserve(boxes.size() + 1);
+  for(const auto& box : boxes)
+  {
+    m_offsets.emplace_back(gsl::narrow<uint32_t>(m_successors.size()));
+    for(const auto& successor : box.overlaps)
+    {
+      if(successor.get() == &box)
+        continue;
+
+      if(box.*zoneRef != successor.get()->*zoneRef)
+        continue; // cannot switch zones
+
+      const auto boxHeightDiff = successor->floor - box.floor;
+      if(boxHeightDiff > step || boxHeightDiff < drop)
+        continue;
+
+      m_successors.emplace_back(gsl::narrow<uint32_t>(successor.get() - boxes.data()));
+    }
+  }
+  m_offsets.emplace_back(gsl::narrow<uint32_t>(m_successors.size()));
+}
+
+std::shared_ptr<const BoxGraph> BoxGraphCache::get(const std::vector<world::Box>& boxes,
+                                                   bool swapped,
+                                                   bool flying,
+                                                   const core::Length& step,
+                                                   const core::Length& drop)
+{
+  const Key key{swapped, flying, step.get(), drop.get()};
+
+  std::unique_lock lock{m_mutex};
+  auto& graph = m_graphs[key];
+  if(graph == nullptr)
+    graph = std::make_shared<BoxGraph>(boxes, world::Box::getZoneRef(swapped, flying, step), step, drop);
+  return graph;
+}
+} // namespace engine::ai
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "engine/world/box.h"
+
+#include <cstdint>
+#include <gsl/gsl-lite.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace engine::ai
+{
+/**
+ * @brief The boxes a creature can move to from each box, as flat arrays indexed by box.
+ *
+ * Derived from world::Box::overlaps, keeping only the boxes within the same zone and within the creature's step and
+ * drop limits. Whether a box is blocked is not part of the graph, as that changes while playing.
+ */
+class BoxGraph final
+{
+public:
+  BoxGraph(const std::vector<world::Box>& boxes,
+           const world::ZoneId world::Box::*zoneRef,
+           const core::Length& step,
+           const core::Length& drop);
+
+  [[nodiscard]] gsl::span<const uint32_t> getSuccessors(uint32_t boxIndex) const
+  {
+    const auto begin = m_offsets.at(boxIndex);
+    return gsl::span<const uint32_t>{m_successors.data() + begin, m_offsets.at(boxIndex + 1) - begin};
+  }
+
+private:
+  //! The successors of box i are stored in the range [m_offsets[i], m_offsets[i+1]) of m_successors.
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint32_t> m_successors;
+};
+
+//! Shares the box graphs of all path finders with the same movement limits; safe to use from multiple threads.
+class BoxGraphCache final
+{
+public:
+  [[nodiscard]] std::shared_ptr<const BoxGraph> get(const std::vector<world::Box>& boxes,
+                                                    bool swapped,
+                                                    bool flying,
+                                                    const core::Length& step,
+                                                    const core::Length& drop);
+
+private:
+  using Key = std::tuple<bool, bool, core::Length::type, core::Length::type>;
+
+  std::mutex m_mutex;
+  std::map<Key, std::shared_ptr<const BoxGraph>> m_graphs;
+};
+} // namespace engine::ai
@@ -11,6 +11,11 @@
 #include "serialization/vector.h"
 #include "serialization/vector_element.h"
 
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace engine::ai
 {
 namespace
@@ -25,12 +30,67 @@ template<typename T>
   else
     return x;
 }
+
+/**
+ * @brief Box pointers, saved as their indices.
+ *
+ * These are saved in the background, so they must not access the world; they are saved exactly like the pointers
+ * would have been, so savegames can be loaded the usual way.
+ * @{
+ */
+struct SavedBox
+{
+  uint32_t index;
+
+  template<typename TContext>
+  void save(const serialization::Serializer<TContext>& ser)
+  {
+    ser.tag("box");
+    ser.node << index;
+  }
+};
+
+struct SavedVectorElement
+{
+  std::optional<std::ptrdiff_t> index;
+
+  template<typename TContext>
+  void save(const serialization::Serializer<TContext>& ser)
+  {
+    if(!index.has_value())
+    {
+      ser.setNull();
+      return;
+    }
+
+    ser.tag("element");
+    ser.node << *index;
+  }
+};
+
+//! A PathFinderNode and its box, saved like an entry of a map from boxes to nodes.
+struct SavedPathFinderNode
+{
+  SavedBox box;
+  SavedVectorElement next;
+  bool reachable;
+
+  template<typename TContext>
+  void save(const serialization::Serializer<TContext>& ser)
+  {
+    ser(S_NV("key", box));
+    ser["value"](S_NV("next", next), S_NV("reachable", reachable));
+  }
+};
+//! @}
 } // namespace
 
 PathFinder::PathFinder(const world::World& world)
+    : m_firstBox{world.getBoxes().data()}
+    , m_nodes(world.getBoxes().size())
+    , m_expanding(world.getBoxes().size(), false)
+    , m_visitedGeneration(world.getBoxes().size(), 0)
 {
-  for(const auto& box : world.getBoxes())
-    m_nodes.emplace(&box, PathFinderNode{});
 }
 
 bool PathFinder::calculateTarget(const world::World& world,
@@ -39,7 +99,11 @@ bool PathFinder::calculateTarget(const world::World& world,
                                  const gsl::not_null<const world::Box*>& startBox)
 {
   Expects(m_targetBox != nullptr);
-  searchPath(world);
+  // objects updated before this one may have opened or closed doors, or flipped the rooms
+  if(m_searchPrepared && isPreparedSearchOutdated(world))
+    discardPreparedSearch();
+  if(!std::exchange(m_searchPrepared, false))
+    searchPath(world);
 
   moveTarget = startPos;
 
@@ -246,9 +310,49 @@ bool PathFinder::calculateTarget(const world::World& world,
   return false;
 }
 
+void PathFinder::prepareSearch(const world::World& world)
+{
+  if(m_searchPrepared || m_targetBox == nullptr)
+    return;
+
+  m_preparedSearch.expansions = m_expansions;
+  m_preparedSearch.changes.clear();
+  m_preparedSearch.checkedBoxes.clear();
+  m_preparedSearch.roomsAreSwapped = world.roomsAreSwapped();
+
+  m_recordingSearch = true;
+  searchPath(world);
+  m_recordingSearch = false;
+  m_searchPrepared = true;
+}
+
+bool PathFinder::isPreparedSearchOutdated(const world::World& world) const
+{
+  if(m_preparedSearch.roomsAreSwapped != world.roomsAreSwapped())
+    return true;
+
+  return std::any_of(m_preparedSearch.checkedBoxes.begin(),
+                     m_preparedSearch.checkedBoxes.end(),
+                     [](const auto& checked) { return checked.first->blocked != checked.second; });
+}
+
+void PathFinder::discardPreparedSearch()
+{
+  if(!std::exchange(m_searchPrepared, false))
+    return;
+
+  for(auto it = m_preparedSearch.changes.rbegin(); it != m_preparedSearch.changes.rend(); ++it)
+  {
+    m_nodes[it->index] = it->node;
+    m_visitedGeneration[it->index] = it->visitedGeneration;
+    m_expanding[it->index] = it->expanding;
+  }
+  m_expansions = m_preparedSearch.expansions;
+}
+
 void PathFinder::searchPath(const world::World& world)
 {
-  const auto zoneRef = world::Box::getZoneRef(world.roomsAreSwapped(), isFlying(), step);
+  const auto graph = world.getBoxGraph(isFlying(), step, drop);
 
   static constexpr uint8_t MaxExpansions = 5;
 
@@ -256,44 +360,46 @@ void PathFinder::searchPath(const world::World& world)
   {
     const auto current = m_expansions.front();
     m_expansions.pop_front();
-    const auto& currentNode = m_nodes[current];
-    const auto searchZone = current->*zoneRef;
+    const auto currentIndex = indexOf(current);
+    recordChange(currentIndex);
+    m_expanding[currentIndex] = false;
+    const auto& currentNode = m_nodes[currentIndex];
 
-    for(const auto& successorBox : current->overlaps)
+    // the graph only contains successors within the same zone and the step/drop limits
+    for(const auto successorIndex : graph->getSuccessors(currentIndex))
     {
-      if(successorBox == current)
-        continue;
-
-      if(searchZone != successorBox.get()->*zoneRef)
-        continue; // cannot switch zones
-
-      const auto boxHeightDiff = successorBox->floor - current->floor;
-      if(boxHeightDiff > step || boxHeightDiff < drop)
-        continue; // can't reach from this box, but still maybe from another one
-
-      auto& successorNode = m_nodes[successorBox];
+      auto& successorNode = m_nodes[successorIndex];
 
       if(!currentNode.reachable)
       {
-        if(m_visited.emplace(successorBox).second)
+        if(!isVisited(successorIndex))
         {
+          recordChange(successorIndex);
           // the successor hasn't been visited, "unreachable" can be propagated/initialized
+          setVisited(successorIndex);
           successorNode.reachable = false;
         }
       }
       else
       {
-        if(successorNode.reachable && m_visited.count(successorBox) != 0)
+        if(successorNode.reachable && isVisited(successorIndex))
           continue; // already visited and marked reachable
 
         // mark as visited and check if reachable (may switch reachable to true)
-        m_visited.emplace(successorBox);
+        recordChange(successorIndex);
+        setVisited(successorIndex);
+        const auto successorBox = m_firstBox + successorIndex;
+        if(m_recordingSearch)
+          m_preparedSearch.checkedBoxes.emplace_back(successorBox, successorBox->blocked);
         successorNode.reachable = canVisit(*successorBox);
         if(successorNode.reachable)
           successorNode.next = current; // success! connect both boxes
 
-        if(std::find(m_expansions.begin(), m_expansions.end(), successorBox) == m_expansions.end())
+        if(!m_expanding[successorIndex])
+        {
+          m_expanding[successorIndex] = true;
           m_expansions.emplace_back(successorBox);
+        }
       }
     }
   }
@@ -301,10 +407,11 @@ void PathFinder::searchPath(const world::World& world)
 
 void PathFinder::serialize(const serialization::Serializer<world::World>& ser)
 {
-  ser(S_NV("nodes", m_nodes),
-      S_NV("boxes", m_boxes),
+  // a savegame must not depend on whether the search for the next update was already prepared
+  discardPreparedSearch();
+
+  ser(S_NV("boxes", m_boxes),
       S_NV("expansions", m_expansions),
-      S_NV("visited", m_visited),
       S_NV("cannotVisitBlockable", cannotVisitBlockable),
       S_NV("cannotVisitBlocked", cannotVisitBlocked),
       S_NV("step", step),
@@ -312,6 +419,50 @@ void PathFinder::serialize(const serialization::Serializer<world::World>& ser)
       S_NV("fly", fly),
       S_NV_VECTOR_ELEMENT("targetBox", ser.context.getBoxes(), m_targetBox),
       S_NV("target", target));
+
+  // the flat arrays are stored as maps and sets of boxes, so savegames stay compatible
+  if(!ser.loading)
+  {
+    // the arrays have an entry for every box of the level, so they are only copied here, and turned into nodes when
+    // the savegame is written; boxes in their initial state are skipped, as that is what they are reset to on load
+    std::vector<SavedPathFinderNode> nodes;
+    std::vector<SavedBox> visited;
+    for(uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+      const auto& node = m_nodes[i];
+      if(node.next != nullptr || !node.reachable)
+      {
+        nodes.emplace_back(SavedPathFinderNode{
+          SavedBox{i},
+          SavedVectorElement{node.next == nullptr ? std::nullopt
+                                                  : std::optional<std::ptrdiff_t>{node.next - m_firstBox}},
+          node.reachable});
+      }
+      if(isVisited(i))
+        visited.emplace_back(SavedBox{i});
+    }
+
+    ser["nodes"].deferSave(std::move(nodes));
+    ser["visited"].deferSave(std::move(visited));
+  }
+  else
+  {
+    std::unordered_map<const world::Box*, PathFinderNode> nodes;
+    std::unordered_set<const world::Box*> visited;
+    ser(S_NV("nodes", nodes), S_NV("visited", visited));
+
+    std::fill(m_nodes.begin(), m_nodes.end(), PathFinderNode{});
+    for(const auto& [box, node] : nodes)
+      m_nodes[indexOf(box)] = node;
+
+    clearVisited();
+    for(const auto& box : visited)
+      setVisited(indexOf(box));
+
+    std::fill(m_expanding.begin(), m_expanding.end(), false);
+    for(const auto& box : m_expansions)
+      m_expanding[indexOf(box)] = true;
+  }
 }
 
 void PathFinder::collectBoxes(const world::World& world, const gsl::not_null<const world::Box*>& box)
@@ -5,9 +5,11 @@
 #include "serialization/serialization_fwd.h"
 #include "util/helpers.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <deque>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace engine::world
 {
@@ -66,6 +68,17 @@ struct PathFinder
     }
   }
 
+  /**
+   * @brief Advances the path search towards the target box ahead of the next call to calculateTarget().
+   *
+   * This only reads the world, so it may run concurrently for different path finders as long as the world is not
+   * modified. The prepared search is reverted if the target box changes before calculateTarget() is called, or if a
+   * box it checked was blocked or unblocked, or the rooms were swapped in the meantime; calculateTarget() then
+   * searches again, exactly like it would have done without a prepared search. Until then, isUnreachable() and
+   * getNextPathBox() answer from the state before the prepared search.
+   */
+  void prepareSearch(const world::World& world);
+
   bool calculateTarget(const world::World& world,
                        core::TRVec& moveTarget,
                        const core::TRVec& startPos,
@@ -76,14 +89,19 @@ struct PathFinder
     if(box == m_targetBox)
       return;
 
+    discardPreparedSearch();
     m_targetBox = box;
 
-    m_nodes[m_targetBox].next = nullptr;
-    m_nodes[m_targetBox].reachable = true;
+    const auto targetIndex = indexOf(m_targetBox);
+    m_nodes[targetIndex].next = nullptr;
+    m_nodes[targetIndex].reachable = true;
+    for(const auto& expansion : m_expansions)
+      m_expanding[indexOf(expansion)] = false;
     m_expansions.clear();
     m_expansions.emplace_back(m_targetBox);
-    m_visited.clear();
-    m_visited.emplace(m_targetBox);
+    m_expanding[targetIndex] = true;
+    clearVisited();
+    setVisited(targetIndex);
   }
 
   void serialize(const serialization::Serializer<world::World>& ser);
@@ -93,7 +111,10 @@ struct PathFinder
   // returns true if and only if the box is visited and marked unreachable
   [[nodiscard]] bool isUnreachable(const gsl::not_null<const world::Box*>& box) const
   {
-    return m_visited.count(box) != 0 && !m_nodes.at(box).reachable;
+    const auto index = indexOf(box);
+    if(const auto* original = findOriginalState(index))
+      return original->visitedGeneration == m_generation && !original->node.reachable;
+    return isVisited(index) && !m_nodes[index].reachable;
   }
 
   [[nodiscard]] const auto& getRandomBox() const
@@ -102,9 +123,12 @@ struct PathFinder
     return m_boxes[util::rand15(m_boxes.size())];
   }
 
-  [[nodiscard]] const auto& getNextPathBox(const gsl::not_null<const world::Box*>& box) const
+  [[nodiscard]] const world::Box* getNextPathBox(const gsl::not_null<const world::Box*>& box) const
   {
-    return m_nodes.at(box).next;
+    const auto index = indexOf(box);
+    if(const auto* original = findOriginalState(index))
+      return original->node.next;
+    return m_nodes[index].next;
   }
 
   [[nodiscard]] const auto& getTargetBox() const
@@ -118,14 +142,91 @@ struct PathFinder
   }
 
 private:
+  //! Everything needed to revert a prepared search, and to tell whether it is outdated.
+  struct PreparedSearch
+  {
+    struct Change
+    {
+      uint32_t index;
+      PathFinderNode node;
+      uint32_t visitedGeneration;
+      bool expanding;
+    };
+
+    std::deque<const world::Box*> expansions;
+    //! The previous state of each box the search modified, in the order of the modifications.
+    std::vector<Change> changes;
+    //! The blocked state of each box the search checked.
+    std::vector<std::pair<const world::Box*, bool>> checkedBoxes;
+    bool roomsAreSwapped = false;
+  };
+
   void searchPath(const world::World& world);
+  [[nodiscard]] bool isPreparedSearchOutdated(const world::World& world) const;
+  void discardPreparedSearch();
+
+  //! Returns the state of a box before the prepared search modified it, or nullptr if it is unmodified.
+  [[nodiscard]] const PreparedSearch::Change* findOriginalState(uint32_t index) const
+  {
+    if(!m_searchPrepared)
+      return nullptr;
+
+    // the first change of a box holds its state before the search
+    const auto it = std::find_if(m_preparedSearch.changes.begin(),
+                                 m_preparedSearch.changes.end(),
+                                 [index](const PreparedSearch::Change& change) { return change.index == index; });
+    return it == m_preparedSearch.changes.end() ? nullptr : &*it;
+  }
+
+  void recordChange(uint32_t index)
+  {
+    if(m_recordingSearch)
+      m_preparedSearch.changes.emplace_back(
+        PreparedSearch::Change{index, m_nodes[index], m_visitedGeneration[index], m_expanding[index]});
+  }
+
+  [[nodiscard]] uint32_t indexOf(const world::Box* box) const
+  {
+    const auto index = box - m_firstBox;
+    Expects(index >= 0 && static_cast<size_t>(index) < m_nodes.size());
+    return static_cast<uint32_t>(index);
+  }
+
+  [[nodiscard]] bool isVisited(uint32_t index) const
+  {
+    return m_visitedGeneration[index] == m_generation;
+  }
+
+  void setVisited(uint32_t index)
+  {
+    m_visitedGeneration[index] = m_generation;
+  }
+
+  void clearVisited()
+  {
+    if(++m_generation == 0)
+    {
+      std::fill(m_visitedGeneration.begin(), m_visitedGeneration.end(), 0);
+      m_generation = 1;
+    }
+  }
 
-  std::unordered_map<const world::Box*, PathFinderNode> m_nodes;
+  //! All arrays indexed by box are relative to this.
+  const world::Box* m_firstBox;
+  std::vector<PathFinderNode> m_nodes;
   std::vector<gsl::not_null<const world::Box*>> m_boxes;
   std::deque<const world::Box*> m_expansions;
-  //! Contains all boxes where the "reachable" state has been determined
-  std::unordered_set<const world::Box*> m_visited;
+  //! Set for all boxes in m_expansions
+  std::vector<bool> m_expanding;
+  //! A box's "reachable" state has been determined if its entry is equal to m_generation
+  std::vector<uint32_t> m_visitedGeneration;
+  uint32_t m_generation = 1;
   //! @brief The target box we need to reach
   const world::Box* m_targetBox = nullptr;
+  //! Set if prepareSearch() already advanced the search for the next call to calculateTarget().
+  bool m_searchPrepared = false;
+  //! Set while prepareSearch() runs, so searchPath() records how to revert its changes.
+  bool m_recordingSearch = false;
+  PreparedSearch m_preparedSearch;
 };
 } // namespace engine::ai
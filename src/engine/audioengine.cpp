@@ -10,6 +10,7 @@
 #include "world/world.h"
 
 #include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
 #include <pybind11/pybind11.h>
 #include <soloud_wavstream.h>
 
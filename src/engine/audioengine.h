@@ -69,6 +69,15 @@ public:
     m_currentLaraTalk.reset();
   }
 
+  //! Stops all streams and all sounds not bound to an emitter; sounds of emitters stop with their emitters.
+  void stopAll()
+  {
+    m_underwaterAmbience.reset();
+    m_ambientStream.reset();
+    m_interceptStream.reset();
+    m_soundEngine->dropEmitter(nullptr);
+  }
+
   std::shared_ptr<audio::Voice> playSoundEffect(const core::SoundEffectId& id, audio::Emitter* emitter);
   std::shared_ptr<audio::Voice> playSoundEffect(core::SoundEffectId id, const glm::vec3& pos);
 
@@ -3,6 +3,7 @@
 #include "engine.h"
 #include "objects/laraobject.h"
 #include "presenter.h"
+#include "profiler.h"
 #include "raycast.h"
 #include "render/portaltracer.h"
 #include "render/scene/camera.h"
@@ -375,16 +376,20 @@ std::unordered_set<const world::Portal*> CameraController::tracePortals()
   for(const auto& room : m_world->getRooms())
     room.node->setVisible(false);
 
-  auto result = render::PortalTracer::trace(*m_position.room, *m_world);
+  auto result = render::PortalTracer::trace(*m_position.room, *m_world, m_roomCullBoxes);
 
   for(const auto& portal : m_position.room->portals)
+  {
     portal.adjoiningRoom->node->setVisible(true);
+    m_roomCullBoxes.insert_or_assign(portal.adjoiningRoom.get(), render::PortalTracer::CullBox{-1, -1, 1, 1});
+  }
 
   return result;
 }
 
 std::unordered_set<const world::Portal*> CameraController::update()
 {
+  ENGINE_PROFILE_ZONE("CameraController::update");
   m_rotationAroundLara.X = std::clamp(m_rotationAroundLara.X, -85_deg, +85_deg);
 
   if(m_mode == CameraMode::Cinematic)
@@ -4,6 +4,7 @@
 #include "core/angle.h"
 #include "core/vec.h"
 #include "floordata/types.h"
+#include "render/portaltracer.h"
 
 namespace render::scene
 {
@@ -14,6 +15,7 @@ namespace engine::world
 {
 class World;
 struct Portal;
+struct Room;
 struct CinematicFrame;
 } // namespace engine::world
 
@@ -88,6 +90,8 @@ private:
   int m_fixedCameraId = -1;
   int m_currentFixedCameraId = -1;
   core::Frame m_camOverrideTimeout{-1_frame};
+  //! @brief The screen areas the visible rooms are seen through, updated when tracing the portals.
+  render::PortalTracer::RoomCullBoxes m_roomCullBoxes;
 
 public:
   explicit CameraController(const gsl::not_null<world::World*>& world,
@@ -196,6 +200,13 @@ public:
     return m_camera;
   }
 
+  [[nodiscard]] std::optional<render::PortalTracer::CullBox> getRoomCullBox(const world::Room& room) const
+  {
+    if(const auto it = m_roomCullBoxes.find(&room); it != m_roomCullBoxes.end())
+      return it->second;
+    return std::nullopt;
+  }
+
   std::unordered_set<const world::Portal*> updateCinematic(const world::CinematicFrame& frame, bool ingame);
 
   void serialize(const serialization::Serializer<world::World>& ser);
@@ -204,9 +215,15 @@ public:
   core::TRVec m_cinematicPos{0_len, 0_len, 0_len};
   core::TRRotation m_cinematicRot{0_deg, 0_deg, 0_deg};
 
-private:
+  /**
+   * @brief Determines the visible rooms and their cull boxes from the camera's current view matrix.
+   *
+   * Called by update(); must be called again whenever the view matrix is changed afterwards, e.g. when presenting an
+   * interpolated frame, so the cull boxes match the frame that is rendered.
+   */
   std::unordered_set<const world::Portal*> tracePortals();
 
+private:
   void handleFixedCamera();
 
   core::Length moveIntoBox(core::RoomBoundPosition& goal, const core::Length& margin) const;
@@ -7,6 +7,8 @@ namespace engine
 {
 void DisplaySettings::serialize(const serialization::Serializer<engine::EngineConfig>& ser)
 {
-  ser(S_NVO("performanceMeter", performanceMeter));
+  ser(S_NVO("performanceMeter", performanceMeter),
+      S_NVO("interpolateFrames", interpolateFrames),
+      S_NVO("profilerTraceOnExit", profilerTraceOnExit));
 }
 } // namespace engine
@@ -9,6 +9,10 @@ struct EngineConfig;
 struct DisplaySettings
 {
   bool performanceMeter = false;
+  //! Render as often as the display allows, blending between simulation ticks.
+  bool interpolateFrames = false;
+  //! Write the profiler's recent frames to the "profiles" directory when the engine shuts down.
+  bool profilerTraceOnExit = false;
 
   void serialize(const serialization::Serializer<engine::EngineConfig>& ser);
 };
@@ -6,6 +6,7 @@
 #include "engine/ai/ai.h"
 #include "engine/audioengine.h"
 #include "floordata/floordata.h"
+#include "frameinterpolator.h"
 #include "hid/inputhandler.h"
 #include "loader/file/level/level.h"
 #include "loader/trx/trx.h"
@@ -19,12 +20,15 @@
 #include "objects/tallblock.h"
 #include "player.h"
 #include "presenter.h"
+#include "profiler.h"
 #include "render/renderpipeline.h"
 #include "render/scene/csm.h"
 #include "render/scene/materialmanager.h"
 #include "render/scene/renderer.h"
 #include "render/scene/screenoverlay.h"
 #include "render/textureanimator.h"
+#include "savegameindex.h"
+#include "savegamewriter.h"
 #include "script/reflection.h"
 #include "serialization/serialization.h"
 #include "serialization/yamldocument.h"
@@ -64,9 +68,11 @@ std::shared_ptr<pybind11::scoped_interpreter> createScriptEngine(const std::file
 }
 } // namespace
 
-Engine::Engine(const std::filesystem::path& rootPath, const glm::ivec2& resolution)
+Engine::Engine(const std::filesystem::path& rootPath, const glm::ivec2& resolution, bool headless)
     : m_rootPath{rootPath}
     , m_scriptEngine{createScriptEngine(rootPath)}
+    , m_savegameWriter{std::make_unique<SavegameWriter>()}
+    , m_savegameIndex{std::make_unique<SavegameIndex>()}
 {
   try
   {
@@ -105,17 +111,21 @@ Engine::Engine(const std::filesystem::path& rootPath, const glm::ivec2& resoluti
     doc.load("config", *m_engineConfig, *m_engineConfig);
   }
 
-  m_presenter = std::make_shared<Presenter>(m_rootPath, resolution);
+  m_presenter = std::make_shared<Presenter>(m_rootPath, resolution, headless);
   if(gl::hasAnisotropicFilteringExtension()
      && m_engineConfig->renderSettings.anisotropyLevel > gl::getMaxAnisotropyLevel())
     m_engineConfig->renderSettings.anisotropyLevel = gsl::narrow<uint32_t>(std::llround(gl::getMaxAnisotropyLevel()));
   m_presenter->apply(m_engineConfig->renderSettings);
   m_presenter->getInputHandler().setMappings(m_engineConfig->inputMappings);
+  m_presenter->getSoundEngine()->setVoiceBudget(m_engineConfig->voiceBudget);
   m_glidos = loadGlidosPack();
 }
 
 Engine::~Engine()
 {
+  if(m_engineConfig->displaySettings.profilerTraceOnExit)
+    saveProfile();
+
   serialization::YAMLDocument<false> doc{m_rootPath / "config.yaml"};
   doc.save("config", *m_engineConfig, *m_engineConfig);
   doc.write();
@@ -157,6 +167,35 @@ std::pair<RunResult, std::optional<size_t>> Engine::run(world::World& world, boo
 
   core::Frame runtime = 0_frame;
   static constexpr core::Frame BlendInDuration = 60_frame;
+
+  // when interpolating, ticks only advance the simulation, and all frames are presented in between the ticks
+  struct TickPresentation
+  {
+    ui::Ui ui;
+    float blackAlpha;
+    bool presented = false;
+  };
+  std::optional<FrameInterpolator> interpolator;
+  if(!isCutscene && m_engineConfig->displaySettings.interpolateFrames)
+    interpolator.emplace(world);
+  std::optional<TickPresentation> tickPresentation;
+
+  // savegames of the running level are applied in place, as loading the level again would only waste time
+  const auto tryReload = [&](const std::optional<size_t>& slot)
+  {
+    if(isCutscene || !allowSave || !world.reload(slot))
+      return false;
+
+    menu.reset();
+    laraDeadTime = 0_frame;
+    runtime = 0_frame;
+    tickPresentation.reset();
+    if(interpolator.has_value())
+      interpolator.emplace(world);
+    throttler.reset();
+    return true;
+  };
+
   while(true)
   {
     if(m_presenter->shouldClose())
@@ -211,6 +250,23 @@ std::pair<RunResult, std::optional<size_t>> Engine::run(world::World& world, boo
       return {RunResult::NextLevel, std::nullopt};
     }
 
+    // present each tick at least once, even if the machine can't keep up
+    if(tickPresentation.has_value() && (!tickPresentation->presented || !throttler.isTickDue())
+       && m_presenter->preFrame(false))
+    {
+      interpolator->apply(throttler.getTickProgress());
+      // the visible rooms and their screen areas must match the interpolated camera, not the one of the tick
+      const auto waterEntryPortals = world.getCameraController().tracePortals();
+      world.presentFrame(tickPresentation->ui,
+                         waterEntryPortals,
+                         throttler.getAverageDelayRatio(),
+                         tickPresentation->blackAlpha);
+      interpolator->restore();
+      tickPresentation->presented = true;
+      continue;
+    }
+    tickPresentation.reset();
+
     throttler.wait();
     if(!m_presenter->preFrame())
     {
@@ -251,6 +307,8 @@ std::pair<RunResult, std::optional<size_t>> Engine::run(world::World& world, boo
         Expects(menu->requestLoad.has_value());
         if(getSavegameMeta(menu->requestLoad).has_value())
         {
+          if(const auto slot = menu->requestLoad; tryReload(slot))
+            continue;
           return {RunResult::RequestLoad, menu->requestLoad};
         }
       }
@@ -292,6 +350,8 @@ std::pair<RunResult, std::optional<size_t>> Engine::run(world::World& world, boo
         if(getSavegameMeta(std::nullopt).has_value())
         {
           updateTimeSpent();
+          if(tryReload(std::nullopt))
+            continue;
           return {RunResult::RequestLoad, std::nullopt};
         }
       }
@@ -308,7 +368,18 @@ std::pair<RunResult, std::optional<size_t>> Engine::run(world::World& world, boo
         runtime += 1_frame;
         blackAlpha = 1 - runtime.cast<float>() / BlendInDuration.cast<float>();
       }
-      world.gameLoop(godMode, throttler.getAverageDelayRatio(), blackAlpha);
+      if(interpolator.has_value())
+      {
+        interpolator->beginTick();
+        ui::Ui ui{m_presenter->getMaterialManager()->getUi(), world.getPalette()};
+        // the portals are traced again for every presented frame
+        world.updateFrame(godMode, ui);
+        tickPresentation.emplace(TickPresentation{std::move(ui), blackAlpha});
+      }
+      else
+      {
+        world.gameLoop(godMode, throttler.getAverageDelayRatio(), blackAlpha);
+      }
     }
     else
     {
@@ -322,6 +393,12 @@ std::pair<RunResult, std::optional<size_t>> Engine::run(world::World& world, boo
       makeScreenshot();
       throttler.reset();
     }
+    else if(m_presenter->getInputHandler().hasDebouncedAction(hid::Action::Profile))
+    {
+      updateTimeSpent();
+      saveProfile();
+      throttler.reset();
+    }
   }
 }
 
@@ -339,6 +416,19 @@ void Engine::makeScreenshot()
   img.savePng(m_rootPath / "screenshots" / filename.str());
 }
 
+void Engine::saveProfile()
+{
+  if(!std::filesystem::is_directory(m_rootPath / "profiles"))
+    std::filesystem::create_directories(m_rootPath / "profiles");
+
+  auto time = std::time(nullptr);
+  auto localTime = std::localtime(&time);
+  auto filename = boost::format("%04d-%02d-%02d %02d-%02d-%02d.json") % (localTime->tm_year + 1900)
+                  % (localTime->tm_mon + 1) % localTime->tm_mday % localTime->tm_hour % localTime->tm_min
+                  % localTime->tm_sec;
+  m_presenter->getProfiler().writeChromeTrace(m_rootPath / "profiles" / filename.str());
+}
+
 std::pair<RunResult, std::optional<size_t>> Engine::runTitleMenu(world::World& world)
 {
   gl::Framebuffer::unbindAll();
@@ -463,14 +553,10 @@ std::unique_ptr<loader::trx::Glidos> Engine::loadGlidosPack() const
 
 std::optional<SavegameMeta> Engine::getSavegameMeta(const std::filesystem::path& filename) const
 {
-  std::filesystem::path filepath{getSavegameRootPath() / filename};
-  if(!std::filesystem::is_regular_file(filepath))
-    return std::nullopt;
-
-  serialization::YAMLDocument<true> doc{filepath};
-  SavegameMeta meta{};
-  doc.load("meta", meta, meta);
-  return meta;
+  m_savegameWriter->wait();
+  if(auto info = m_savegameIndex->get(getSavegameRootPath() / filename); info.has_value())
+    return std::move(info->meta);
+  return std::nullopt;
 }
 
 std::optional<SavegameMeta> Engine::getSavegameMeta(const std::optional<size_t>& slot) const
@@ -486,6 +572,14 @@ void Engine::applyRenderSettings()
       room.collectShaderLights(m_engineConfig->renderSettings.getLightCollectionDepth());
 }
 
+std::filesystem::path Engine::getCacheRootPath() const
+{
+  auto p = m_rootPath / "cache";
+  if(!std::filesystem::is_directory(p))
+    std::filesystem::create_directory(p);
+  return p;
+}
+
 std::filesystem::path Engine::getSavegameRootPath() const
 {
   auto p = m_rootPath / "saves";
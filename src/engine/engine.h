@@ -43,6 +43,8 @@ class LevelSequenceItem;
 class Particle;
 class Player;
 class Presenter;
+class SavegameIndex;
+class SavegameWriter;
 class Throttler;
 
 enum class RunResult
@@ -86,12 +88,17 @@ private:
   std::string m_language;
 
   std::unique_ptr<loader::trx::Glidos> m_glidos;
+  std::unique_ptr<SavegameWriter> m_savegameWriter;
+  std::unique_ptr<SavegameIndex> m_savegameIndex;
   [[nodiscard]] std::unique_ptr<loader::trx::Glidos> loadGlidosPack() const;
 
   void makeScreenshot();
+  void saveProfile();
 
 public:
-  explicit Engine(const std::filesystem::path& rootPath, const glm::ivec2& resolution = {1280, 800});
+  explicit Engine(const std::filesystem::path& rootPath,
+                  const glm::ivec2& resolution = {1280, 800},
+                  bool headless = false);
 
   ~Engine();
 
@@ -122,6 +129,7 @@ public:
     return m_language;
   }
 
+  [[nodiscard]] std::filesystem::path getCacheRootPath() const;
   [[nodiscard]] std::filesystem::path getSavegameRootPath() const;
   [[nodiscard]] std::filesystem::path getSavegamePath(const std::optional<size_t>& slot) const;
 
@@ -141,6 +149,18 @@ public:
     return m_glidos;
   }
 
+  [[nodiscard]] auto& getSavegameWriter()
+  {
+    BOOST_ASSERT(m_savegameWriter != nullptr);
+    return *m_savegameWriter;
+  }
+
+  [[nodiscard]] auto& getSavegameIndex() const
+  {
+    BOOST_ASSERT(m_savegameIndex != nullptr);
+    return *m_savegameIndex;
+  }
+
   [[nodiscard]] std::optional<SavegameMeta> getSavegameMeta(const std::filesystem::path& filename) const;
   [[nodiscard]] std::optional<SavegameMeta> getSavegameMeta(const std::optional<size_t>& slot) const;
 
@@ -49,6 +49,7 @@ std::vector<NamedInputMappingConfig> getDefaultMappings()
         {GlfwKey::Q, Action::StepLeft},
         {GlfwKey::E, Action::StepRight},
         {GlfwKey::F12, Action::Screenshot},
+        {GlfwKey::F9, Action::Profile},
         {GlfwKey::F10, Action::CheatDive} // only available in debug builds
       },
     },
@@ -91,7 +92,9 @@ void EngineConfig::serialize(const serialization::Serializer<EngineConfig>& ser)
 {
   ser(S_NVD("renderSettings", renderSettings, render::RenderSettings{}),
       S_NVD("displaySettings", displaySettings, DisplaySettings{}),
-      S_NVD("inputMappings", inputMappings, getDefaultMappings()));
+      S_NVD("inputMappings", inputMappings, getDefaultMappings()),
+      S_NVD("yamlSavegames", yamlSavegames, false),
+      S_NVD("voiceBudget", voiceBudget, audio::SoundEngine::DefaultVoiceBudget));
 }
 
 EngineConfig::EngineConfig()
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "audio/soundengine.h"
 #include "displaysettings.h"
 #include "hid/actions.h"
 #include "hid/glfw_axes.h"
@@ -43,6 +44,10 @@ struct EngineConfig
   render::RenderSettings renderSettings{};
   DisplaySettings displaySettings{};
   std::vector<NamedInputMappingConfig> inputMappings{};
+  //! Writes savegames as human-readable YAML instead of the compact binary format, e.g. for debugging.
+  bool yamlSavegames = false;
+  //! The number of sounds mixed at the same time; the least audible ones are silenced.
+  size_t voiceBudget = audio::SoundEngine::DefaultVoiceBudget;
 
   explicit EngineConfig();
 
@@ -0,0 +1,164 @@
+#include "frameinterpolator.h"
+
+#include "cameracontroller.h"
+#include "core/magic.h"
+#include "objectmanager.h"
+#include "presenter.h"
+#include "render/scene/camera.h"
+#include "render/scene/node.h"
+#include "render/scene/renderer.h"
+#include "skeletalmodelnode.h"
+#include "util/helpers.h"
+#include "world/world.h"
+
+#include <unordered_set>
+
+namespace engine
+{
+namespace
+{
+// anything moving farther than this within a single tick is considered a teleport, which is not blended
+constexpr float MaxInterpolationDistance = 2 * core::SectorSize.get<float>();
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void collectNodes(const std::shared_ptr<render::scene::Node>& node,
+                  std::vector<std::shared_ptr<render::scene::Node>>& nodes)
+{
+  nodes.emplace_back(node);
+  for(const auto& child : node->getChildren())
+    collectNodes(child, nodes);
+}
+
+std::vector<std::shared_ptr<render::scene::Node>> collectNodes(const world::World& world)
+{
+  std::vector<std::shared_ptr<render::scene::Node>> nodes;
+  if(const auto& root = world.getPresenter().getRenderer().getRootNode(); root != nullptr)
+    collectNodes(root, nodes);
+  return nodes;
+}
+
+std::vector<glm::mat4> getBoneMatrices(const render::scene::Node& node)
+{
+  std::vector<glm::mat4> matrices;
+  if(const auto skeleton = dynamic_cast<const SkeletalModelNode*>(&node))
+  {
+    matrices.reserve(skeleton->getBoneCount());
+    for(size_t i = 0; i < skeleton->getBoneCount(); ++i)
+      matrices.emplace_back(skeleton->getMeshMatrix(i));
+  }
+  return matrices;
+}
+
+bool canBlend(const glm::mat4& a, const glm::mat4& b)
+{
+  return a != b && glm::distance(glm::vec3{a[3]}, glm::vec3{b[3]}) < MaxInterpolationDistance;
+}
+} // namespace
+
+FrameInterpolator::FrameInterpolator(world::World& world)
+    : m_world{world}
+{
+}
+
+void FrameInterpolator::beginTick()
+{
+  Expects(!m_applied);
+
+  m_tickStates.clear();
+  for(const auto& node : collectNodes(m_world))
+    m_tickStates.emplace(node.get(), TickState{node, node->getModelMatrix(), getBoneMatrices(*node)});
+
+  m_tickViewMatrix = m_world.getCameraController().getCamera()->getViewMatrix();
+  m_hasTickState = true;
+}
+
+void FrameInterpolator::apply(float bias)
+{
+  Expects(!m_applied);
+  m_applied = true;
+  if(!m_hasTickState)
+    return;
+
+  const auto nodes = collectNodes(m_world);
+  // the current world transforms must be known before any parent is modified
+  std::vector<glm::mat4> modelMatrices;
+  modelMatrices.reserve(nodes.size());
+  for(const auto& node : nodes)
+    modelMatrices.emplace_back(node->getModelMatrix());
+
+  std::unordered_set<const render::scene::Node*> blendedNodes;
+  for(size_t i = 0; i < nodes.size(); ++i)
+  {
+    const auto& node = nodes[i];
+    const auto it = m_tickStates.find(node.get());
+    // an expired reference means that the node was destroyed and a new one happens to have the same address
+    if(it == m_tickStates.end() || it->second.node.lock() != node)
+      continue;
+
+    const auto& tickState = it->second;
+    const auto parent = node->getParent().lock();
+    const bool parentBlended = parent != nullptr && blendedNodes.count(parent.get()) != 0;
+
+    AppliedState applied{node, node->getLocalMatrix(), {}};
+    bool modified = false;
+    if(canBlend(tickState.modelMatrix, modelMatrices[i]) || parentBlended)
+    {
+      const auto blended = canBlend(tickState.modelMatrix, modelMatrices[i])
+                             ? util::mix(tickState.modelMatrix, modelMatrices[i], bias)
+                             : modelMatrices[i];
+      node->setLocalMatrix(parent != nullptr ? glm::inverse(parent->getModelMatrix()) * blended : blended);
+      blendedNodes.emplace(node.get());
+      modified = true;
+    }
+
+    if(!tickState.boneMatrices.empty())
+    {
+      auto boneMatrices = getBoneMatrices(*node);
+      if(boneMatrices.size() == tickState.boneMatrices.size() && boneMatrices != tickState.boneMatrices)
+      {
+        auto& skeleton = dynamic_cast<SkeletalModelNode&>(*node);
+        for(size_t bone = 0; bone < boneMatrices.size(); ++bone)
+          skeleton.setMeshMatrix(bone, util::mix(tickState.boneMatrices[bone], boneMatrices[bone], bias));
+        applied.boneMatrices = std::move(boneMatrices);
+        modified = true;
+      }
+    }
+
+    if(modified)
+      m_appliedStates.emplace_back(std::move(applied));
+  }
+
+  m_world.getObjectManager().getBloodSplatters().setInterpolationBias(bias);
+  m_world.getObjectManager().getSplashes().setInterpolationBias(bias);
+
+  const auto& camera = m_world.getCameraController().getCamera();
+  m_appliedViewMatrix = camera->getViewMatrix();
+  if(canBlend(glm::inverse(m_tickViewMatrix), camera->getInverseViewMatrix()))
+    camera->setViewMatrix(util::mix(m_tickViewMatrix, m_appliedViewMatrix, bias));
+}
+
+void FrameInterpolator::restore()
+{
+  Expects(m_applied);
+  m_applied = false;
+  if(!m_hasTickState)
+    return;
+
+  for(const auto& applied : m_appliedStates)
+  {
+    applied.node->setLocalMatrix(applied.localMatrix);
+    if(applied.boneMatrices.empty())
+      continue;
+
+    auto& skeleton = dynamic_cast<SkeletalModelNode&>(*applied.node);
+    for(size_t bone = 0; bone < applied.boneMatrices.size(); ++bone)
+      skeleton.setMeshMatrix(bone, applied.boneMatrices[bone]);
+  }
+  m_appliedStates.clear();
+
+  m_world.getObjectManager().getBloodSplatters().setInterpolationBias(1);
+  m_world.getObjectManager().getSplashes().setInterpolationBias(1);
+
+  m_world.getCameraController().getCamera()->setViewMatrix(m_appliedViewMatrix);
+}
+} // namespace engine
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace render::scene
+{
+class Node;
+}
+
+namespace engine::world
+{
+class World;
+}
+
+namespace engine
+{
+/**
+ * @brief Presents the scene in between two simulation ticks.
+ *
+ * Before each tick, the world transforms of all scene nodes, the bone matrices of skeletal models and the camera
+ * are recorded. When presenting, these are temporarily blended between the recorded and the current state, and
+ * restored right after rendering, so the fixed-tick game logic never observes the blended state. Pooled particles
+ * aren't scene nodes, and blend their positions themselves.
+ */
+class FrameInterpolator final
+{
+public:
+  explicit FrameInterpolator(world::World& world);
+
+  //! Records the current state as the start of the interpolation; must be called before advancing the simulation.
+  void beginTick();
+
+  //! Blends all transforms between the last recorded and the current state; must be followed by restore().
+  void apply(float bias);
+  void restore();
+
+private:
+  struct TickState
+  {
+    std::weak_ptr<render::scene::Node> node;
+    glm::mat4 modelMatrix;
+    std::vector<glm::mat4> boneMatrices;
+  };
+
+  struct AppliedState
+  {
+    std::shared_ptr<render::scene::Node> node;
+    glm::mat4 localMatrix;
+    std::vector<glm::mat4> boneMatrices;
+  };
+
+  world::World& m_world;
+  std::unordered_map<const render::scene::Node*, TickState> m_tickStates;
+  glm::mat4 m_tickViewMatrix{1.0f};
+  std::vector<AppliedState> m_appliedStates;
+  glm::mat4 m_appliedViewMatrix{1.0f};
+  bool m_hasTickState = false;
+  bool m_applied = false;
+};
+} // namespace engine
@@ -3,6 +3,7 @@
 #include "cameracontroller.h"
 #include "engine/objects/object.h"
 #include "engine/world/room.h"
+#include "objectmanager.h"
 
 namespace engine
 {
@@ -10,7 +11,7 @@ bool HeightInfo::skipSteepSlants = false;
 
 HeightInfo HeightInfo::fromFloor(gsl::not_null<const world::Sector*> roomSector,
                                  const core::TRVec& pos,
-                                 const std::map<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& objects)
+                                 const ObjectMap& objects)
 {
   HeightInfo hi;
 
@@ -110,7 +111,7 @@ HeightInfo HeightInfo::fromFloor(gsl::not_null<const world::Sector*> roomSector,
 
 HeightInfo HeightInfo::fromCeiling(gsl::not_null<const world::Sector*> roomSector,
                                    const core::TRVec& pos,
-                                   const std::map<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& objects)
+                                   const ObjectMap& objects)
 {
   HeightInfo hi;
 
@@ -15,6 +15,7 @@ class Object;
 namespace engine
 {
 class CameraController;
+class ObjectMap;
 
 enum class SlantClass
 {
@@ -33,11 +34,11 @@ struct HeightInfo
 
   static HeightInfo fromFloor(gsl::not_null<const world::Sector*> roomSector,
                               const core::TRVec& pos,
-                              const std::map<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& objects);
+                              const ObjectMap& objects);
 
   static HeightInfo fromCeiling(gsl::not_null<const world::Sector*> roomSector,
                                 const core::TRVec& pos,
-                                const std::map<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& objects);
+                                const ObjectMap& objects);
 
   HeightInfo() = default;
 };
@@ -49,7 +50,7 @@ struct VerticalSpaceInfo
 
   void init(const gsl::not_null<const world::Sector*>& roomSector,
             const core::TRVec& position,
-            const std::map<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& objects,
+            const ObjectMap& objects,
             const core::Length& itemY,
             const core::Length& itemHeight)
   {
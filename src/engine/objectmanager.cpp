@@ -1,14 +1,17 @@
 #include "objectmanager.h"
 
+#include "ai/ai.h"
 #include "loader/file/item.h"
 #include "objects/laraobject.h"
 #include "objects/objectfactory.h"
 #include "particle.h"
+#include "profiler.h"
 #include "serialization/map.h"
 #include "serialization/not_null.h"
 #include "serialization/objectreference.h"
 #include "serialization/serialization.h"
 
+#include <algorithm>
 #include <boost/range/adaptor/indexed.hpp>
 
 namespace engine
@@ -18,6 +21,9 @@ void ObjectManager::createObjects(world::World& world, std::vector<loader::file:
   Expects(m_objectCounter == 0);
   m_objectCounter = gsl::narrow<ObjectId>(items.size());
 
+  m_bloodSplatters = std::make_unique<SpriteParticlePool>(world, TR1ItemId::Blood, 4_frame);
+  m_splashes = std::make_unique<SpriteParticlePool>(world, TR1ItemId::Splash, 1_frame);
+
   m_lara = nullptr;
   for(const auto& idItem : items | boost::adaptors::indexed())
   {
@@ -31,39 +37,38 @@ void ObjectManager::createObjects(world::World& world, std::vector<loader::file:
     if(object != nullptr)
     {
       m_objects.emplace(gsl::narrow<ObjectId>(idItem.index()), object);
+      m_objectsByRoom.insert(object.get(), idItem.index());
     }
   }
 }
 
 void ObjectManager::applyScheduledDeletions()
 {
-  if(m_scheduledDeletions.empty())
-    return;
-
   for(const auto& del : m_scheduledDeletions)
   {
-    auto it = std::find_if(m_dynamicObjects.begin(),
-                           m_dynamicObjects.end(),
-                           [del](const std::shared_ptr<objects::Object>& i) { return i.get() == del; });
-    if(it != m_dynamicObjects.end())
+    if(const auto it = m_dynamicObjectHandles.find(del); it != m_dynamicObjectHandles.end())
     {
-      m_dynamicObjects.erase(it);
+      m_dynamicObjects.scheduleErase(it->second);
+      m_dynamicObjectsByRoom.erase(del);
       continue;
     }
 
-    auto it2 = std::find_if(m_objects.begin(),
-                            m_objects.end(),
-                            [del](const std::pair<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& i) {
-                              return i.second.get().get() == del;
-                            });
-    if(it2 != m_objects.end())
-    {
-      m_objects.erase(it2);
-      continue;
-    }
+    m_objects.scheduleErase(del);
+    m_objectsByRoom.erase(del);
   }
-
   m_scheduledDeletions.clear();
+
+  m_dynamicObjects.applyErasures([this](const gsl::not_null<std::shared_ptr<objects::Object>>& object)
+                                 { m_dynamicObjectHandles.erase(object.get().get()); });
+  m_objects.applyErasures();
+  m_particles.applyErasures(
+    [this](const gsl::not_null<std::shared_ptr<Particle>>& particle)
+    {
+      // the particle may have been registered again in the meantime
+      if(const auto it = m_particleHandles.find(particle.get().get());
+         it != m_particleHandles.end() && m_particles.isScheduledForErase(it->second))
+        m_particleHandles.erase(it);
+    });
 }
 
 void ObjectManager::registerObject(const gsl::not_null<std::shared_ptr<objects::Object>>& object)
@@ -71,20 +76,34 @@ void ObjectManager::registerObject(const gsl::not_null<std::shared_ptr<objects::
   if(m_objectCounter == std::numeric_limits<ObjectId>::max())
     BOOST_THROW_EXCEPTION(std::runtime_error("Artificial object counter exceeded"));
 
+  m_objectsByRoom.insert(object.get().get(), m_objectCounter);
   m_objects.emplace(m_objectCounter++, object);
 }
 
+void ObjectManager::registerDynamicObject(const gsl::not_null<std::shared_ptr<objects::Object>>& object)
+{
+  if(m_dynamicObjectHandles.count(object.get().get()) != 0)
+    return;
+
+  m_dynamicObjectHandles.emplace(object.get().get(), m_dynamicObjects.insert(object));
+  m_dynamicObjectsByRoom.insert(object.get().get(), m_dynamicObjectCounter++);
+}
+
+void ObjectManager::registerParticle(const gsl::not_null<std::shared_ptr<Particle>>& particle)
+{
+  if(const auto it = m_particleHandles.find(particle.get().get());
+     it != m_particleHandles.end() && !m_particles.isScheduledForErase(it->second))
+    return;
+
+  m_particleHandles[particle.get().get()] = m_particles.insert(particle);
+}
+
 std::shared_ptr<objects::Object> ObjectManager::find(const objects::Object* object) const
 {
   if(object == nullptr)
     return nullptr;
 
-  auto it = std::find_if(m_objects.begin(),
-                         m_objects.end(),
-                         [object](const std::pair<uint16_t, gsl::not_null<std::shared_ptr<objects::Object>>>& x) {
-                           return x.second.get().get() == object;
-                         });
-
+  const auto it = m_objects.find(object);
   if(it == m_objects.end())
     return nullptr;
 
@@ -102,57 +121,151 @@ std::shared_ptr<objects::Object> ObjectManager::getObject(ObjectId id) const
 
 void ObjectManager::update(world::World& world, bool godMode)
 {
-  for(const auto& object : m_objects | boost::adaptors::map_values)
+  ENGINE_PROFILE_ZONE("ObjectManager::update");
+  const auto probed = [this](core::TypeId type, const auto& fn)
   {
-    if(object.get() == m_lara) // Lara is special and needs to be updated last
-      continue;
+    if(!m_updateProbe)
+    {
+      fn();
+      return;
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    m_updateProbe(type, std::chrono::high_resolution_clock::now() - start);
+  };
 
+  const auto updateObject = [](const std::shared_ptr<objects::Object>& object)
+  {
     object->updateLighting();
     if(object->m_isActive)
       object->update();
 
     object->getNode()->setVisible(object->m_state.triggerState != objects::TriggerState::Invisible);
+  };
+
+  if(m_preparePathSearches)
+    prepareCreaturePathSearches(world);
+
+  for(const auto& object : m_objects | boost::adaptors::map_values)
+  {
+    if(object.get() == m_lara) // Lara is special and needs to be updated last
+      continue;
+
+    probed(object->m_state.type, [&object, &updateObject]() { updateObject(object); });
   }
 
   for(const auto& object : m_dynamicObjects)
   {
-    object->updateLighting();
-    if(object->m_isActive)
-      object->update();
-
-    object->getNode()->setVisible(object->m_state.triggerState != objects::TriggerState::Invisible);
+    probed(object->m_state.type, [&object, &updateObject]() { updateObject(object); });
   }
 
-  auto currentParticles = std::move(m_particles);
-  for(const auto& particle : currentParticles)
+  probed(TR1ItemId::Blood, [this]() { m_bloodSplatters->update(); });
+  probed(TR1ItemId::Splash, [this]() { m_splashes->update(); });
+
+  // particles spawned during this loop are appended, and will be updated in the next frame
+  const auto particleCount = m_particles.size();
+  for(size_t i = 0; i < particleCount; ++i)
   {
-    if(particle->update(world))
-    {
-      setParent(particle, particle->pos.room->node);
-      m_particles.emplace_back(particle);
-    }
-    else
-    {
-      setParent(particle, nullptr);
-    }
+    const auto handle = m_particles.getHandle(i);
+    if(m_particles.isScheduledForErase(handle))
+      continue;
+
+    // copy, as the storage may grow while updating
+    const gsl::not_null<std::shared_ptr<Particle>> particle = m_particles[i];
+    probed(particle->object_number,
+           [this, &world, &particle, &handle]()
+           {
+             if(particle->update(world))
+             {
+               setParent(particle, particle->pos.room->node);
+             }
+             else
+             {
+               setParent(particle, nullptr);
+               m_particles.scheduleErase(handle);
+             }
+           });
   }
 
   if(m_lara != nullptr)
   {
     if(godMode)
       m_lara->m_state.health = core::LaraHealth;
-    m_lara->update();
-    m_lara->updateLighting();
+    probed(m_lara->m_state.type,
+           [this]()
+           {
+             m_lara->update();
+             m_lara->updateLighting();
+           });
   }
 
   applyScheduledDeletions();
 }
 
+void ObjectManager::prepareCreaturePathSearches(const world::World& world)
+{
+  ENGINE_PROFILE_ZONE("ObjectManager::prepareCreaturePathSearches");
+  // the path search only reads the box graph, so the searches can run in parallel before the objects are updated;
+  // a search that is outdated by a door or a flip map changed during the update is reverted and done again serially;
+  // everything else the creatures do depends on the update order or on scripts, and stays serial
+  std::vector<ai::PathFinder*> pathFinders;
+  for(const auto& object : m_objects | boost::adaptors::map_values)
+  {
+    if(!object->m_isActive || object->m_state.creatureInfo == nullptr || object->m_state.isDead())
+      continue;
+
+    pathFinders.emplace_back(&object->m_state.creatureInfo->pathFinder);
+  }
+
+  m_workerPool.parallelFor(pathFinders.size(),
+                           [&world, &pathFinders](size_t i) { pathFinders[i]->prepareSearch(world); });
+}
+
 void ObjectManager::serialize(const serialization::Serializer<world::World>& ser)
 {
+  // objects are stored as a map from their ids, independent of their in-memory layout
+  std::map<ObjectId, gsl::not_null<std::shared_ptr<objects::Object>>> objects;
+  if(!ser.loading)
+  {
+    for(const auto& [id, object] : m_objects)
+      objects.emplace(id, object);
+  }
+  else
+  {
+    // transient objects aren't saved, so none of them must survive when loading into a running level
+    m_scheduledDeletions.clear();
+    m_dynamicObjects.clear();
+    m_dynamicObjectHandles.clear();
+    m_particles.clear();
+    m_particleHandles.clear();
+    m_bloodSplatters->clear();
+    m_splashes->clear();
+  }
+
   ser(S_NV("objectCounter", m_objectCounter),
-      S_NV("objects", m_objects),
+      S_NV("objects", objects),
       S_NV("lara", serialization::ObjectReference{m_lara}));
+
+  if(ser.loading)
+  {
+    m_objects.clear();
+    for(const auto& [id, object] : objects)
+      m_objects.emplace(id, object);
+    rebuildRoomIndices();
+  }
+}
+
+void ObjectManager::rebuildRoomIndices()
+{
+  m_objectsByRoom.clear();
+  for(const auto& [id, object] : m_objects)
+    m_objectsByRoom.insert(object.get().get(), id);
+
+  m_dynamicObjectsByRoom.clear();
+  m_dynamicObjectCounter = 0;
+  for(const auto& object : m_dynamicObjects)
+    m_dynamicObjectsByRoom.insert(object.get().get(), m_dynamicObjectCounter++);
 }
 
 void ObjectManager::eraseParticle(const std::shared_ptr<Particle>& particle)
@@ -160,11 +273,86 @@ void ObjectManager::eraseParticle(const std::shared_ptr<Particle>& particle)
   if(particle == nullptr)
     return;
 
-  const auto it
-    = std::find_if(m_particles.begin(), m_particles.end(), [particle](const auto& p) { return particle == p.get(); });
-  if(it != m_particles.end())
-    m_particles.erase(it);
+  if(const auto it = m_particleHandles.find(particle.get()); it != m_particleHandles.end())
+    m_particles.scheduleErase(it->second);
 
   setParent(particle, nullptr);
 }
+
+void ObjectMap::emplace(ObjectId id, const gsl::not_null<std::shared_ptr<objects::Object>>& object)
+{
+  Expects(find(id) == end());
+
+  // objects spawning other objects while the level is loading register them before the remaining level objects,
+  // so insert at the sorted position to keep the id order
+  const auto it
+    = std::upper_bound(begin(), end(), id, [](ObjectId lhs, const Entry& rhs) { return lhs < rhs.first; });
+  const auto handle = m_entries.insertAt(gsl::narrow<size_t>(std::distance(begin(), it)), Entry{id, object});
+  if(id >= m_handlesById.size())
+    m_handlesById.resize(id + 1);
+  m_handlesById[id] = handle;
+  m_handlesByPointer.emplace(object.get().get(), handle);
+}
+
+ObjectMap::const_iterator ObjectMap::toIterator(const Handle& handle) const
+{
+  const auto entry = m_entries.get(handle);
+  if(entry == nullptr)
+    return end();
+
+  return begin() + std::distance(&*begin(), entry);
+}
+
+ObjectMap::const_iterator ObjectMap::find(ObjectId id) const
+{
+  if(id >= m_handlesById.size())
+    return end();
+
+  return toIterator(m_handlesById[id]);
+}
+
+ObjectMap::const_iterator ObjectMap::find(const objects::Object* object) const
+{
+  const auto it = m_handlesByPointer.find(object);
+  if(it == m_handlesByPointer.end())
+    return end();
+
+  return toIterator(it->second);
+}
+
+const gsl::not_null<std::shared_ptr<objects::Object>>& ObjectMap::at(ObjectId id) const
+{
+  const auto it = find(id);
+  if(it == end())
+    BOOST_THROW_EXCEPTION(std::out_of_range("Object ID not found"));
+
+  return it->second;
+}
+
+bool ObjectMap::scheduleErase(const objects::Object* object)
+{
+  const auto it = m_handlesByPointer.find(object);
+  if(it == m_handlesByPointer.end())
+    return false;
+
+  m_entries.scheduleErase(it->second);
+  return true;
+}
+
+void ObjectMap::applyErasures()
+{
+  m_entries.applyErasures(
+    [this](const Entry& entry)
+    {
+      m_handlesById[entry.first] = Handle{};
+      m_handlesByPointer.erase(entry.second.get().get());
+    });
+}
+
+void ObjectMap::clear()
+{
+  m_entries.clear();
+  m_handlesById.clear();
+  m_handlesByPointer.clear();
+}
 } // namespace engine
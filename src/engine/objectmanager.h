@@ -1,10 +1,17 @@
 #pragma once
+#include "core/id.h"
+#include "core/slotmap.h"
 #include "items_tr1.h"
+#include "roomobjectindex.h"
+#include "spriteparticlepool.h"
+#include "workerpool.h"
 
 #include <boost/throw_exception.hpp>
+#include <chrono>
+#include <functional>
 #include <gsl/gsl-lite.hpp>
-#include <map>
-#include <set>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace serialization
@@ -35,14 +42,80 @@ class Particle;
 
 using ObjectId = uint16_t;
 
+//! Receives the time spent in a single object or particle update; used for profiling the simulation.
+using ObjectUpdateProbe = std::function<void(core::TypeId, std::chrono::high_resolution_clock::duration)>;
+
+/**
+ * @brief Objects by their level-wide id, with O(1) lookups by id and by pointer.
+ *
+ * Provides the subset of the std::map interface the engine relies on. Iteration order matches the id order; objects
+ * added with a lower id than existing ones are inserted in place, only renumbering the entries after them.
+ */
+class ObjectMap final
+{
+public:
+  using Entry = std::pair<ObjectId, gsl::not_null<std::shared_ptr<objects::Object>>>;
+  using const_iterator = core::SlotMap<Entry>::const_iterator;
+
+  void emplace(ObjectId id, const gsl::not_null<std::shared_ptr<objects::Object>>& object);
+
+  [[nodiscard]] const_iterator find(ObjectId id) const;
+  [[nodiscard]] const_iterator find(const objects::Object* object) const;
+  [[nodiscard]] const gsl::not_null<std::shared_ptr<objects::Object>>& at(ObjectId id) const;
+
+  //! Returns false if the object is not part of this map.
+  bool scheduleErase(const objects::Object* object);
+  void applyErasures();
+  void clear();
+
+  [[nodiscard]] const_iterator begin() const noexcept
+  {
+    return m_entries.begin();
+  }
+
+  [[nodiscard]] const_iterator end() const noexcept
+  {
+    return m_entries.end();
+  }
+
+  [[nodiscard]] size_t size() const noexcept
+  {
+    return m_entries.size();
+  }
+
+private:
+  using Handle = core::SlotMap<Entry>::Handle;
+
+  core::SlotMap<Entry> m_entries;
+  std::vector<Handle> m_handlesById;
+  std::unordered_map<const objects::Object*, Handle> m_handlesByPointer;
+
+  [[nodiscard]] const_iterator toIterator(const Handle& handle) const;
+};
+
 class ObjectManager
 {
-  std::set<objects::Object*> m_scheduledDeletions;
+  std::vector<objects::Object*> m_scheduledDeletions;
   ObjectId m_objectCounter = 0;
-  std::map<ObjectId, gsl::not_null<std::shared_ptr<objects::Object>>> m_objects;
-  std::set<gsl::not_null<std::shared_ptr<objects::Object>>> m_dynamicObjects;
-  std::vector<gsl::not_null<std::shared_ptr<Particle>>> m_particles;
+  ObjectMap m_objects;
+  core::SlotMap<gsl::not_null<std::shared_ptr<objects::Object>>> m_dynamicObjects;
+  std::unordered_map<const objects::Object*, core::SlotMap<gsl::not_null<std::shared_ptr<objects::Object>>>::Handle>
+    m_dynamicObjectHandles;
+  core::SlotMap<gsl::not_null<std::shared_ptr<Particle>>> m_particles;
+  std::unordered_map<const Particle*, core::SlotMap<gsl::not_null<std::shared_ptr<Particle>>>::Handle>
+    m_particleHandles;
+  std::unique_ptr<SpriteParticlePool> m_bloodSplatters;
+  std::unique_ptr<SpriteParticlePool> m_splashes;
+  uint64_t m_dynamicObjectCounter = 0;
+  RoomObjectIndex m_objectsByRoom;
+  RoomObjectIndex m_dynamicObjectsByRoom;
   std::shared_ptr<objects::LaraObject> m_lara = nullptr;
+  ObjectUpdateProbe m_updateProbe{};
+  WorkerPool m_workerPool;
+  bool m_preparePathSearches = true;
+
+  void rebuildRoomIndices();
+  void prepareCreaturePathSearches(const world::World& world);
 
 public:
   auto& getObjects()
@@ -60,6 +133,23 @@ public:
     return m_dynamicObjects;
   }
 
+  [[nodiscard]] const auto& getObjectsByRoom() const
+  {
+    return m_objectsByRoom;
+  }
+
+  [[nodiscard]] const auto& getDynamicObjectsByRoom() const
+  {
+    return m_dynamicObjectsByRoom;
+  }
+
+  //! Must be called whenever an object changes its room.
+  void updateRoomIndex(const gsl::not_null<objects::Object*>& object)
+  {
+    m_objectsByRoom.update(object);
+    m_dynamicObjectsByRoom.update(object);
+  }
+
   objects::LaraObject& getLara()
   {
     Expects(m_lara != nullptr);
@@ -79,25 +169,48 @@ public:
 
   void scheduleDeletion(objects::Object* object)
   {
-    m_scheduledDeletions.insert(object);
+    m_scheduledDeletions.emplace_back(object);
+  }
+
+  void registerDynamicObject(const gsl::not_null<std::shared_ptr<objects::Object>>& object);
+  void registerParticle(const gsl::not_null<std::shared_ptr<Particle>>& particle);
+  //! Detaches the particle immediately, but defers its removal to the end of the current update.
+  void eraseParticle(const std::shared_ptr<Particle>& particle);
+
+  SpriteParticlePool& getBloodSplatters()
+  {
+    Expects(m_bloodSplatters != nullptr);
+    return *m_bloodSplatters;
   }
 
-  void registerDynamicObject(const gsl::not_null<std::shared_ptr<objects::Object>>& object)
+  [[nodiscard]] const SpriteParticlePool& getBloodSplatters() const
   {
-    m_dynamicObjects.emplace(object);
+    Expects(m_bloodSplatters != nullptr);
+    return *m_bloodSplatters;
   }
 
-  void registerParticle(const gsl::not_null<std::shared_ptr<Particle>>& particle)
+  SpriteParticlePool& getSplashes()
   {
-    m_particles.emplace_back(particle);
+    Expects(m_splashes != nullptr);
+    return *m_splashes;
   }
 
-  void registerParticle(gsl::not_null<std::shared_ptr<Particle>>&& particle)
+  [[nodiscard]] const SpriteParticlePool& getSplashes() const
   {
-    m_particles.emplace_back(std::move(particle));
+    Expects(m_splashes != nullptr);
+    return *m_splashes;
   }
 
-  void eraseParticle(const std::shared_ptr<Particle>& particle);
+  void setUpdateProbe(ObjectUpdateProbe probe)
+  {
+    m_updateProbe = std::move(probe);
+  }
+
+  //! Enabled by default; disabling it only makes sense to verify that the update gives the same result either way.
+  void setPreparePathSearches(bool prepare) noexcept
+  {
+    m_preparePathSearches = prepare;
+  }
 
   void applyScheduledDeletions();
   void registerObject(const gsl::not_null<std::shared_ptr<objects::Object>>& object);
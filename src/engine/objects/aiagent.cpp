@@ -6,7 +6,7 @@
 #include "engine/world/world.h"
 #include "laraobject.h"
 
-#include <boost/range/adaptors.hpp>
+#include <limits>
 #include <pybind11/pybind11.h>
 
 namespace engine::objects
@@ -62,16 +62,21 @@ bool AIAgent::isPositionOutOfReach(const core::TRVec& testPosition,
 
 bool AIAgent::anyMovingEnabledObjectInReach() const
 {
-  for(const auto& object : getWorld().getObjectManager().getObjects() | boost::adaptors::map_values)
+  const auto& objectsByRoom = getWorld().getObjectManager().getObjectsByRoom();
+  // only objects updated before this one are considered
+  const auto sequence
+    = objectsByRoom.contains(this) ? objectsByRoom.getSequence(*this) : std::numeric_limits<uint64_t>::max();
+
+  for(const auto& entry : objectsByRoom.getObjects(m_state.position, m_collisionRadius))
   {
-    if(object.get().get() == this)
+    if(entry.sequence >= sequence)
       break;
 
-    if(!object->m_isActive || object.get().get() == &getWorld().getObjectManager().getLara())
+    const auto& object = entry.object;
+    if(!object->m_isActive || object.get() == &getWorld().getObjectManager().getLara())
       continue;
 
-    if(object->m_state.triggerState == TriggerState::Active && object->m_state.speed != 0_spd
-       && object->m_state.position.position.distanceTo(m_state.position.position) < m_collisionRadius)
+    if(object->m_state.triggerState == TriggerState::Active && object->m_state.speed != 0_spd)
     {
       return true;
     }
@@ -456,10 +461,8 @@ bool AIAgent::tryShootAtLara(ModelObject& object,
     {
       isHit = true;
 
-      getWorld().getObjectManager().getLara().emitParticle(
-        core::TRVec{},
-        util::rand15(getWorld().getObjectManager().getLara().getSkeleton()->getBoneCount()),
-        &createBloodSplat);
+      getWorld().getObjectManager().getLara().emitBloodSplat(
+        core::TRVec{}, util::rand15(getWorld().getObjectManager().getLara().getSkeleton()->getBoneCount()));
 
       if(!getWorld().getObjectManager().getLara().isInWater())
         getWorld().getObjectManager().getLara().playSoundEffect(TR1SoundEffect::BulletHitsLara);
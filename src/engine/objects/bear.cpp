@@ -115,7 +115,7 @@ void Bear::update()
     case RunningAttack.get():
       if(m_state.required_anim_state == 0_as && touched(0x2406cUL))
       {
-        emitParticle(core::TRVec{0_len, 96_len, 335_len}, 14, &createBloodSplat);
+        emitBloodSplat(core::TRVec{0_len, 96_len, 335_len}, 14);
         hitLara(200_hp);
         require(GettingDown);
       }
@@ -114,11 +114,10 @@ void engine::objects::RollingBall::collide(CollisionInfo& collisionInfo)
     {
       const auto tmp = getWorld().getObjectManager().getLara().m_state.position.position
                        + core::TRVec{util::rand15s(128_len), -util::rand15s(512_len), util::rand15s(128_len)};
-      auto fx = createBloodSplat(getWorld(),
-                                 core::RoomBoundPosition{m_state.position.room, tmp},
-                                 2 * m_state.speed,
-                                 util::rand15s(22.5_deg) + m_state.rotation.Y);
-      getWorld().getObjectManager().registerParticle(fx);
+      spawnBloodSplat(getWorld(),
+                      core::RoomBoundPosition{m_state.position.room, tmp},
+                      2 * m_state.speed,
+                      util::rand15s(22.5_deg) + m_state.rotation.Y);
     }
     return;
   }
@@ -134,7 +133,7 @@ void engine::objects::RollingBall::collide(CollisionInfo& collisionInfo)
   const auto z = getWorld().getObjectManager().getLara().m_state.position.position.Z - m_state.position.position.Z;
   const auto xyz = std::max(2 * core::QuarterSectorSize, sqrt(util::square(x) + util::square(y) + util::square(z)));
 
-  auto fx = createBloodSplat(
+  spawnBloodSplat(
     getWorld(),
     core::RoomBoundPosition{
       m_state.position.room,
@@ -143,5 +142,4 @@ void engine::objects::RollingBall::collide(CollisionInfo& collisionInfo)
                   z * core::SectorSize / 2 / xyz + m_state.position.position.Z}},
     m_state.speed,
     m_state.rotation.Y);
-  getWorld().getObjectManager().registerParticle(fx);
 }
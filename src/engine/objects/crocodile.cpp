@@ -34,7 +34,7 @@ void Crocodile::updateInWater()
       {
         if(m_state.required_anim_state == 0_as)
         {
-          emitParticle({5_len, -21_len, 467_len}, 9, &createBloodSplat);
+          emitBloodSplat({5_len, -21_len, 467_len}, 9);
           hitLara(100_hp);
           require(1_as);
         }
@@ -184,7 +184,7 @@ void Crocodile::updateOnLand()
     case 5:
       if(m_state.required_anim_state == 0_as)
       {
-        emitParticle({5_len, -21_len, 467_len}, 9, &createBloodSplat);
+        emitBloodSplat({5_len, -21_len, 467_len}, 9);
         hitLara(100_hp);
         require(1_as);
       }
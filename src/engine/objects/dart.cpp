@@ -28,8 +28,7 @@ void Dart::update()
     getWorld().getObjectManager().getLara().m_state.health -= 50_hp;
     getWorld().getObjectManager().getLara().m_state.is_hit = true;
 
-    auto fx = createBloodSplat(getWorld(), m_state.position, m_state.speed, m_state.rotation.Y);
-    getWorld().getObjectManager().registerParticle(fx);
+    spawnBloodSplat(getWorld(), m_state.position, m_state.speed, m_state.rotation.Y);
   }
 
   const auto oldPos = m_state.position;
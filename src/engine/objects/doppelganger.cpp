@@ -33,8 +33,9 @@ void Doppelganger::update()
                                      lara.m_state.position.position.Y,
                                      120 * core::SectorSize - lara.m_state.position.position.Z};
 
-    const auto sector = findRealFloorSector(twinPos, &m_state.position.room);
-    setParent(getNode(), m_state.position.room->node);
+    auto room = m_state.position.room;
+    const auto sector = findRealFloorSector(twinPos, &room);
+    setCurrentRoom(room);
     m_state.floor = HeightInfo::fromCeiling(sector, twinPos, getWorld().getObjectManager().getObjects()).y;
 
     const auto laraSector = findRealFloorSector(lara.m_state.position.position, lara.m_state.position.room);
@@ -107,7 +107,7 @@ void Gorilla::update()
       // attacking
       if(m_state.required_anim_state == 0_as && touched(0xff00))
       {
-        emitParticle({0_len, -19_len, 75_len}, 15, &createBloodSplat);
+        emitBloodSplat({0_len, -19_len, 75_len}, 15);
         hitLara(200_hp);
         require(1_as);
       }
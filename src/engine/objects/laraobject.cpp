@@ -22,7 +22,6 @@
 #include "serialization/unordered_map.h"
 #include "serialization/vector_element.h"
 
-#include <boost/range/adaptors.hpp>
 #include <glm/gtx/norm.hpp>
 #include <stack>
 
@@ -403,9 +402,7 @@ void LaraObject::update()
         surfacePos.position.Y = *waterSurfaceHeight;
         surfacePos.position.Z = m_state.position.position.Z;
 
-        auto particle = std::make_shared<SplashParticle>(surfacePos, getWorld(), false);
-        setParent(particle, surfacePos.room->node);
-        getWorld().getObjectManager().registerParticle(particle);
+        spawnSplash(getWorld(), surfacePos, false);
       }
     }
   }
@@ -613,21 +610,19 @@ void LaraObject::testInteractions(CollisionInfo& collisionInfo)
   if(isDead())
     return;
 
-  std::set<gsl::not_null<const world::Room*>> rooms;
+  RoomObjectIndex::RoomSet rooms;
   rooms.insert(m_state.position.room);
   for(const world::Portal& p : m_state.position.room->portals)
     rooms.insert(p.adjoiningRoom);
 
-  const auto execCollisions = [this, &rooms, &collisionInfo](const auto& range)
+  const auto execCollisions = [this, &collisionInfo](const std::vector<RoomObjectIndex::Entry>& entries)
   {
-    for(const auto& object : range)
+    for(const auto& entry : entries)
     {
+      const auto& object = entry.object;
       if(!object->m_state.collidable || object->m_state.triggerState == TriggerState::Invisible)
         continue;
 
-      if(rooms.find(object->m_state.position.room) == rooms.end())
-        continue;
-
       const auto d = m_state.position.position - object->m_state.position.position;
       if(abs(d.X) >= 4 * core::SectorSize || abs(d.Y) >= 4 * core::SectorSize || abs(d.Z) >= 4 * core::SectorSize)
         continue;
@@ -636,8 +631,8 @@ void LaraObject::testInteractions(CollisionInfo& collisionInfo)
     }
   };
 
-  execCollisions(getWorld().getObjectManager().getObjects() | boost::adaptors::map_values);
-  execCollisions(getWorld().getObjectManager().getDynamicObjects());
+  execCollisions(getWorld().getObjectManager().getObjectsByRoom().getObjects(rooms));
+  execCollisions(getWorld().getObjectManager().getDynamicObjectsByRoom().getObjects(rooms));
 
   if(getWorld().getObjectManager().getLara().explosionStumblingDuration != 0_frame)
   {
@@ -1071,12 +1066,15 @@ void LaraObject::findTarget(const Weapon& weapon)
   weaponPosition.position.Y -= weapons.at(WeaponType::Shotgun).weaponHeight;
   aimAt.reset();
   core::Angle bestYAngle{std::numeric_limits<core::Angle::type>::max()};
-  for(const auto& currentEnemy : getWorld().getObjectManager().getObjects() | boost::adaptors::map_values)
+  // the query is slightly conservative, the exact distance is checked below
+  for(const auto& entry :
+      getWorld().getObjectManager().getObjectsByRoom().getObjects(weaponPosition, weapon.targetDist + 1_len))
   {
-    if(currentEnemy->m_state.isDead() || currentEnemy.get() == getWorld().getObjectManager().getLaraPtr())
+    const auto currentEnemy = getWorld().getObjectManager().find(entry.object);
+    if(currentEnemy->m_state.isDead() || currentEnemy == getWorld().getObjectManager().getLaraPtr())
       continue;
 
-    const auto modelEnemy = std::dynamic_pointer_cast<ModelObject>(currentEnemy.get());
+    const auto modelEnemy = std::dynamic_pointer_cast<ModelObject>(currentEnemy);
     if(modelEnemy == nullptr)
     {
       BOOST_LOG_TRIVIAL(warning) << "Ignoring non-model object " << currentEnemy->getNode()->getName();
@@ -1099,7 +1097,7 @@ void LaraObject::findTarget(const Weapon& weapon)
     if(util::square(d.X) + util::square(d.Y) + util::square(d.Z) >= util::square(weapon.targetDist))
       continue;
 
-    auto enemyPos = getUpperThirdBBoxCtr(*std::dynamic_pointer_cast<const ModelObject>(currentEnemy.get()));
+    auto enemyPos = getUpperThirdBBoxCtr(*modelEnemy);
     const auto canShoot = raycastLineOfSight(weaponPosition, enemyPos.position, getWorld().getObjectManager()).first;
     if(!canShoot)
       continue;
@@ -1597,11 +1595,10 @@ void LaraObject::hitTarget(ModelObject& object, const core::TRVec& hitPos, const
   }
   object.m_state.is_hit = true;
   object.m_state.health -= damage;
-  auto fx = createBloodSplat(getWorld(),
-                             core::RoomBoundPosition{object.m_state.position.room, hitPos},
-                             object.m_state.speed,
-                             object.m_state.rotation.Y);
-  getWorld().getObjectManager().registerParticle(fx);
+  spawnBloodSplat(getWorld(),
+                  core::RoomBoundPosition{object.m_state.position.room, hitPos},
+                  object.m_state.speed,
+                  object.m_state.rotation.Y);
   if(object.m_state.isDead())
     return;
 
@@ -288,6 +288,20 @@ gsl::not_null<std::shared_ptr<Particle>>
                                                                                  const core::Angle&))
 {
   BOOST_ASSERT(generate != nullptr);
+
+  auto particle = generate(getWorld(), getBonePosition(localPosition, boneIndex), m_state.speed, m_state.rotation.Y);
+  getWorld().getObjectManager().registerParticle(particle);
+
+  return particle;
+}
+
+void ModelObject::emitBloodSplat(const core::TRVec& localPosition, const size_t boneIndex)
+{
+  spawnBloodSplat(getWorld(), getBonePosition(localPosition, boneIndex), m_state.speed, m_state.rotation.Y);
+}
+
+core::RoomBoundPosition ModelObject::getBonePosition(const core::TRVec& localPosition, const size_t boneIndex)
+{
   BOOST_ASSERT(boneIndex < m_skeleton->getBoneCount());
 
   const auto boneSpheres
@@ -296,10 +310,7 @@ gsl::not_null<std::shared_ptr<Particle>>
 
   auto roomPos = m_state.position;
   roomPos.position = core::TRVec{glm::vec3{translate(boneSpheres.at(boneIndex).m, localPosition.toRenderSystem())[3]}};
-  auto particle = generate(getWorld(), roomPos, m_state.speed, m_state.rotation.Y);
-  getWorld().getObjectManager().registerParticle(particle);
-
-  return particle;
+  return roomPos;
 }
 
 void ModelObject::updateLighting()
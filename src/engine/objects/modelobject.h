@@ -11,6 +11,9 @@ protected:
   std::shared_ptr<SkeletalModelNode> m_skeleton;
   Lighting m_lighting;
 
+private:
+  [[nodiscard]] core::RoomBoundPosition getBonePosition(const core::TRVec& localPosition, size_t boneIndex);
+
 public:
   ModelObject(const gsl::not_null<world::World*>& world, const core::RoomBoundPosition& position)
       : Object{world, position}
@@ -89,6 +92,9 @@ public:
                                                                       const core::Speed& speed,
                                                                       const core::Angle& angle));
 
+  //! Like emitParticle(), but for the pooled blood splatters, see spawnBloodSplat().
+  void emitBloodSplat(const core::TRVec& localPosition, size_t boneIndex);
+
   void updateLighting() override;
 
   void serialize(const serialization::Serializer<world::World>& ser) override;
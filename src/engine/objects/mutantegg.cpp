@@ -138,6 +138,7 @@ void MutantEgg::update()
       if(m_childObject != nullptr)
       {
         m_childObject->m_state.position = m_state.position;
+        getWorld().getObjectManager().updateRoomIndex(m_childObject.get());
         m_childObject->m_state.rotation.Y = m_state.rotation.Y;
         addChild(m_state.position.room->node, m_childObject->getNode());
 
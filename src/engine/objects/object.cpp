@@ -70,6 +70,7 @@ void Object::setCurrentRoom(const gsl::not_null<const world::Room*>& newRoom)
   setParent(getNode(), newRoom->node);
 
   m_state.position.room = newRoom;
+  getWorld().getObjectManager().updateRoomIndex(this);
   applyTransform();
 }
 
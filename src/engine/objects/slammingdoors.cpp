@@ -27,9 +27,8 @@ void SlammingDoors::update()
         const auto position
           = core::TRVec{glm::vec3{translate(objectSpheres.at(boneId).m, bitePos.toRenderSystem())[3]}};
 
-        auto blood = createBloodSplat(
+        spawnBloodSplat(
           getWorld(), core::RoomBoundPosition{m_state.position.room, position}, m_state.speed, m_state.rotation.Y);
-        getWorld().getObjectManager().registerParticle(std::move(blood));
       };
 
       for(const auto& x : {-23_len, 71_len})
@@ -33,11 +33,10 @@ void SwingingBlade::update()
       getWorld().getObjectManager().getLara().m_state.position.position.X + util::rand15s(128_len),
       getWorld().getObjectManager().getLara().m_state.position.position.Y - util::rand15(745_len),
       getWorld().getObjectManager().getLara().m_state.position.position.Z + util::rand15s(128_len)};
-    auto fx = createBloodSplat(getWorld(),
-                               core::RoomBoundPosition{m_state.position.room, splatPos},
-                               getWorld().getObjectManager().getLara().m_state.speed,
-                               getWorld().getObjectManager().getLara().m_state.rotation.Y + util::rand15s(+22_deg));
-    getWorld().getObjectManager().registerParticle(fx);
+    spawnBloodSplat(getWorld(),
+                    core::RoomBoundPosition{m_state.position.room, splatPos},
+                    getWorld().getObjectManager().getLara().m_state.speed,
+                    getWorld().getObjectManager().getLara().m_state.rotation.Y + util::rand15s(+22_deg));
   }
 
   auto room = m_state.position.room;
@@ -62,11 +62,10 @@ void SwordOfDamocles::collide(CollisionInfo& collisionInfo)
   getWorld().getObjectManager().getLara().m_state.health -= 100_hp;
   const auto tmp = getWorld().getObjectManager().getLara().m_state.position.position
                    + core::TRVec{util::rand15s(128_len), -util::rand15(745_len), util::rand15s(128_len)};
-  auto fx = createBloodSplat(getWorld(),
-                             core::RoomBoundPosition{m_state.position.room, tmp},
-                             getWorld().getObjectManager().getLara().m_state.speed,
-                             util::rand15s(22.5_deg) + m_state.rotation.Y);
-  getWorld().getObjectManager().registerParticle(fx);
+  spawnBloodSplat(getWorld(),
+                  core::RoomBoundPosition{m_state.position.room, tmp},
+                  getWorld().getObjectManager().getLara().m_state.speed,
+                  util::rand15s(22.5_deg) + m_state.rotation.Y);
 }
 
 void SwordOfDamocles::serialize(const serialization::Serializer<world::World>& ser)
@@ -30,15 +30,13 @@ void engine::objects::TeethSpikes::collide(CollisionInfo& collisionInfo)
     getWorld().getObjectManager().getLara().m_state.health -= 15_hp;
     while(bloodSplats-- > 0)
     {
-      auto fx
-        = createBloodSplat(getWorld(),
-                           core::RoomBoundPosition{
-                             getWorld().getObjectManager().getLara().m_state.position.room,
-                             getWorld().getObjectManager().getLara().m_state.position.position
-                               + core::TRVec{util::rand15s(128_len), -util::rand15(512_len), util::rand15s(128_len)}},
-                           20_spd,
-                           util::rand15(+180_deg));
-      getWorld().getObjectManager().registerParticle(fx);
+      spawnBloodSplat(getWorld(),
+                      core::RoomBoundPosition{
+                        getWorld().getObjectManager().getLara().m_state.position.room,
+                        getWorld().getObjectManager().getLara().m_state.position.position
+                          + core::TRVec{util::rand15s(128_len), -util::rand15(512_len), util::rand15s(128_len)}},
+                      20_spd,
+                      util::rand15(+180_deg));
     }
     if(getWorld().getObjectManager().getLara().isDead())
     {
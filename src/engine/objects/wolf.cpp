@@ -140,7 +140,7 @@ void Wolf::update()
       roll = rotationToMoveTarget;
       if(m_state.required_anim_state == 0_as && touched(0x774fUL))
       {
-        emitParticle(core::TRVec{0_len, -14_len, 174_len}, 6, &createBloodSplat);
+        emitBloodSplat(core::TRVec{0_len, -14_len, 174_len}, 6);
         hitLara(50_hp);
         require(Jumping);
       }
@@ -149,7 +149,7 @@ void Wolf::update()
     case Biting.get():
       if(m_state.required_anim_state == 0_as && touched(0x774fUL) && enemyLocation.enemyAhead)
       {
-        emitParticle(core::TRVec{0_len, -14_len, 174_len}, 6, &createBloodSplat);
+        emitBloodSplat(core::TRVec{0_len, -14_len, 174_len}, 6);
         hitLara(100_hp);
         require(PrepareToStrike);
       }
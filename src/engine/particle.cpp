@@ -3,9 +3,7 @@
 #include "audioengine.h"
 #include "objects/laraobject.h"
 #include "presenter.h"
-#include "render/scene/materialmanager.h"
 #include "render/scene/mesh.h"
-#include "world/rendermeshdata.h"
 #include "world/world.h"
 
 #include <utility>
@@ -16,32 +14,10 @@ void Particle::initRenderables(world::World& world)
 {
   setShade(core::Shade{core::Shade::type{4096}});
 
-  if(const auto& modelType = world.findAnimatedModelForType(object_number))
+  m_renderables = world.getParticleRenderables(object_number).get();
+  if(!m_renderables->empty())
   {
-    for(const auto& bone : modelType->bones)
-    {
-      world::RenderMeshDataCompositor compositor;
-      compositor.append(*bone.mesh);
-      m_renderables.emplace_back(compositor.toMesh(*world.getPresenter().getMaterialManager(), false, {}));
-    }
-  }
-  else if(const auto& spriteSequence = world.findSpriteSequenceForType(object_number))
-  {
-    for(const world::Sprite& spr : spriteSequence->sprites)
-    {
-      m_renderables.emplace_back(spr.mesh);
-    }
-  }
-  else
-  {
-    BOOST_LOG_TRIVIAL(warning) << "Missing sprite/model referenced by particle: "
-                               << toString(static_cast<TR1ItemId>(object_number.get()));
-    return;
-  }
-
-  if(!m_renderables.empty())
-  {
-    setRenderable(m_renderables.front());
+    setRenderable(m_renderables->front());
     m_lighting.bind(*this);
   }
 }
@@ -67,8 +43,10 @@ Particle::Particle(const std::string& id,
   }
   else
   {
-    m_renderables.emplace_back(renderable);
-    setRenderable(m_renderables.front());
+    auto renderables = std::make_shared<world::World::RenderableSequence>();
+    renderables->emplace_back(renderable);
+    m_renderables = std::move(renderables);
+    setRenderable(renderable);
     m_lighting.bind(*this);
   }
 }
@@ -89,43 +67,14 @@ Particle::Particle(const std::string& id,
   }
   else
   {
-    m_renderables.emplace_back(renderable);
-    setRenderable(m_renderables.front());
+    auto renderables = std::make_shared<world::World::RenderableSequence>();
+    renderables->emplace_back(renderable);
+    m_renderables = std::move(renderables);
+    setRenderable(renderable);
     m_lighting.bind(*this);
   }
 }
 
-bool BloodSplatterParticle::update(world::World& world)
-{
-  pos.position += util::pitch(speed * 1_frame, angle.Y);
-  ++timePerSpriteFrame;
-  if(timePerSpriteFrame != 4)
-    return true;
-
-  timePerSpriteFrame = 0;
-  nextFrame();
-  if(gsl::narrow<size_t>(-negSpriteFrameId) >= world.findSpriteSequenceForType(object_number)->sprites.size())
-    return false;
-
-  applyTransform();
-  return true;
-}
-
-bool SplashParticle::update(world::World& world)
-{
-  nextFrame();
-
-  if(gsl::narrow<size_t>(-negSpriteFrameId) >= world.findSpriteSequenceForType(object_number)->sprites.size())
-  {
-    return false;
-  }
-
-  pos.position += util::pitch(speed * 1_frame, angle.Y);
-
-  applyTransform();
-  return true;
-}
-
 bool BubbleParticle::update(world::World& world)
 {
   angle.X += 13_deg;
@@ -320,10 +269,8 @@ bool MutantBulletParticle::update(world::World& world)
   else if(world.getObjectManager().getLara().isNear(*this, 200_len))
   {
     world.getObjectManager().getLara().m_state.health -= 30_hp;
-    auto particle = std::make_shared<BloodSplatterParticle>(pos, speed, angle.Y, world);
-    setParent(particle, pos.room->node);
-    world.getObjectManager().registerParticle(particle);
-    world.getAudioEngine().playSoundEffect(TR1SoundEffect::BulletHitsLara, particle.get());
+    spawnBloodSplat(world, pos, speed, angle.Y);
+    world.getAudioEngine().playSoundEffect(TR1SoundEffect::BulletHitsLara, pos.position.toRenderSystem());
     world.getObjectManager().getLara().m_state.is_hit = true;
     angle.Y = world.getObjectManager().getLara().m_state.rotation.Y;
     speed = world.getObjectManager().getLara().m_state.speed;
@@ -468,4 +415,29 @@ bool RicochetParticle::update(world::World&)
   --timePerSpriteFrame;
   return timePerSpriteFrame != 0;
 }
+
+void spawnBloodSplat(world::World& world,
+                     const core::RoomBoundPosition& pos,
+                     const core::Speed& speed,
+                     const core::Angle& angle)
+{
+  world.getObjectManager().getBloodSplatters().spawn(pos, util::pitch(speed * 1_frame, angle));
+}
+
+void spawnSplash(world::World& world, const core::RoomBoundPosition& pos, const bool waterfall)
+{
+  if(!waterfall)
+  {
+    const auto speed = util::rand15(128_spd);
+    const auto angle = core::auToAngle(2 * util::rand15s());
+    world.getObjectManager().getSplashes().spawn(pos, util::pitch(speed * 1_frame, angle));
+  }
+  else
+  {
+    auto splashPos = pos;
+    splashPos.position.X += util::rand15s(core::SectorSize);
+    splashPos.position.Z += util::rand15s(core::SectorSize);
+    world.getObjectManager().getSplashes().spawn(splashPos, core::TRVec{});
+  }
+}
 } // namespace engine
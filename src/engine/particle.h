@@ -10,9 +10,9 @@
 #include "render/scene/node.h"
 #include "util/helpers.h"
 
-#include <deque>
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
+#include <vector>
 
 namespace engine::world
 {
@@ -35,7 +35,9 @@ public:
   int16_t timePerSpriteFrame = 0;
 
 private:
-  std::deque<gsl::not_null<std::shared_ptr<render::scene::Renderable>>> m_renderables{};
+  //! Shared by all particles of the same type, see world::World::getParticleRenderables().
+  std::shared_ptr<const std::vector<gsl::not_null<std::shared_ptr<render::scene::Renderable>>>> m_renderables{};
+  size_t m_renderableIndex = 0;
   Lighting m_lighting;
 
   void initRenderables(world::World& world);
@@ -45,12 +47,11 @@ protected:
   {
     --negSpriteFrameId;
 
-    if(m_renderables.empty())
+    if(getLength() == 0)
       return;
 
-    m_renderables.emplace_back(m_renderables.front());
-    m_renderables.pop_front();
-    setRenderable(m_renderables.front());
+    m_renderableIndex = (m_renderableIndex + 1) % getLength();
+    setRenderable(m_renderables->at(m_renderableIndex));
   }
 
   void applyTransform()
@@ -61,12 +62,13 @@ protected:
 
   size_t getLength() const
   {
-    return m_renderables.size();
+    return m_renderables == nullptr ? 0 : m_renderables->size();
   }
 
   void clearRenderables()
   {
-    m_renderables.clear();
+    m_renderables.reset();
+    m_renderableIndex = 0;
   }
 
 public:
@@ -92,43 +94,6 @@ public:
   glm::vec3 getPosition() const final;
 };
 
-class BloodSplatterParticle final : public Particle
-{
-public:
-  explicit BloodSplatterParticle(const core::RoomBoundPosition& pos,
-                                 const core::Speed& speed_,
-                                 const core::Angle& angle_,
-                                 world::World& world)
-      : Particle{"bloodsplat", TR1ItemId::Blood, pos, world}
-  {
-    speed = speed_;
-    angle.Y = angle_;
-  }
-
-  bool update(world::World& world) override;
-};
-
-class SplashParticle final : public Particle
-{
-public:
-  explicit SplashParticle(const core::RoomBoundPosition& pos, world::World& world, const bool waterfall)
-      : Particle{"splash", TR1ItemId::Splash, pos, world}
-  {
-    if(!waterfall)
-    {
-      speed = util::rand15(128_spd);
-      angle.Y = core::auToAngle(2 * util::rand15s());
-    }
-    else
-    {
-      this->pos.position.X += util::rand15s(core::SectorSize);
-      this->pos.position.Z += util::rand15s(core::SectorSize);
-    }
-  }
-
-  bool update(world::World& world) override;
-};
-
 class RicochetParticle final : public Particle
 {
 public:
@@ -306,13 +271,12 @@ public:
   bool update(world::World& /*world*/) override;
 };
 
-inline gsl::not_null<std::shared_ptr<Particle>> createBloodSplat(world::World& world,
-                                                                 const core::RoomBoundPosition& pos,
-                                                                 const core::Speed& speed,
-                                                                 const core::Angle& angle)
-{
-  auto particle = std::make_shared<BloodSplatterParticle>(pos, speed, angle, world);
-  setParent(particle, pos.room->node);
-  return particle;
-}
-} // namespace engine
\ No newline at end of file
+//! Blood splatters are pooled instead of being scene nodes, see ObjectManager::getBloodSplatters().
+void spawnBloodSplat(world::World& world,
+                     const core::RoomBoundPosition& pos,
+                     const core::Speed& speed,
+                     const core::Angle& angle);
+
+//! Splashes are pooled instead of being scene nodes, see ObjectManager::getSplashes().
+void spawnSplash(world::World& world, const core::RoomBoundPosition& pos, bool waterfall);
+} // namespace engine
@@ -2,18 +2,25 @@
 
 #include "audioengine.h"
 #include "core/i18n.h"
+#include "core/magic.h"
 #include "engine.h"
 #include "engine/objects/laraobject.h"
 #include "loader/file/level/level.h"
 #include "objectmanager.h"
+#include "profiler.h"
 #include "render/pass/config.h"
+#include "render/portaltracer.h"
 #include "render/renderpipeline.h"
 #include "render/scene/camera.h"
 #include "render/scene/csm.h"
+#include "render/scene/framearena.h"
+#include "render/scene/hizbuffer.h"
 #include "render/scene/materialmanager.h"
+#include "render/scene/mesh.h"
 #include "render/scene/node.h"
 #include "render/scene/rendercontext.h"
 #include "render/scene/renderer.h"
+#include "render/scene/renderqueue.h"
 #include "render/scene/screenoverlay.h"
 #include "render/scene/shadercache.h"
 #include "render/textureanimator.h"
@@ -21,15 +28,37 @@
 #include "ui/ui.h"
 #include "video/player.h"
 
+#include <algorithm>
 #include <boost/range/adaptors.hpp>
 #include <gl/debuggroup.h>
 #include <gl/font.h>
 #include <gl/texture2d.h>
+#include <iterator>
 
 namespace
 {
 constexpr int StatusLineFontSize = 40;
 constexpr int DebugTextFontSize = 12;
+// the occlusion depth lags a few frames behind, and is not used anymore if the camera moved or turned farther since
+constexpr auto MaxHiZCameraDistance = (core::QuarterSectorSize / 2).get<float>();
+const auto MaxHiZCameraAngle = glm::radians(10.0f);
+
+//! Only meshes are rendered into the shadow maps; e.g. sprite particles never change them.
+bool castsShadow(const render::scene::Node& node)
+{
+  if(!node.isVisible())
+    return false;
+
+  if(const auto mesh = std::dynamic_pointer_cast<render::scene::Mesh>(node.getRenderable());
+     mesh != nullptr && mesh->getMaterialGroup().get(render::scene::RenderMode::CSMDepthOnly) != nullptr)
+  {
+    return true;
+  }
+
+  return std::any_of(node.getChildren().begin(),
+                     node.getChildren().end(),
+                     [](const auto& child) { return castsShadow(*child); });
+}
 } // namespace
 
 namespace engine
@@ -77,85 +106,193 @@ void Presenter::playVideo(const std::filesystem::path& path)
     });
 }
 
-void Presenter::renderWorld(const ObjectManager& objectManager,
+void Presenter::renderWorld(ObjectManager& objectManager,
                             const std::vector<world::Room>& rooms,
                             const CameraController& cameraController,
                             const std::unordered_set<const world::Portal*>& waterEntryPortals,
                             float delayRatio)
 {
+  ENGINE_PROFILE_ZONE("Presenter::renderWorld");
   m_renderPipeline->updateCamera(m_renderer->getCamera());
 
   {
     SOGLB_DEBUGGROUP("csm-pass");
+    ENGINE_PROFILE_GPU_ZONE("csm-pass");
     gl::RenderState::resetWantedState();
     gl::RenderState::getWantedState().setDepthClamp(true);
     m_csm->updateCamera(*m_renderer->getCamera());
     m_csm->applyViewport();
 
+    // the scenery never moves, so it's rendered into a separate layer that is only updated when needed
+    struct ShadowCaster
+    {
+      const world::Room* room;
+      std::vector<render::scene::Node*> dynamicNodes;
+    };
+
+    std::vector<ShadowCaster> shadowCasters;
+    for(const auto& room : rooms)
+    {
+      if(!room.node->isVisible())
+        continue;
+
+      auto& caster = shadowCasters.emplace_back(ShadowCaster{&room, {}});
+      for(const auto& child : room.node->getChildren())
+      {
+        if(std::find(room.sceneryNodes.begin(), room.sceneryNodes.end(), child) == room.sceneryNodes.end()
+           && castsShadow(*child))
+        {
+          caster.dynamicNodes.emplace_back(child.get());
+        }
+      }
+    }
+
     for(size_t i = 0; i < render::scene::CSMBuffer::NSplits; ++i)
     {
       SOGLB_DEBUGGROUP("csm-pass/" + std::to_string(i));
+      ENGINE_PROFILE_GPU_ZONE("csm-pass/" + std::to_string(i));
 
       m_csm->setActiveSplit(i);
-      m_csm->getActiveFramebuffer()->bindWithAttachments();
-      m_renderer->clear(gl::api::ClearBufferMask::DepthBufferBit, {0, 0, 0, 0}, 1);
-
-      render::scene::RenderContext context{render::scene::RenderMode::CSMDepthOnly,
-                                           m_csm->getActiveMatrix(glm::mat4{1.0f})};
-      render::scene::Visitor visitor{context};
+      const auto splitMatrix = m_csm->getActiveMatrix(glm::mat4{1.0f});
 
-      for(const auto& room : rooms)
+      std::vector<const ShadowCaster*> splitCasters;
+      std::vector<const render::scene::Node*> splitRoomNodes;
+      std::vector<render::scene::Node*> splitDynamicNodes;
+      for(const auto& caster : shadowCasters)
       {
-        if(!room.node->isVisible())
+        if(caster.room->canBeCulled(splitMatrix))
           continue;
 
-        for(const auto& child : room.node->getChildren())
+        splitCasters.emplace_back(&caster);
+        splitRoomNodes.emplace_back(caster.room->node.get());
+        std::copy_if(caster.dynamicNodes.begin(),
+                     caster.dynamicNodes.end(),
+                     std::back_inserter(splitDynamicNodes),
+                     [&splitMatrix](const render::scene::Node* node) { return !node->canBeCulled(splitMatrix); });
+      }
+
+      render::scene::RenderContext context{render::scene::RenderMode::CSMDepthOnly, splitMatrix};
+      context.setRenderQueue(&m_renderer->getRenderQueue());
+      render::scene::Visitor visitor{context};
+
+      if(m_csm->beginStaticLayer(std::move(splitRoomNodes)))
+      {
+        SOGLB_DEBUGGROUP("csm-pass-static/" + std::to_string(i));
+        m_renderer->clear(gl::api::ClearBufferMask::DepthBufferBit, {0, 0, 0, 0}, 1);
+        for(const auto& caster : splitCasters)
         {
-          visitor.visit(*child);
+          for(const auto& sceneryNode : caster->room->sceneryNodes)
+            visitor.visit(*sceneryNode);
         }
+        m_renderer->getRenderQueue().submit();
       }
+
+      if(!m_csm->beginDynamicLayer(!splitDynamicNodes.empty()))
+        continue;
+
+      for(const auto& node : splitDynamicNodes)
+        visitor.visit(*node);
+      m_renderer->getRenderQueue().submit();
     }
 
     for(size_t i = 0; i < render::scene::CSMBuffer::NSplits; ++i)
     {
-      SOGLB_DEBUGGROUP("csm-pass-square/" + std::to_string(i));
       m_csm->setActiveSplit(i);
+      if(!m_csm->isActiveSplitDirty())
+        continue;
+
+      SOGLB_DEBUGGROUP("csm-pass-square/" + std::to_string(i));
+      ENGINE_PROFILE_GPU_ZONE("csm-pass-square/" + std::to_string(i));
       m_csm->renderSquare();
     }
     for(size_t i = 0; i < render::scene::CSMBuffer::NSplits; ++i)
     {
-      SOGLB_DEBUGGROUP("csm-pass-blur/" + std::to_string(i));
       m_csm->setActiveSplit(i);
+      if(!m_csm->isActiveSplitDirty())
+        continue;
+
+      SOGLB_DEBUGGROUP("csm-pass-blur/" + std::to_string(i));
+      ENGINE_PROFILE_GPU_ZONE("csm-pass-blur/" + std::to_string(i));
       m_csm->renderBlur();
     }
   }
 
   {
     SOGLB_DEBUGGROUP("geometry-pass");
+    ENGINE_PROFILE_GPU_ZONE("geometry-pass");
     m_renderPipeline->bindGeometryFrameBuffer(m_window->getViewport());
     m_renderer->clear(
       gl::api::ClearBufferMask::ColorBufferBit | gl::api::ClearBufferMask::DepthBufferBit, {0, 0, 0, 0}, 1);
 
     {
       SOGLB_DEBUGGROUP("depth-prefill-pass");
+      ENGINE_PROFILE_GPU_ZONE("depth-prefill-pass");
       gl::RenderState::resetWantedState();
       render::scene::RenderContext context{render::scene::RenderMode::DepthOnly,
                                            cameraController.getCamera()->getViewProjectionMatrix()};
+      // everything of a room outside of its cull box is hidden by the rooms in front of it
+      GL_ASSERT(gl::api::enable(gl::api::EnableCap::ScissorTest));
       for(const auto& room : rooms)
       {
         if(!room.node->isVisible())
           continue;
 
         SOGLB_DEBUGGROUP(room.node->getName());
+        const auto cullBox
+          = cameraController.getRoomCullBox(room).value_or(render::PortalTracer::CullBox{-1, -1, 1, 1});
+        const auto viewport = glm::vec2{m_window->getViewport()};
+        const auto min = glm::floor((cullBox.min * 0.5f + 0.5f) * viewport);
+        const auto max = glm::ceil((cullBox.max * 0.5f + 0.5f) * viewport);
+        GL_ASSERT(gl::api::scissor(gsl::narrow_cast<int32_t>(min.x),
+                                   gsl::narrow_cast<int32_t>(min.y),
+                                   gsl::narrow_cast<gl::api::core::SizeType>(max.x - min.x),
+                                   gsl::narrow_cast<gl::api::core::SizeType>(max.y - min.y)));
         context.setCurrentNode(room.node.get());
         room.node->getRenderable()->render(context);
       }
+      GL_ASSERT(gl::api::disable(gl::api::EnableCap::ScissorTest));
       if constexpr(render::pass::FlushPasses)
         GL_ASSERT(gl::api::finish());
     }
 
+    {
+      ENGINE_PROFILE_GPU_ZONE("hiz-pass");
+      // only the rooms are in the depth buffer yet, so objects never occlude themselves
+      m_renderPipeline->hiZPass(cameraController.getCamera()->getViewProjectionMatrix());
+    }
+
     gl::RenderState::resetWantedState();
-    m_renderer->render();
+    m_renderPipeline->bindGeometryFrameBuffer(m_window->getViewport());
+    {
+      ENGINE_PROFILE_GPU_ZONE("scene-pass");
+      // the rooms' contents are culled against the union of all screen areas the rooms are seen through; the room
+      // geometry itself isn't culled, but it's hidden by the depth prefill anyway
+      const auto& viewProjection = cameraController.getCamera()->getViewProjectionMatrix();
+      std::vector<std::pair<render::scene::Node*, std::optional<glm::mat4>>> roomNodes;
+      for(const auto& room : rooms)
+      {
+        if(!room.node->isVisible())
+          continue;
+
+        if(const auto cullBox = cameraController.getRoomCullBox(room))
+          roomNodes.emplace_back(room.node.get(), cullBox->getCropMatrix() * viewProjection);
+        else
+          roomNodes.emplace_back(room.node.get(), viewProjection);
+      }
+      // pooled particles of all visible rooms are drawn with a single instanced draw per sprite
+      for(auto* pool : {&objectManager.getBloodSplatters(), &objectManager.getSplashes()})
+      {
+        pool->updateInstances();
+        roomNodes.emplace_back(pool->getNode().get().get(), std::nullopt);
+      }
+      // the tested bounds are grown by the distance the camera moved since the depth was rendered, so objects that
+      // just came into view behind an occluder edge aren't skipped
+      const auto& hiZBuffer = m_renderPipeline->getHiZBuffer();
+      if(const auto cameraOffset = hiZBuffer.getCameraOffset(viewProjection, MaxHiZCameraDistance, MaxHiZCameraAngle))
+        m_renderer->render(roomNodes, &hiZBuffer, *cameraOffset);
+      else
+        m_renderer->render(roomNodes);
+    }
 
     if constexpr(render::pass::FlushPasses)
       GL_ASSERT(gl::api::finish());
@@ -163,6 +300,7 @@ void Presenter::renderWorld(const ObjectManager& objectManager,
 
   {
     SOGLB_DEBUGGROUP("portal-depth-pass");
+    ENGINE_PROFILE_GPU_ZONE("portal-depth-pass");
     gl::RenderState::resetWantedState();
 
     render::scene::RenderContext context{render::scene::RenderMode::DepthOnly,
@@ -337,8 +475,9 @@ void Presenter::drawBars(ui::Ui& ui, const std::array<gl::SRGBA8, 256>& palette,
           });
 }
 
-Presenter::Presenter(const std::filesystem::path& rootPath, const glm::ivec2& resolution)
-    : m_window{std::make_unique<gl::Window>(resolution)}
+Presenter::Presenter(const std::filesystem::path& rootPath, const glm::ivec2& resolution, bool headless)
+    : m_window{std::make_unique<gl::Window>(resolution, !headless)}
+    , m_profiler{std::make_unique<Profiler>()}
     , m_soundEngine{std::make_shared<audio::SoundEngine>()}
     , m_renderer{std::make_shared<render::scene::Renderer>(std::make_shared<render::scene::Camera>(
         DefaultFov, m_window->getViewport(), DefaultNearPlane, DefaultFarPlane))}
@@ -348,7 +487,7 @@ Presenter::Presenter(const std::filesystem::path& rootPath, const glm::ivec2& re
     , m_debugFont{std::make_unique<gl::Font>(util::ensureFileExists(rootPath / "DroidSansMono.ttf"))}
     , m_inputHandler{std::make_unique<hid::InputHandler>(m_window->getWindow(),
                                                          rootPath / "share" / "gamecontrollerdb.txt")}
-    , m_shaderCache{std::make_shared<render::scene::ShaderCache>(rootPath / "shaders")}
+    , m_shaderCache{std::make_shared<render::scene::ShaderCache>(rootPath / "shaders", rootPath / "cache" / "shaders")}
     , m_materialManager{std::make_unique<render::scene::MaterialManager>(m_shaderCache, m_renderer)}
     , m_csm{std::make_shared<render::scene::CSM>(1024, *m_materialManager)}
     , m_renderPipeline{std::make_unique<render::RenderPipeline>(*m_materialManager, m_window->getViewport())}
@@ -356,6 +495,7 @@ Presenter::Presenter(const std::filesystem::path& rootPath, const glm::ivec2& re
   m_materialManager->setCSM(m_csm);
   scaleSplashImage();
   drawLoadingScreen(_("Booting"));
+  m_shaderCache->warmUp();
 }
 
 Presenter::~Presenter() = default;
@@ -416,7 +556,7 @@ void Presenter::drawLoadingScreen(const std::string& state)
   swapBuffers();
 }
 
-bool Presenter::preFrame()
+bool Presenter::preFrame(bool updateInput)
 {
   m_window->updateWindowSize();
   if(m_window->isMinimized())
@@ -434,11 +574,14 @@ bool Presenter::preFrame()
     m_screenOverlay->getImage()->fill({0, 0, 0, 0});
   }
 
-  m_inputHandler->update();
-
-  if(m_inputHandler->hasDebouncedAction(hid::Action::Debug))
+  if(updateInput)
   {
-    m_showDebugInfo = !m_showDebugInfo;
+    m_inputHandler->update();
+
+    if(m_inputHandler->hasDebouncedAction(hid::Action::Debug))
+    {
+      m_showDebugInfo = !m_showDebugInfo;
+    }
   }
 
   m_renderer->clear(
@@ -459,8 +602,10 @@ void Presenter::setTrFont(std::unique_ptr<ui::TRFont>&& font)
 
 void Presenter::swapBuffers()
 {
+  m_renderer->getFrameArena()->nextFrame();
   m_window->swapBuffers();
   m_soundEngine->update();
+  m_profiler->nextFrame();
 }
 
 void Presenter::clear()
@@ -515,6 +660,7 @@ void Presenter::renderScreenOverlay()
 
 void Presenter::renderUi(ui::Ui& ui, float alpha)
 {
+  ENGINE_PROFILE_GPU_ZONE("ui-pass");
   m_renderPipeline->bindUiFrameBuffer();
   ui.render(getViewport());
   m_renderPipeline->renderUiFrameBuffer(alpha);
@@ -524,4 +670,14 @@ void Presenter::disableScreenOverlay()
 {
   m_screenOverlay.reset();
 }
+
+void Presenter::resetHiZBuffer()
+{
+  m_renderPipeline->resetHiZBuffer();
+}
+
+void Presenter::resetStaticShadows()
+{
+  m_csm->resetStaticLayers();
+}
 } // namespace engine
@@ -49,6 +49,7 @@ class AudioEngine;
 class Engine;
 class ObjectManager;
 class CameraController;
+class Profiler;
 
 class Presenter final
 {
@@ -57,17 +58,23 @@ public:
   static const constexpr float DefaultFarPlane = 20480.0f;
   static const constexpr float DefaultFov = glm::radians(60.0f);
 
-  explicit Presenter(const std::filesystem::path& rootPath, const glm::ivec2& resolution);
+  explicit Presenter(const std::filesystem::path& rootPath, const glm::ivec2& resolution, bool headless = false);
   ~Presenter();
 
   void playVideo(const std::filesystem::path& path);
 
-  void renderWorld(const ObjectManager& objectManager,
+  void renderWorld(ObjectManager& objectManager,
                    const std::vector<world::Room>& rooms,
                    const CameraController& cameraController,
                    const std::unordered_set<const world::Portal*>& waterEntryPortals,
                    float delayRatio);
 
+  //! Discards the depth used for occlusion culling; must be called whenever the room geometry changes.
+  void resetHiZBuffer();
+
+  //! Discards the cached shadow depth of the scenery; must be called whenever the room geometry changes.
+  void resetStaticShadows();
+
   [[nodiscard]] const auto& getSoundEngine() const
   {
     return m_soundEngine;
@@ -124,7 +131,8 @@ public:
   void apply(const render::RenderSettings& renderSettings);
 
   void drawLoadingScreen(const std::string& state);
-  bool preFrame();
+  //! @param updateInput must only be false for frames that don't advance the simulation
+  bool preFrame(bool updateInput = true);
   [[nodiscard]] bool shouldClose() const;
 
   void setTrFont(std::unique_ptr<ui::TRFont>&& font);
@@ -147,10 +155,17 @@ public:
 
   [[nodiscard]] gl::CImgWrapper takeScreenshot() const;
 
+  [[nodiscard]] Profiler& getProfiler()
+  {
+    BOOST_ASSERT(m_profiler != nullptr);
+    return *m_profiler;
+  }
+
   void disableScreenOverlay();
 
 private:
   const std::unique_ptr<gl::Window> m_window;
+  const std::unique_ptr<Profiler> m_profiler;
 
   std::shared_ptr<audio::SoundEngine> m_soundEngine;
   const std::shared_ptr<render::scene::Renderer> m_renderer;
@@ -0,0 +1,207 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <boost/log/trivial.hpp>
+#include <fstream>
+#include <gsl/gsl-lite.hpp>
+
+namespace engine
+{
+namespace
+{
+// number of frames to wait before reading GPU queries without stalling
+constexpr size_t GpuResolveLatency = 3;
+
+using Micros = std::chrono::duration<double, std::micro>;
+
+void writeJsonString(std::ostream& out, const std::string& str)
+{
+  out << '"';
+  for(const auto c : str)
+  {
+    switch(c)
+    {
+    case '"': out << "\\\""; break;
+    case '\\': out << "\\\\"; break;
+    default:
+      if(static_cast<unsigned char>(c) >= 0x20)
+        out << c;
+      break;
+    }
+  }
+  out << '"';
+}
+
+void writeEvent(std::ostream& out, bool& first, const std::string& name, double ts, double dur, int tid)
+{
+  if(!first)
+    out << ",\n";
+  first = false;
+
+  out << R"({"name":)";
+  writeJsonString(out, name);
+  out << R"(,"ph":"X","pid":0,"tid":)" << tid << R"(,"ts":)" << ts << R"(,"dur":)" << std::max(dur, 0.0) << "}";
+}
+} // namespace
+
+Profiler* Profiler::s_active = nullptr;
+
+Profiler::Profiler()
+    : m_epoch{Clock::now()}
+    , m_frames(FrameHistory)
+{
+  Expects(s_active == nullptr);
+  s_active = this;
+  startFrame();
+}
+
+Profiler::~Profiler()
+{
+  BOOST_ASSERT(s_active == this);
+  s_active = nullptr;
+}
+
+Profiler::FrameRecord* Profiler::findFrame(size_t serial)
+{
+  auto& frame = m_frames[serial % FrameHistory];
+  if(frame.serial != serial)
+    return nullptr;
+  return &frame;
+}
+
+void Profiler::startFrame()
+{
+  auto& frame = m_frames[m_currentSerial % FrameHistory];
+  // the slot is recycled; its queries were submitted FrameHistory frames ago, so this won't stall
+  resolve(frame, true);
+
+  frame.serial = m_currentSerial;
+  frame.zones.clear();
+  frame.usedQueries = 0;
+  frame.resolved = false;
+  frame.gpuCalibration = gl::TimestampQuery::getCurrentTimestamp();
+  frame.cpuStart = Clock::now();
+  frame.cpuEnd = frame.cpuStart;
+}
+
+void Profiler::nextFrame()
+{
+  if(auto frame = findFrame(m_currentSerial))
+    frame->cpuEnd = Clock::now();
+
+  if(m_currentSerial >= GpuResolveLatency)
+  {
+    if(auto frame = findFrame(m_currentSerial - GpuResolveLatency))
+      resolve(*frame, false);
+  }
+
+  ++m_currentSerial;
+  startFrame();
+}
+
+size_t Profiler::recordGpuTimestamp(FrameRecord& frame)
+{
+  if(frame.usedQueries == frame.queries.size())
+    frame.queries.emplace_back();
+  frame.queries[frame.usedQueries].record();
+  return frame.usedQueries++;
+}
+
+Profiler::ZoneHandle Profiler::beginZone(std::string name, bool gpu)
+{
+  auto& frame = m_frames[m_currentSerial % FrameHistory];
+  ZoneRecord zone{std::move(name), Clock::now(), {}};
+  if(gpu)
+    zone.gpuStartQuery = recordGpuTimestamp(frame);
+  zone.cpuEnd = zone.cpuStart;
+  frame.zones.emplace_back(std::move(zone));
+  return ZoneHandle{m_currentSerial, frame.zones.size() - 1};
+}
+
+void Profiler::endZone(const ZoneHandle& handle)
+{
+  // zones may span a frame boundary, and frames may have been recycled in the meantime
+  auto frame = findFrame(handle.frameSerial);
+  if(frame == nullptr || handle.zoneIndex >= frame->zones.size())
+    return;
+
+  auto& zone = frame->zones[handle.zoneIndex];
+  zone.cpuEnd = Clock::now();
+  if(zone.gpuStartQuery.has_value())
+    zone.gpuEndQuery = recordGpuTimestamp(*frame);
+}
+
+bool Profiler::resolve(FrameRecord& frame, bool wait)
+{
+  if(frame.resolved)
+    return true;
+
+  if(!wait && frame.usedQueries > 0 && !frame.queries[frame.usedQueries - 1].isAvailable())
+    return false;
+
+  for(auto& zone : frame.zones)
+  {
+    if(zone.gpuStartQuery.has_value())
+      zone.gpuStart = frame.queries.at(*zone.gpuStartQuery).getTimestamp();
+    if(zone.gpuEndQuery.has_value())
+      zone.gpuEnd = frame.queries.at(*zone.gpuEndQuery).getTimestamp();
+  }
+  frame.resolved = true;
+  return true;
+}
+
+void Profiler::writeChromeTrace(const std::filesystem::path& path)
+{
+  std::ofstream out{path, std::ios::out | std::ios::trunc};
+  if(!out.is_open())
+  {
+    BOOST_LOG_TRIVIAL(error) << "Failed to open " << path << " for writing";
+    return;
+  }
+
+  out << R"({"displayTimeUnit":"ms","traceEvents":[)" << "\n";
+  out << R"({"name":"thread_name","ph":"M","pid":0,"tid":0,"args":{"name":"CPU"}},)" << "\n";
+  out << R"({"name":"thread_name","ph":"M","pid":0,"tid":1,"args":{"name":"GPU"}})";
+  bool first = false;
+
+  const auto toTraceTime = [this](const Clock::time_point& t)
+  {
+    return Micros{t - m_epoch}.count();
+  };
+
+  const auto firstSerial = m_currentSerial >= FrameHistory ? m_currentSerial - FrameHistory + 1 : 0;
+  for(auto serial = firstSerial; serial < m_currentSerial; ++serial)
+  {
+    const auto frame = findFrame(serial);
+    if(frame == nullptr)
+      continue;
+
+    resolve(*frame, true);
+
+    const auto frameStart = toTraceTime(frame->cpuStart);
+    writeEvent(out,
+               first,
+               "frame " + std::to_string(serial),
+               frameStart,
+               Micros{frame->cpuEnd - frame->cpuStart}.count(),
+               0);
+
+    for(const auto& zone : frame->zones)
+    {
+      writeEvent(out, first, zone.name, toTraceTime(zone.cpuStart), Micros{zone.cpuEnd - zone.cpuStart}.count(), 0);
+
+      if(!zone.gpuStart.has_value() || !zone.gpuEnd.has_value())
+        continue;
+
+      // map GPU time onto the CPU timeline using the GPU timestamp taken at the start of the frame
+      const auto gpuStart = static_cast<double>(static_cast<int64_t>(*zone.gpuStart) - frame->gpuCalibration) / 1000.0;
+      const auto gpuDuration = static_cast<double>(static_cast<int64_t>(*zone.gpuEnd - *zone.gpuStart)) / 1000.0;
+      writeEvent(out, first, zone.name, frameStart + gpuStart, gpuDuration, 1);
+    }
+  }
+
+  out << "\n]}\n";
+  BOOST_LOG_TRIVIAL(info) << "Wrote profiler trace to " << path;
+}
+} // namespace engine
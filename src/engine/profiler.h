@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <gl/timerquery.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+/**
+ * @brief Collects nested CPU and GPU timing zones of the most recent frames.
+ *
+ * There is at most one active profiler, which is owned by the presenter; zones created while no profiler exists
+ * are no-ops. GPU zones are measured with timestamp queries, which are resolved a few frames later to avoid
+ * stalling the pipeline.
+ */
+class Profiler final
+{
+public:
+  using Clock = std::chrono::high_resolution_clock;
+  static constexpr size_t FrameHistory = 300;
+
+  struct ZoneHandle
+  {
+    size_t frameSerial;
+    size_t zoneIndex;
+  };
+
+  explicit Profiler();
+  ~Profiler();
+
+  Profiler(const Profiler&) = delete;
+  Profiler(Profiler&&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+  Profiler& operator=(Profiler&&) = delete;
+
+  [[nodiscard]] static Profiler* getActive() noexcept
+  {
+    return s_active;
+  }
+
+  //! Closes the current frame and starts recording the next one.
+  void nextFrame();
+
+  [[nodiscard]] ZoneHandle beginZone(std::string name, bool gpu);
+  void endZone(const ZoneHandle& handle);
+
+  //! Writes all recorded frames in the Chrome trace event format, viewable in chrome://tracing or Perfetto.
+  void writeChromeTrace(const std::filesystem::path& path);
+
+  class Zone final
+  {
+  public:
+    explicit Zone(std::string name, bool gpu = false)
+    {
+      if(const auto profiler = getActive())
+        m_handle = profiler->beginZone(std::move(name), gpu);
+    }
+
+    Zone(const Zone&) = delete;
+    Zone(Zone&&) = delete;
+    Zone& operator=(const Zone&) = delete;
+    Zone& operator=(Zone&&) = delete;
+
+    ~Zone()
+    {
+      if(const auto profiler = getActive(); profiler != nullptr && m_handle.has_value())
+        profiler->endZone(*m_handle);
+    }
+
+  private:
+    std::optional<ZoneHandle> m_handle;
+  };
+
+private:
+  struct ZoneRecord
+  {
+    std::string name;
+    Clock::time_point cpuStart;
+    Clock::time_point cpuEnd;
+    std::optional<size_t> gpuStartQuery{};
+    std::optional<size_t> gpuEndQuery{};
+    std::optional<uint64_t> gpuStart{};
+    std::optional<uint64_t> gpuEnd{};
+  };
+
+  struct FrameRecord
+  {
+    std::optional<size_t> serial{};
+    Clock::time_point cpuStart{};
+    Clock::time_point cpuEnd{};
+    int64_t gpuCalibration = 0;
+    std::vector<ZoneRecord> zones{};
+    std::vector<gl::TimestampQuery> queries{};
+    size_t usedQueries = 0;
+    bool resolved = true;
+  };
+
+  static Profiler* s_active;
+
+  const Clock::time_point m_epoch;
+  std::vector<FrameRecord> m_frames;
+  size_t m_currentSerial = 0;
+
+  FrameRecord* findFrame(size_t serial);
+  size_t recordGpuTimestamp(FrameRecord& frame);
+  static bool resolve(FrameRecord& frame, bool wait);
+  void startFrame();
+};
+} // namespace engine
+
+// NOLINTNEXTLINE(bugprone-reserved-identifier)
+#define _ENGINE_PROFILE_PASTE(x, y) x##y
+// NOLINTNEXTLINE(bugprone-reserved-identifier)
+#define _ENGINE_PROFILE_CAT(x, y) _ENGINE_PROFILE_PASTE(x, y)
+
+#define ENGINE_PROFILE_ZONE(name) \
+  [[maybe_unused]] const ::engine::Profiler::Zone _ENGINE_PROFILE_CAT(_engine_profile_zone_, __LINE__){name, false}
+
+#define ENGINE_PROFILE_GPU_ZONE(name) \
+  [[maybe_unused]] const ::engine::Profiler::Zone _ENGINE_PROFILE_CAT(_engine_profile_zone_, __LINE__){name, true}
@@ -0,0 +1,155 @@
+#include "roomobjectindex.h"
+
+#include "core/vec.h"
+#include "objects/object.h"
+#include "world/room.h"
+
+#include <algorithm>
+#include <boost/throw_exception.hpp>
+#include <limits>
+#include <queue>
+
+namespace engine
+{
+namespace
+{
+float getDistanceToPortal(const glm::vec3& position, const world::Room& room, const world::Portal& portal)
+{
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+  for(const auto& vertex : portal.vertices)
+  {
+    min = glm::min(min, vertex);
+    max = glm::max(max, vertex);
+  }
+
+  const auto roomPosition = room.position.toRenderSystem();
+  return glm::distance(position, glm::clamp(position, min + roomPosition, max + roomPosition));
+}
+} // namespace
+
+void RoomObjectIndex::insert(const gsl::not_null<objects::Object*>& object, uint64_t sequence)
+{
+  Expects(!contains(object.get()));
+
+  const world::Room* room = object->m_state.position.room;
+  m_rooms.emplace(object.get(), IndexedObject{room, sequence});
+
+  auto& entries = m_objectsByRoom[room];
+  const auto it = std::upper_bound(entries.begin(),
+                                   entries.end(),
+                                   sequence,
+                                   [](uint64_t seq, const Entry& entry) { return seq < entry.sequence; });
+  entries.insert(it, Entry{sequence, object});
+}
+
+void RoomObjectIndex::update(const gsl::not_null<objects::Object*>& object)
+{
+  const auto it = m_rooms.find(object.get());
+  if(it == m_rooms.end() || it->second.room == object->m_state.position.room)
+    return;
+
+  const auto indexed = it->second;
+  eraseFromRoom(object.get(), indexed);
+  m_rooms.erase(it);
+  insert(object, indexed.sequence);
+}
+
+void RoomObjectIndex::erase(const objects::Object* object)
+{
+  const auto it = m_rooms.find(object);
+  if(it == m_rooms.end())
+    return;
+
+  eraseFromRoom(object, it->second);
+  m_rooms.erase(it);
+}
+
+void RoomObjectIndex::eraseFromRoom(const objects::Object* object, const IndexedObject& indexed)
+{
+  auto& entries = m_objectsByRoom[indexed.room];
+  entries.erase(std::remove_if(entries.begin(),
+                               entries.end(),
+                               [object](const Entry& entry) { return entry.object.get() == object; }),
+                entries.end());
+}
+
+void RoomObjectIndex::clear()
+{
+  m_objectsByRoom.clear();
+  m_rooms.clear();
+}
+
+uint64_t RoomObjectIndex::getSequence(const objects::Object& object) const
+{
+  const auto it = m_rooms.find(&object);
+  if(it == m_rooms.end())
+    BOOST_THROW_EXCEPTION(std::out_of_range("Object is not indexed"));
+
+  return it->second.sequence;
+}
+
+const std::vector<RoomObjectIndex::Entry>& RoomObjectIndex::getObjects(const world::Room* room) const
+{
+  static const std::vector<Entry> empty{};
+
+  const auto it = m_objectsByRoom.find(room);
+  if(it == m_objectsByRoom.end())
+    return empty;
+
+  return it->second;
+}
+
+std::vector<RoomObjectIndex::Entry> RoomObjectIndex::getObjects(const RoomSet& rooms) const
+{
+  std::vector<Entry> result;
+  for(const auto& room : rooms)
+  {
+    const auto& entries = getObjects(room.get());
+    result.insert(result.end(), entries.begin(), entries.end());
+  }
+
+  std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) { return a.sequence < b.sequence; });
+  return result;
+}
+
+std::vector<RoomObjectIndex::Entry> RoomObjectIndex::getObjects(const core::RoomBoundPosition& center,
+                                                                const core::Length& radius) const
+{
+  auto result = getObjects(collectRooms(center, radius));
+  const auto isOutside = [&center, &radius](const Entry& entry)
+  { return entry.object->m_state.position.position.distanceTo(center.position) >= radius; };
+  result.erase(std::remove_if(result.begin(), result.end(), isOutside), result.end());
+  return result;
+}
+
+RoomObjectIndex::RoomSet RoomObjectIndex::collectRooms(const core::RoomBoundPosition& center,
+                                                       const core::Length& radius)
+{
+  const auto position = center.position.toRenderSystem();
+  const auto maxDistance = radius.get<float>();
+
+  RoomSet rooms{center.room};
+  std::queue<gsl::not_null<const world::Room*>> pending;
+  pending.emplace(center.room);
+  while(!pending.empty())
+  {
+    const auto room = pending.front();
+    pending.pop();
+
+    for(const auto& portal : room->portals)
+    {
+      if(rooms.count(portal.adjoiningRoom) != 0)
+        continue;
+
+      if(getDistanceToPortal(position, *room, portal) >= maxDistance)
+        continue;
+
+      rooms.emplace(portal.adjoiningRoom);
+      pending.emplace(portal.adjoiningRoom);
+    }
+  }
+
+  return rooms;
+}
+} // namespace engine
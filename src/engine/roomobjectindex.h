@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/units.h"
+
+#include <cstdint>
+#include <gsl/gsl-lite.hpp>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace core
+{
+struct RoomBoundPosition;
+}
+
+namespace engine::world
+{
+struct Room;
+}
+
+namespace engine
+{
+namespace objects
+{
+class Object;
+}
+
+/**
+ * @brief Maps rooms to the objects they contain.
+ *
+ * Must be kept up to date whenever an object changes its room; this is done by objects::Object::setCurrentRoom().
+ * All queries return the objects in their update order, as defined by the sequence given when inserting them.
+ */
+class RoomObjectIndex final
+{
+public:
+  struct Entry
+  {
+    //! The update order of the object.
+    uint64_t sequence;
+    gsl::not_null<objects::Object*> object;
+  };
+
+  using RoomSet = std::set<gsl::not_null<const world::Room*>>;
+
+  //! Indexes the object in its current room; @a sequence defines the update order of the object.
+  void insert(const gsl::not_null<objects::Object*>& object, uint64_t sequence);
+  //! Moves the object to its current room; no-op if the object is not indexed.
+  void update(const gsl::not_null<objects::Object*>& object);
+  void erase(const objects::Object* object);
+  void clear();
+
+  [[nodiscard]] bool contains(const objects::Object* object) const
+  {
+    return m_rooms.count(object) != 0;
+  }
+
+  //! Returns the sequence of an indexed object.
+  [[nodiscard]] uint64_t getSequence(const objects::Object& object) const;
+
+  [[nodiscard]] const std::vector<Entry>& getObjects(const world::Room* room) const;
+  [[nodiscard]] std::vector<Entry> getObjects(const RoomSet& rooms) const;
+  /**
+   * @brief Returns all objects closer than @a radius to @a center.
+   *
+   * Only rooms reachable from the center's room through portals within the radius are considered.
+   */
+  [[nodiscard]] std::vector<Entry> getObjects(const core::RoomBoundPosition& center, const core::Length& radius) const;
+
+  //! Collects the room of @a center and all rooms reachable through portals closer than @a radius.
+  [[nodiscard]] static RoomSet collectRooms(const core::RoomBoundPosition& center, const core::Length& radius);
+
+private:
+  struct IndexedObject
+  {
+    const world::Room* room;
+    uint64_t sequence;
+  };
+
+  std::unordered_map<const world::Room*, std::vector<Entry>> m_objectsByRoom;
+  std::unordered_map<const objects::Object*, IndexedObject> m_rooms;
+
+  void eraseFromRoom(const objects::Object* object, const IndexedObject& indexed);
+};
+} // namespace engine
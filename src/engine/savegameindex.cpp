@@ -0,0 +1,57 @@
+#include "savegameindex.h"
+
+#include "serialization/serialization.h"
+#include "serialization/yamldocument.h"
+
+#include <boost/log/trivial.hpp>
+#include <system_error>
+
+namespace engine
+{
+namespace
+{
+SavegameMeta readMeta(const std::filesystem::path& path, const std::filesystem::file_time_type& saveTime)
+{
+  // the sidecar is written after the savegame, so an older one belongs to a previous savegame
+  std::error_code ec;
+  const auto metaPath = SavegameIndex::getMetaPath(path);
+  if(const auto metaTime = std::filesystem::last_write_time(metaPath, ec); !ec && metaTime >= saveTime)
+  {
+    serialization::YAMLDocument<true> doc{metaPath};
+    SavegameMeta meta{};
+    doc.load("meta", meta, meta);
+    return meta;
+  }
+
+  BOOST_LOG_TRIVIAL(debug) << "No meta data file for " << path << ", reading savegame";
+  serialization::YAMLDocument<true> doc{path};
+  SavegameMeta meta{};
+  doc.load("meta", meta, meta);
+  return meta;
+}
+} // namespace
+
+std::optional<SavegameInfo> SavegameIndex::get(const std::filesystem::path& path)
+{
+  if(!std::filesystem::is_regular_file(path))
+  {
+    m_entries.erase(path);
+    return std::nullopt;
+  }
+
+  const auto saveTime = std::filesystem::last_write_time(path);
+  if(const auto it = m_entries.find(path); it != m_entries.end() && it->second.saveTime == saveTime)
+    return it->second;
+
+  SavegameInfo info{readMeta(path, saveTime), saveTime};
+  m_entries.insert_or_assign(path, info);
+  return info;
+}
+
+std::filesystem::path SavegameIndex::getMetaPath(const std::filesystem::path& path)
+{
+  auto metaPath = path;
+  metaPath += ".meta";
+  return metaPath;
+}
+} // namespace engine
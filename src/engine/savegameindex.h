@@ -0,0 +1,29 @@
+#pragma once
+
+#include "engine.h"
+
+#include <filesystem>
+#include <map>
+#include <optional>
+
+namespace engine
+{
+/**
+ * @brief Caches the meta data of savegames, so listing them doesn't need to read the savegames themselves.
+ *
+ * Each savegame has a small sidecar file containing only its meta data. Cached entries are invalidated when the
+ * modification time of their savegame changes.
+ */
+class SavegameIndex final
+{
+public:
+  //! Returns the meta data of the savegame at @a path, or nothing if it doesn't exist.
+  [[nodiscard]] std::optional<SavegameInfo> get(const std::filesystem::path& path);
+
+  //! The path of the file containing the meta data of the savegame at @a path.
+  [[nodiscard]] static std::filesystem::path getMetaPath(const std::filesystem::path& path);
+
+private:
+  std::map<std::filesystem::path, SavegameInfo> m_entries;
+};
+} // namespace engine
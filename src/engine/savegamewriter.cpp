@@ -0,0 +1,117 @@
+#include "savegamewriter.h"
+
+#include "serialization/binarytree.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/throw_exception.hpp>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace engine
+{
+SavegameWriter::SavegameWriter()
+    : m_thread{&SavegameWriter::run, this}
+{
+}
+
+SavegameWriter::~SavegameWriter()
+{
+  {
+    std::unique_lock lock{m_mutex};
+    m_stop = true;
+  }
+  m_jobAvailable.notify_all();
+  m_thread.join();
+}
+
+void SavegameWriter::write(const std::filesystem::path& path, serialization::SavedTree&& tree, bool binary)
+{
+  {
+    std::unique_lock lock{m_mutex};
+    m_jobs.emplace_back(Job{path, std::move(tree), binary});
+  }
+  m_jobAvailable.notify_one();
+}
+
+bool SavegameWriter::wait()
+{
+  std::unique_lock lock{m_mutex};
+  m_jobDone.wait(lock, [this]() { return m_jobs.empty() && !m_busy; });
+  return m_failures.empty();
+}
+
+std::vector<std::filesystem::path> SavegameWriter::takeFailures()
+{
+  std::unique_lock lock{m_mutex};
+  return std::exchange(m_failures, {});
+}
+
+void SavegameWriter::run()
+{
+  while(true)
+  {
+    Job job;
+    {
+      std::unique_lock lock{m_mutex};
+      m_jobAvailable.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+      // pending writes are still processed when stopping, so no savegame is lost on exit
+      if(m_jobs.empty())
+        return;
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+      m_busy = true;
+    }
+
+    bool failed = false;
+    try
+    {
+      process(job);
+    }
+    catch(const std::exception& ex)
+    {
+      BOOST_LOG_TRIVIAL(error) << "Failed to write savegame " << job.path << ": " << ex.what();
+      failed = true;
+    }
+
+    {
+      std::unique_lock lock{m_mutex};
+      if(failed)
+        m_failures.emplace_back(job.path);
+      m_busy = false;
+    }
+    m_jobDone.notify_all();
+  }
+}
+
+void SavegameWriter::process(Job& job)
+{
+  const auto tree = std::move(job.tree).finish();
+
+  auto tmpPath = job.path;
+  tmpPath += ".tmp";
+
+  {
+    std::ofstream file{tmpPath, std::ios::out | std::ios::trunc | std::ios::binary};
+    if(!file.is_open())
+      BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open " + tmpPath.string()));
+
+    if(job.binary)
+    {
+      const auto data = serialization::encodeBinaryTree(tree);
+      file.write(reinterpret_cast<const char*>(data.data()), // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                 static_cast<std::streamsize>(data.size()));
+    }
+    else
+    {
+      file << tree.rootref();
+    }
+
+    if(!file.good())
+      BOOST_THROW_EXCEPTION(std::runtime_error("Failed to write " + tmpPath.string()));
+  }
+
+  std::filesystem::rename(tmpPath, job.path);
+  BOOST_LOG_TRIVIAL(info) << "Saved " << job.path;
+}
+} // namespace engine
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "serialization/yamldocument.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine
+{
+/**
+ * @brief Writes serialized savegames on a background thread.
+ *
+ * The deferred nodes of a saved tree are filled on the background thread, too. Each file is written to a temporary
+ * file first, which then replaces the target, so a savegame is never left partially written. Writes are processed in
+ * the order they were queued.
+ */
+class SavegameWriter final
+{
+public:
+  SavegameWriter();
+  //! Finishes all pending writes.
+  ~SavegameWriter();
+
+  SavegameWriter(const SavegameWriter&) = delete;
+  SavegameWriter(SavegameWriter&&) = delete;
+  SavegameWriter& operator=(const SavegameWriter&) = delete;
+  SavegameWriter& operator=(SavegameWriter&&) = delete;
+
+  //! Queues @a tree to be written to @a path, either in the binary format or as YAML.
+  void write(const std::filesystem::path& path, serialization::SavedTree&& tree, bool binary);
+
+  /**
+   * @brief Blocks until all pending writes have finished, so their files can be read.
+   * @returns false if a write failed since the last call to takeFailures().
+   */
+  bool wait();
+
+  //! Returns the files that could not be written since the last call, without waiting for pending writes.
+  [[nodiscard]] std::vector<std::filesystem::path> takeFailures();
+
+private:
+  struct Job
+  {
+    std::filesystem::path path;
+    serialization::SavedTree tree;
+    bool binary = false;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_jobAvailable;
+  std::condition_variable m_jobDone;
+  std::deque<Job> m_jobs;
+  std::vector<std::filesystem::path> m_failures;
+  bool m_busy = false;
+  bool m_stop = false;
+  std::thread m_thread;
+
+  void run();
+  static void process(Job& job);
+};
+} // namespace engine
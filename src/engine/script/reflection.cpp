@@ -139,6 +139,8 @@ std::pair<RunResult, std::optional<size_t>> Level::run(Engine& engine, const std
   player->requestedWeaponType = m_defaultWeapon;
   player->selectedWeaponType = m_defaultWeapon;
   auto world = loadWorld(engine, player);
+  if(m_allowSave)
+    world->capturePristineState();
   return engine.run(*world, false, m_allowSave);
 }
 
@@ -148,6 +150,7 @@ std::pair<RunResult, std::optional<size_t>>
   Expects(m_allowSave);
   player->getInventory().clear();
   auto world = loadWorld(engine, player);
+  world->capturePristineState();
   world->load(slot);
   return engine.run(*world, false, m_allowSave);
 }
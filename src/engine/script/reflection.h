@@ -76,10 +76,9 @@ private:
   const bool m_allowSave;
   const WeaponType m_defaultWeapon;
 
-protected:
+public:
   [[nodiscard]] std::unique_ptr<world::World> loadWorld(Engine& engine, const std::shared_ptr<Player>& player);
 
-public:
   explicit Level(std::string name,
                  size_t secrets,
                  bool useAlternativeLara,
@@ -108,6 +107,11 @@ public:
     runFromSave(Engine& engine, const std::optional<size_t>& slot, const std::shared_ptr<Player>& player) override;
 
   [[nodiscard]] bool isLevel(const std::filesystem::path& path) const override;
+
+  [[nodiscard]] const std::string& getName() const
+  {
+    return m_name;
+  }
 };
 
 class TitleMenu : public Level
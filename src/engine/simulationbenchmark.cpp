@@ -0,0 +1,276 @@
+#include "simulationbenchmark.h"
+
+#include "audio/soundengine.h"
+#include "cameracontroller.h"
+#include "engine.h"
+#include "hid/inputhandler.h"
+#include "objects/laraobject.h"
+#include "player.h"
+#include "presenter.h"
+#include "profiler.h"
+#include "script/reflection.h"
+#include "serialization/binarytree.h"
+#include "util/helpers.h"
+#include "world/world.h"
+
+#include <algorithm>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/log/trivial.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <pybind11/embed.h>
+#include <sstream>
+
+namespace engine
+{
+namespace
+{
+using Clock = std::chrono::high_resolution_clock;
+using Micros = std::chrono::duration<double, std::micro>;
+
+struct InputStep
+{
+  size_t ticks = 0;
+  boost::container::flat_map<hid::Action, bool> actions{};
+};
+
+std::vector<InputStep> loadInputScript(const std::filesystem::path& path)
+{
+  std::ifstream file{util::ensureFileExists(path)};
+  std::vector<InputStep> steps;
+  std::string line;
+  while(std::getline(file, line))
+  {
+    if(const auto comment = line.find('#'); comment != std::string::npos)
+      line.erase(comment);
+    boost::algorithm::trim(line);
+    if(line.empty())
+      continue;
+
+    std::istringstream tokens{line};
+    InputStep step;
+    if(!(tokens >> step.ticks) || step.ticks == 0)
+      BOOST_THROW_EXCEPTION(std::runtime_error("Invalid tick count in input script line: " + line));
+
+    for(const auto& [action, _] : hid::EnumUtil<hid::Action>::all())
+      step.actions[action] = false;
+
+    std::string actionName;
+    while(tokens >> actionName)
+      step.actions[hid::EnumUtil<hid::Action>::fromString(actionName)] = true;
+
+    steps.emplace_back(std::move(step));
+  }
+
+  return steps;
+}
+
+script::Level* findLevel(const std::string& name)
+{
+  const auto matches = [&name](const pybind11::handle& handle) -> script::Level*
+  {
+    auto level = dynamic_cast<script::Level*>(handle.cast<script::LevelSequenceItem*>());
+    if(level == nullptr || level->getName() != name)
+      return nullptr;
+    return level;
+  };
+
+  for(const auto& item : pybind11::globals()["level_sequence"])
+  {
+    if(const auto level = matches(item))
+      return level;
+  }
+
+  if(const auto level = matches(pybind11::globals()["lara_home"]))
+    return level;
+
+  return nullptr;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+  Expects(!sorted.empty());
+  const auto idx = static_cast<size_t>(std::round(p * static_cast<double>(sorted.size() - 1)));
+  return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+struct TypeCost
+{
+  Clock::duration total{0};
+  size_t calls = 0;
+};
+
+/**
+ * @brief Updates the world twice from its current state, once with the creature path searches prepared in parallel
+ *        and once without, and returns whether both updates end in the same state.
+ *
+ * The world is left in the state of the update with prepared path searches.
+ */
+bool updateAndVerifyPathSearches(world::World& world, Player& player, size_t tick)
+{
+  // the player's copy of Lara's health is only updated when presenting a frame, but it's applied when loading a state
+  player.laraHealth = world.getObjectManager().getLara().m_state.health;
+  const auto initialState = world.captureState();
+
+  const auto updateFrom = [&world, &initialState, tick](bool preparePathSearches)
+  {
+    world.restoreState(*initialState);
+    world.getObjectManager().setPreparePathSearches(preparePathSearches);
+    // NOLINTNEXTLINE(cert-msc51-cpp)
+    std::srand(gsl::narrow_cast<unsigned int>(tick));
+    world.update(false);
+    return serialization::encodeBinaryTree(*world.captureState());
+  };
+
+  const auto serialState = updateFrom(false);
+  return updateFrom(true) == serialState;
+}
+
+void logDistribution(const std::string& title, std::vector<double> samples)
+{
+  if(samples.empty())
+    return;
+
+  std::sort(samples.begin(), samples.end());
+  const auto mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+  BOOST_LOG_TRIVIAL(info) << title << " [us]: mean " << mean << ", p50 " << percentile(samples, 0.5) << ", p90 "
+                          << percentile(samples, 0.9) << ", p99 " << percentile(samples, 0.99) << ", max "
+                          << samples.back();
+}
+} // namespace
+
+int runSimulationBenchmark(Engine& engine, const SimulationBenchmarkOptions& options)
+{
+  const auto level = findLevel(options.level);
+  if(level == nullptr)
+  {
+    BOOST_LOG_TRIVIAL(error) << "Level " << options.level << " not found in the level sequence";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<InputStep> inputSteps;
+  if(options.inputScript.has_value())
+    inputSteps = loadInputScript(*options.inputScript);
+
+  auto player = std::make_shared<Player>();
+  auto world = level->loadWorld(engine, player);
+  world->getObjectManager().getLara().m_state.health = player->laraHealth;
+  world->getObjectManager().getLara().initWeaponAnimData();
+
+  std::map<core::TypeId, TypeCost> typeCosts;
+  world->getObjectManager().setUpdateProbe(
+    [&typeCosts](core::TypeId type, Clock::duration duration)
+    {
+      auto& cost = typeCosts[type];
+      cost.total += duration;
+      ++cost.calls;
+    });
+
+  std::vector<double> worldUpdateTimes;
+  std::vector<double> cameraUpdateTimes;
+  worldUpdateTimes.reserve(options.ticks);
+  cameraUpdateTimes.reserve(options.ticks);
+
+  size_t stepIndex = 0;
+  size_t stepTicks = 0;
+  auto& inputHandler = engine.getPresenter().getInputHandler();
+
+  BOOST_LOG_TRIVIAL(info) << "Running " << options.ticks << " simulation ticks of " << options.level;
+  if(options.verifyPathSearches)
+    BOOST_LOG_TRIVIAL(info) << "Verifying prepared path searches against serial ones";
+  for(size_t tick = 0; tick < options.ticks; ++tick)
+  {
+    if(world->levelFinished())
+    {
+      BOOST_LOG_TRIVIAL(info) << "Level finished after " << tick << " ticks";
+      break;
+    }
+
+    if(!inputSteps.empty())
+    {
+      inputHandler.setActionStates(inputSteps[stepIndex].actions);
+      if(++stepTicks >= inputSteps[stepIndex].ticks)
+      {
+        stepTicks = 0;
+        stepIndex = (stepIndex + 1) % inputSteps.size();
+      }
+    }
+
+    const auto start = Clock::now();
+    if(!options.verifyPathSearches)
+    {
+      world->update(false);
+    }
+    else if(!updateAndVerifyPathSearches(*world, *player, tick))
+    {
+      BOOST_LOG_TRIVIAL(error) << "Updates with and without prepared path searches differ in tick " << tick;
+      return EXIT_FAILURE;
+    }
+    const auto worldUpdated = Clock::now();
+    world->getCameraController().update();
+    world->doGlobalEffect();
+    const auto cameraUpdated = Clock::now();
+
+    worldUpdateTimes.emplace_back(Micros{worldUpdated - start}.count());
+    cameraUpdateTimes.emplace_back(Micros{cameraUpdated - worldUpdated}.count());
+
+    // not part of the measurement, but keeps finished voices from piling up
+    engine.getPresenter().getSoundEngine()->update();
+    engine.getPresenter().getProfiler().nextFrame();
+  }
+
+  world->getObjectManager().setUpdateProbe(nullptr);
+
+  logDistribution("World::update", worldUpdateTimes);
+  logDistribution("CameraController::update", cameraUpdateTimes);
+
+  std::vector<std::pair<core::TypeId, TypeCost>> sortedCosts{typeCosts.begin(), typeCosts.end()};
+  std::sort(sortedCosts.begin(),
+            sortedCosts.end(),
+            [](const auto& a, const auto& b) { return a.second.total > b.second.total; });
+
+  const auto typeName = [](const core::TypeId& type) -> std::string
+  {
+    if(const auto name = toString(type.get_as<TR1ItemId>()))
+      return name;
+    return std::to_string(type.get());
+  };
+
+  for(const auto& [type, cost] : sortedCosts)
+  {
+    const auto total = Micros{cost.total}.count();
+    BOOST_LOG_TRIVIAL(info) << typeName(type) << ": " << cost.calls << " updates, total " << total << " us, mean "
+                            << total / static_cast<double>(cost.calls) << " us";
+  }
+
+  if(options.report.has_value())
+  {
+    std::ofstream report{*options.report, std::ios::out | std::ios::trunc};
+    report << "section,name,calls,total_us,mean_us,p50_us,p90_us,p99_us,max_us\n";
+    const auto writeDistribution = [&report](const std::string& name, std::vector<double> samples)
+    {
+      if(samples.empty())
+        return;
+      std::sort(samples.begin(), samples.end());
+      const auto total = std::accumulate(samples.begin(), samples.end(), 0.0);
+      report << "tick," << name << "," << samples.size() << "," << total << ","
+             << total / static_cast<double>(samples.size()) << "," << percentile(samples, 0.5) << ","
+             << percentile(samples, 0.9) << "," << percentile(samples, 0.99) << "," << samples.back() << "\n";
+    };
+    writeDistribution("World::update", worldUpdateTimes);
+    writeDistribution("CameraController::update", cameraUpdateTimes);
+
+    for(const auto& [type, cost] : sortedCosts)
+    {
+      const auto total = Micros{cost.total}.count();
+      report << "object," << typeName(type) << "," << cost.calls << "," << total << ","
+             << total / static_cast<double>(cost.calls) << ",,,,\n";
+    }
+    BOOST_LOG_TRIVIAL(info) << "Wrote benchmark report to " << *options.report;
+  }
+
+  return EXIT_SUCCESS;
+}
+} // namespace engine
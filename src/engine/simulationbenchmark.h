@@ -0,0 +1,34 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace engine
+{
+class Engine;
+
+struct SimulationBenchmarkOptions
+{
+  //! Name of the level as used in the level sequence, e.g. "LEVEL2"
+  std::string level;
+  size_t ticks = 3000;
+  //! Text file with lines of the form "<ticks> [<action>...]"; replayed in a loop if shorter than the benchmark.
+  std::optional<std::filesystem::path> inputScript{};
+  //! Optional CSV output of the collected timings.
+  std::optional<std::filesystem::path> report{};
+  //! Runs every tick twice from the same state, with and without preparing the creature path searches in parallel,
+  //! and fails as soon as the two results differ.
+  bool verifyPathSearches = false;
+};
+
+/**
+ * @brief Loads a level and runs its simulation for a fixed number of ticks without presenting any frames.
+ *
+ * Collects per-tick timings of the world update and the camera update, as well as the accumulated update cost
+ * per object type. Returns the process exit code.
+ *
+ * The timings include the additional work if SimulationBenchmarkOptions::verifyPathSearches is set.
+ */
+int runSimulationBenchmark(Engine& engine, const SimulationBenchmarkOptions& options);
+} // namespace engine
@@ -4,6 +4,7 @@
 #include "engine/presenter.h"
 #include "loader/file/animation.h"
 #include "loader/file/mesh.h"
+#include "render/scene/hizbuffer.h"
 #include "render/scene/mesh.h"
 #include "serialization/glm.h"
 #include "serialization/not_null.h"
@@ -73,6 +74,56 @@ void SkeletalModelNode::updatePose()
   updatePose(getInterpolationInfo());
 }
 
+void SkeletalModelNode::updateBoneParents()
+{
+  m_boneParents.resize(m_model->bones.size());
+  if(m_boneParents.empty())
+    return;
+
+  // replays the matrix stack operations of the original engine, but only tracks which bone is on top of the stack
+  std::vector<size_t> stack;
+  size_t current = 0;
+  m_boneParents[0] = 0;
+  for(size_t i = 1; i < m_model->bones.size(); ++i)
+  {
+    if(m_model->bones[i].popMatrix)
+    {
+      BOOST_ASSERT(!stack.empty());
+      current = stack.back();
+      stack.pop_back();
+    }
+    if(m_model->bones[i].pushMatrix)
+      stack.emplace_back(current);
+
+    m_boneParents[i] = current;
+    current = i;
+  }
+}
+
+const SkeletalModelNode::DecodedFrame& SkeletalModelNode::decodeFrame(const loader::file::AnimFrame* frame,
+                                                                      const loader::file::AnimFrame* keep)
+{
+  for(const auto& decoded : m_decodedFrames)
+  {
+    if(decoded.frame == frame && decoded.rotations.size() == m_model->bones.size())
+      return decoded;
+  }
+
+  auto& decoded = m_decodedFrames[0].frame == keep ? m_decodedFrames[1] : m_decodedFrames[0];
+  decoded.frame = frame;
+  decoded.position = frame->pos.toGl();
+  decoded.rotations.resize(m_model->bones.size());
+  const auto angleData = frame->getAngleData();
+  for(size_t i = 0; i < m_model->bones.size(); ++i)
+  {
+    if(i != 0 && frame->numValues < i)
+      decoded.rotations[i] = glm::quat{1.0f, 0.0f, 0.0f, 0.0f};
+    else
+      decoded.rotations[i] = glm::quat_cast(core::fromPackedAngles(angleData[i]));
+  }
+  return decoded;
+}
+
 void SkeletalModelNode::updatePose(const InterpolationInfo& framePair)
 {
   BOOST_ASSERT(!m_model->bones.empty());
@@ -80,48 +131,50 @@ void SkeletalModelNode::updatePose(const InterpolationInfo& framePair)
   BOOST_ASSERT(framePair.firstFrame->numValues > 0);
   BOOST_ASSERT(framePair.secondFrame->numValues > 0);
 
-  const auto angleDataFirst = framePair.firstFrame->getAngleData();
-  std::stack<glm::mat4> transformsFirst;
-  transformsFirst.push(glm::translate(glm::mat4{1.0f}, framePair.firstFrame->pos.toGl())
-                       * core::fromPackedAngles(angleDataFirst[0]) * m_meshParts[0].patch);
-
-  const auto angleDataSecond = framePair.secondFrame->getAngleData();
-  std::stack<glm::mat4> transformsSecond;
-  transformsSecond.push(translate(glm::mat4{1.0f}, framePair.secondFrame->pos.toGl())
-                        * core::fromPackedAngles(angleDataSecond[0]) * m_meshParts[0].patch);
+  if(m_boneParentsModel != m_model.get())
+  {
+    updateBoneParents();
+    m_boneParentsModel = m_model.get();
+  }
 
-  m_meshParts[0].matrix = util::mix(transformsFirst.top(), transformsSecond.top(), framePair.bias);
+  const PoseInputs inputs{m_model.get(), framePair.firstFrame.get(), framePair.secondFrame.get(), framePair.bias};
+  if(inputs.model != m_poseInputs.model || inputs.firstFrame != m_poseInputs.firstFrame
+     || inputs.secondFrame != m_poseInputs.secondFrame || inputs.bias != m_poseInputs.bias)
+  {
+    for(size_t i = 0; i < m_model->bones.size(); ++i)
+      m_meshParts[i].poseDirty = true;
+    m_poseInputs = inputs;
+  }
 
-  if(m_model->bones.size() <= 1)
-    return;
+  const auto& first = decodeFrame(inputs.firstFrame, inputs.secondFrame);
+  const auto& second = decodeFrame(inputs.secondFrame, inputs.firstFrame);
 
-  for(size_t i = 1; i < m_model->bones.size(); ++i)
+  // parents always precede their children, so a changed bone marks its children dirty before they're visited
+  for(size_t i = 0; i < m_model->bones.size(); ++i)
   {
-    if(m_model->bones[i].popMatrix)
+    auto& part = m_meshParts[i];
+    if(i != 0 && m_meshParts[m_boneParents[i]].poseDirty)
+      part.poseDirty = true;
+    if(!part.poseDirty)
+      continue;
+
+    const auto rotation = framePair.bias <= 0 ? first.rotations[i]
+                                              : glm::slerp(first.rotations[i], second.rotations[i], framePair.bias);
+    if(i == 0)
     {
-      transformsFirst.pop();
-      transformsSecond.pop();
+      part.matrix = glm::translate(glm::mat4{1.0f}, glm::mix(first.position, second.position, framePair.bias))
+                    * glm::mat4_cast(rotation) * part.patch;
     }
-    if(m_model->bones[i].pushMatrix)
+    else
     {
-      transformsFirst.push({transformsFirst.top()});   // make sure to have a copy, not a reference
-      transformsSecond.push({transformsSecond.top()}); // make sure to have a copy, not a reference
+      part.matrix = m_meshParts[m_boneParents[i]].matrix
+                    * glm::translate(glm::mat4{1.0f}, m_model->bones[i].position) * glm::mat4_cast(rotation)
+                    * part.patch;
     }
-
-    if(framePair.firstFrame->numValues < i)
-      transformsFirst.top() *= translate(glm::mat4{1.0f}, m_model->bones[i].position) * m_meshParts[i].patch;
-    else
-      transformsFirst.top() *= translate(glm::mat4{1.0f}, m_model->bones[i].position)
-                               * core::fromPackedAngles(angleDataFirst[i]) * m_meshParts[i].patch;
-
-    if(framePair.firstFrame->numValues < i)
-      transformsSecond.top() *= translate(glm::mat4{1.0f}, m_model->bones[i].position) * m_meshParts[i].patch;
-    else
-      transformsSecond.top() *= translate(glm::mat4{1.0f}, m_model->bones[i].position)
-                                * core::fromPackedAngles(angleDataSecond[i]) * m_meshParts[i].patch;
-
-    m_meshParts[i].matrix = util::mix(transformsFirst.top(), transformsSecond.top(), framePair.bias);
   }
+
+  for(size_t i = 0; i < m_model->bones.size(); ++i)
+    m_meshParts[i].poseDirty = false;
 }
 
 loader::file::BoundingBox SkeletalModelNode::getBoundingBox() const
@@ -321,24 +374,33 @@ void SkeletalModelNode::rebuildMesh()
     setRenderable(compositor.toMesh(*m_world->getPresenter().getMaterialManager(), true, getName()));
 }
 
-bool SkeletalModelNode::canBeCulled(const glm::mat4& viewProjection) const
+std::array<glm::vec3, 8> SkeletalModelNode::getBoundingBoxCornersWorld() const
 {
   const auto bbox = getInterpolationInfo().firstFrame->bbox.toBBox();
-  const std::array<glm::vec3, 8> corners{
-    core::TRVec{bbox.maxX, bbox.maxY, bbox.maxZ}.toRenderSystem(),
-    core::TRVec{bbox.maxX, bbox.maxY, bbox.minZ}.toRenderSystem(),
-    core::TRVec{bbox.maxX, bbox.minY, bbox.maxZ}.toRenderSystem(),
-    core::TRVec{bbox.maxX, bbox.minY, bbox.minZ}.toRenderSystem(),
-    core::TRVec{bbox.minX, bbox.maxY, bbox.maxZ}.toRenderSystem(),
-    core::TRVec{bbox.minX, bbox.maxY, bbox.minZ}.toRenderSystem(),
-    core::TRVec{bbox.minX, bbox.minY, bbox.maxZ}.toRenderSystem(),
-    core::TRVec{bbox.minX, bbox.minY, bbox.minZ}.toRenderSystem(),
+  const auto& m = getModelMatrix();
+  const auto toWorld = [&m](const core::TRVec& v) { return glm::vec3{m * glm::vec4{v.toRenderSystem(), 1.0f}}; };
+  return {
+    toWorld(core::TRVec{bbox.maxX, bbox.maxY, bbox.maxZ}),
+    toWorld(core::TRVec{bbox.maxX, bbox.maxY, bbox.minZ}),
+    toWorld(core::TRVec{bbox.maxX, bbox.minY, bbox.maxZ}),
+    toWorld(core::TRVec{bbox.maxX, bbox.minY, bbox.minZ}),
+    toWorld(core::TRVec{bbox.minX, bbox.maxY, bbox.maxZ}),
+    toWorld(core::TRVec{bbox.minX, bbox.maxY, bbox.minZ}),
+    toWorld(core::TRVec{bbox.minX, bbox.minY, bbox.maxZ}),
+    toWorld(core::TRVec{bbox.minX, bbox.minY, bbox.minZ}),
   };
+}
 
+bool SkeletalModelNode::canBeCulled(const glm::mat4& viewProjection) const
+{
   glm::vec2 min{1000.0f}, max{-1000.0f};
-  for(const auto& v : corners)
+  for(const auto& v : getBoundingBoxCornersWorld())
   {
-    auto proj = viewProjection * getModelMatrix() * glm::vec4{v, 1.0f};
+    auto proj = viewProjection * glm::vec4{v, 1.0f};
+    // the projection flips everything behind the camera
+    if(proj.w <= 0)
+      return false;
+
     proj /= proj.w;
     min = glm::min(min, glm::vec2{proj});
     max = glm::max(max, glm::vec2{proj});
@@ -347,6 +409,11 @@ bool SkeletalModelNode::canBeCulled(const glm::mat4& viewProjection) const
   return min.x > 1 || min.y > 1 || max.x < -1 || max.y < -1;
 }
 
+bool SkeletalModelNode::isOccluded(const render::scene::HiZBuffer& hiZBuffer, const float margin) const
+{
+  return hiZBuffer.isOccluded(getBoundingBoxCornersWorld(), margin);
+}
+
 void SkeletalModelNode::setAnim(const gsl::not_null<const world::Animation*>& anim,
                                 const std::optional<core::Frame>& frame)
 {
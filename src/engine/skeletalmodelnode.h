@@ -3,6 +3,9 @@
 #include "loader/file/animation.h"
 #include "render/scene/node.h"
 
+#include <algorithm>
+#include <array>
+#include <glm/gtc/quaternion.hpp>
 #include <gsl/gsl-lite.hpp>
 #include <utility>
 
@@ -39,7 +42,12 @@ public:
 
   void patchBone(const size_t idx, const glm::mat4& m)
   {
-    m_meshParts.at(idx).patch = m;
+    auto& part = m_meshParts.at(idx);
+    if(part.patch == m)
+      return;
+
+    part.patch = m;
+    part.poseDirty = true;
   }
 
   bool advanceFrame(objects::ObjectState& state);
@@ -94,6 +102,8 @@ public:
 
   bool canBeCulled(const glm::mat4& viewProjection) const override;
 
+  bool isOccluded(const render::scene::HiZBuffer& hiZBuffer, float margin) const override;
+
   void setMeshPart(size_t idx, const std::shared_ptr<world::RenderMeshData>& mesh)
   {
     m_meshParts.at(idx).mesh = mesh;
@@ -118,6 +128,13 @@ public:
   void setMeshMatrix(size_t idx, const glm::mat4& m)
   {
     m_meshParts.at(idx).matrix = m;
+    // the matrices don't reflect the evaluated pose anymore
+    m_poseInputs = {};
+  }
+
+  [[nodiscard]] const glm::mat4& getMeshMatrix(size_t idx) const
+  {
+    return m_meshParts.at(idx).matrix;
   }
 
   void setVisible(size_t idx, bool visible)
@@ -130,15 +147,30 @@ public:
     return m_meshParts.at(idx).visible;
   }
 
-  const auto& getMeshMatricesBuffer() const
+  //! Writes the bone matrices to the arena at most once per frame, unless they change in between.
+  [[nodiscard]] const render::scene::FrameArena::Range& getMeshMatricesRange(render::scene::FrameArena& arena) const
   {
-    std::vector<glm::mat4> matrices;
-    std::transform(m_meshParts.begin(),
-                   m_meshParts.end(),
-                   std::back_inserter(matrices),
-                   [](const auto& part) { return part.matrix; });
-    m_meshMatricesBuffer.setData(matrices, gl::api::BufferUsage::DynamicDraw);
-    return m_meshMatricesBuffer;
+    Expects(!m_meshParts.empty());
+
+    const bool changed
+      = !std::equal(m_meshParts.begin(),
+                    m_meshParts.end(),
+                    m_meshMatrices.begin(),
+                    m_meshMatrices.end(),
+                    [](const MeshPart& part, const glm::mat4& matrix) { return part.matrix == matrix; });
+    if(!changed && arena.isValid(m_meshMatricesRange))
+      return m_meshMatricesRange;
+
+    if(changed)
+    {
+      m_meshMatrices.clear();
+      std::transform(m_meshParts.begin(),
+                     m_meshParts.end(),
+                     std::back_inserter(m_meshMatrices),
+                     [](const MeshPart& part) { return part.matrix; });
+    }
+    m_meshMatricesRange = arena.push(m_meshMatrices.data(), m_meshMatrices.size());
+    return m_meshMatricesRange;
   }
 
   void clearParts()
@@ -169,6 +201,9 @@ protected:
   bool handleStateTransitions(core::AnimStateId& animState, const core::AnimStateId& goal);
 
 private:
+  //! The corners of the current animation frame's bounding box in world space.
+  [[nodiscard]] std::array<glm::vec3, 8> getBoundingBoxCornersWorld() const;
+
   struct MeshPart
   {
     explicit MeshPart(std::shared_ptr<world::RenderMeshData> mesh = nullptr)
@@ -182,6 +217,8 @@ private:
     std::shared_ptr<world::RenderMeshData> currentMesh{nullptr};
     bool visible = true;
     bool currentVisible = true;
+    //! Whether the matrix needs to be re-evaluated even if the animation frames didn't change.
+    bool poseDirty = true;
 
     [[nodiscard]] bool meshChanged() const
     {
@@ -195,13 +232,40 @@ private:
   const gsl::not_null<const world::World*> m_world;
   gsl::not_null<const world::SkeletalModelType*> m_model;
   std::vector<MeshPart> m_meshParts{};
-  mutable gl::ShaderStorageBuffer<glm::mat4> m_meshMatricesBuffer{"mesh-matrices-ssb"};
+  //! The bone matrices last written to the frame arena.
+  mutable std::vector<glm::mat4> m_meshMatrices{};
+  mutable render::scene::FrameArena::Range m_meshMatricesRange{};
   bool m_forceMeshRebuild = false;
 
   const world::Animation* m_anim = nullptr;
   core::Frame m_frame = 0_frame;
 
+  //! A keyframe with its bone rotations unpacked, kept as long as it is part of the current frame pair.
+  struct DecodedFrame
+  {
+    const loader::file::AnimFrame* frame = nullptr;
+    glm::vec3 position{0.0f};
+    std::vector<glm::quat> rotations{};
+  };
+
+  //! The inputs the bone matrices were last evaluated from; a null model forces a full evaluation.
+  struct PoseInputs
+  {
+    const world::SkeletalModelType* model = nullptr;
+    const loader::file::AnimFrame* firstFrame = nullptr;
+    const loader::file::AnimFrame* secondFrame = nullptr;
+    float bias = 0;
+  };
+
+  std::array<DecodedFrame, 2> m_decodedFrames{};
+  PoseInputs m_poseInputs{};
+  //! The index of the bone each bone is relative to, resolved from the model's push and pop flags.
+  std::vector<size_t> m_boneParents{};
+  const world::SkeletalModelType* m_boneParentsModel = nullptr;
+
   void updatePose(const InterpolationInfo& framePair);
+  void updateBoneParents();
+  const DecodedFrame& decodeFrame(const loader::file::AnimFrame* frame, const loader::file::AnimFrame* keep);
 };
 
 void serialize(std::shared_ptr<SkeletalModelNode>& data, const serialization::Serializer<world::World>& ser);
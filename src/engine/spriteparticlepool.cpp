@@ -0,0 +1,168 @@
+#include "spriteparticlepool.h"
+
+#include "engine/world/room.h"
+#include "engine/world/sprite.h"
+#include "items_tr1.h"
+#include "lighting.h"
+#include "presenter.h"
+#include "render/scene/materialmanager.h"
+#include "render/scene/mesh.h"
+#include "render/scene/node.h"
+#include "render/scene/sprite.h"
+#include "world/world.h"
+
+#include <boost/log/trivial.hpp>
+#include <gl/vertexbuffer.h>
+
+namespace engine
+{
+SpriteParticlePool::SpriteParticlePool(world::World& world, const core::TypeId type, const core::Frame& frameDuration)
+    : m_frameDuration{frameDuration.get()}
+    , m_node{std::make_shared<render::scene::Node>("sprite-particles-" + std::to_string(type.get()))}
+{
+  Expects(m_frameDuration > 0);
+
+  const auto& sequence = world.findSpriteSequenceForType(type);
+  if(sequence == nullptr)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Missing sprite referenced by particle: "
+                               << toString(static_cast<TR1ItemId>(type.get()));
+    return;
+  }
+
+  m_maxAge = gsl::narrow<int32_t>(sequence->sprites.size()) * m_frameDuration;
+
+  const auto& material = world.getPresenter().getMaterialManager()->getSprite();
+  for(const auto& sprite : sequence->sprites)
+  {
+    const auto label = m_node->getName() + "-" + std::to_string(m_batches.size());
+    auto instanceBuffer = std::make_shared<gl::VertexBuffer<render::scene::SpriteInstance>>(
+      render::scene::SpriteInstance::getLayout(), 1, label + "-instances");
+    auto mesh = render::scene::createInstancedSpriteMesh(static_cast<float>(sprite.render0.x),
+                                                         static_cast<float>(-sprite.render0.y),
+                                                         static_cast<float>(sprite.render1.x),
+                                                         static_cast<float>(-sprite.render1.y),
+                                                         sprite.uv0,
+                                                         sprite.uv1,
+                                                         material,
+                                                         sprite.textureId.get_as<int32_t>(),
+                                                         instanceBuffer,
+                                                         label);
+
+    // same as Particle, which uses a fixed shade that doesn't receive any light from the room's light sources
+    auto node = std::make_shared<render::scene::Node>(label);
+    node->setRenderable(mesh);
+    node->setVisible(false);
+    node->bind("u_lightAmbient",
+               [](const render::scene::Node& /*node*/, const render::scene::Mesh& /*mesh*/, gl::Uniform& uniform)
+               { uniform.set(1.0f); });
+    node->bind("b_lights",
+               [emptyLightsBuffer = ShaderLight::getEmptyBuffer()](const render::scene::Node&,
+                                                                   const render::scene::Mesh& /*mesh*/,
+                                                                   gl::ShaderStorageBlock& shaderStorageBlock)
+               { shaderStorageBlock.bind(*emptyLightsBuffer); });
+    addChild(m_node, node);
+
+    m_batches.emplace_back(SpriteBatch{std::move(instanceBuffer), std::move(mesh), std::move(node), {}});
+  }
+}
+
+SpriteParticlePool::~SpriteParticlePool() = default;
+
+void SpriteParticlePool::spawn(const core::RoomBoundPosition& pos, const core::TRVec& velocity)
+{
+  if(m_maxAge == 0)
+    return;
+
+  m_x.emplace_back(pos.position.X.get());
+  m_y.emplace_back(pos.position.Y.get());
+  m_z.emplace_back(pos.position.Z.get());
+  m_velocityX.emplace_back(velocity.X.get());
+  m_velocityY.emplace_back(velocity.Y.get());
+  m_velocityZ.emplace_back(velocity.Z.get());
+  m_ages.emplace_back(0);
+  m_rooms.emplace_back(pos.room.get());
+}
+
+void SpriteParticlePool::update()
+{
+  for(size_t i = 0; i < m_ages.size(); ++i)
+  {
+    m_x[i] += m_velocityX[i];
+    m_y[i] += m_velocityY[i];
+    m_z[i] += m_velocityZ[i];
+    ++m_ages[i];
+  }
+
+  for(size_t i = 0; i < m_ages.size();)
+  {
+    if(m_ages[i] < m_maxAge)
+    {
+      ++i;
+      continue;
+    }
+
+    m_x[i] = m_x.back();
+    m_y[i] = m_y.back();
+    m_z[i] = m_z.back();
+    m_velocityX[i] = m_velocityX.back();
+    m_velocityY[i] = m_velocityY.back();
+    m_velocityZ[i] = m_velocityZ.back();
+    m_ages[i] = m_ages.back();
+    m_rooms[i] = m_rooms.back();
+
+    m_x.pop_back();
+    m_y.pop_back();
+    m_z.pop_back();
+    m_velocityX.pop_back();
+    m_velocityY.pop_back();
+    m_velocityZ.pop_back();
+    m_ages.pop_back();
+    m_rooms.pop_back();
+  }
+}
+
+void SpriteParticlePool::clear()
+{
+  m_x.clear();
+  m_y.clear();
+  m_z.clear();
+  m_velocityX.clear();
+  m_velocityY.clear();
+  m_velocityZ.clear();
+  m_ages.clear();
+  m_rooms.clear();
+}
+
+void SpriteParticlePool::updateInstances()
+{
+  for(auto& batch : m_batches)
+    batch.instances.clear();
+
+  const auto lag = 1 - m_interpolationBias;
+  for(size_t i = 0; i < m_ages.size(); ++i)
+  {
+    if(!m_rooms[i]->node->isVisible())
+      continue;
+
+    glm::vec3 position{m_x[i], m_y[i], m_z[i]};
+    // particles spawned during the last tick haven't been visible before, so there's nothing to blend from
+    if(m_ages[i] > 1)
+      position -= lag * glm::vec3{m_velocityX[i], m_velocityY[i], m_velocityZ[i]};
+
+    // same as core::TRVec::toRenderSystem()
+    m_batches.at(m_ages[i] / m_frameDuration).instances.emplace_back(
+      render::scene::SpriteInstance{glm::vec3{position.x, -position.y, -position.z}});
+  }
+
+  for(auto& batch : m_batches)
+  {
+    batch.node->setVisible(!batch.instances.empty());
+    if(batch.instances.empty())
+      continue;
+
+    batch.instanceBuffer->setData(batch.instances, gl::api::BufferUsage::StreamDraw);
+    batch.mesh->setInstanceCount(gsl::narrow<gl::api::core::SizeType>(batch.instances.size()));
+  }
+}
+} // namespace engine
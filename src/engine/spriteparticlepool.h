@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core/id.h"
+#include "core/units.h"
+#include "core/vec.h"
+
+#include <cstdint>
+#include <gl/soglb_fwd.h>
+#include <gsl/gsl-lite.hpp>
+#include <memory>
+#include <vector>
+
+namespace render::scene
+{
+class Mesh;
+class Node;
+struct SpriteInstance;
+} // namespace render::scene
+
+namespace engine::world
+{
+class World;
+struct Room;
+} // namespace engine::world
+
+namespace engine
+{
+/**
+ * @brief Short-lived sprite particles of a single type that only move in a straight line, e.g. blood splatters.
+ *
+ * The particles are stored as a structure of arrays and advanced by a single loop over plain integers. Expired
+ * particles are replaced by the last one, so spawning and expiring only allocate until the arrays have grown to the
+ * peak particle count. All particles showing the same sprite are drawn with one instanced draw call.
+ */
+class SpriteParticlePool final
+{
+public:
+  explicit SpriteParticlePool(world::World& world, core::TypeId type, const core::Frame& frameDuration);
+  ~SpriteParticlePool();
+
+  SpriteParticlePool(const SpriteParticlePool&) = delete;
+  SpriteParticlePool(SpriteParticlePool&&) = delete;
+  SpriteParticlePool& operator=(const SpriteParticlePool&) = delete;
+  SpriteParticlePool& operator=(SpriteParticlePool&&) = delete;
+
+  //! @a velocity is the distance travelled per tick.
+  void spawn(const core::RoomBoundPosition& pos, const core::TRVec& velocity);
+
+  //! Advances all particles by one tick, and removes the ones that have shown their last sprite.
+  void update();
+
+  void clear();
+
+  //! The position of particles that moved during the last tick is blended by @a bias, see FrameInterpolator.
+  void setInterpolationBias(float bias)
+  {
+    m_interpolationBias = bias;
+  }
+
+  //! Uploads the instances of all particles in visible rooms for the next draw of getNode().
+  void updateInstances();
+
+  [[nodiscard]] const auto& getNode() const
+  {
+    return m_node;
+  }
+
+  [[nodiscard]] size_t size() const noexcept
+  {
+    return m_ages.size();
+  }
+
+private:
+  struct SpriteBatch
+  {
+    gsl::not_null<std::shared_ptr<gl::VertexBuffer<render::scene::SpriteInstance>>> instanceBuffer;
+    gsl::not_null<std::shared_ptr<render::scene::Mesh>> mesh;
+    gsl::not_null<std::shared_ptr<render::scene::Node>> node;
+    std::vector<render::scene::SpriteInstance> instances;
+  };
+
+  const int32_t m_frameDuration;
+  //! Particles expire when reaching this age.
+  int32_t m_maxAge = 0;
+  float m_interpolationBias = 1;
+
+  std::vector<int32_t> m_x;
+  std::vector<int32_t> m_y;
+  std::vector<int32_t> m_z;
+  std::vector<int32_t> m_velocityX;
+  std::vector<int32_t> m_velocityY;
+  std::vector<int32_t> m_velocityZ;
+  //! Ticks since the particle was spawned.
+  std::vector<int32_t> m_ages;
+  //! Only used for visibility, particles don't change their rooms.
+  std::vector<const world::Room*> m_rooms;
+
+  //! One per sprite of the sequence.
+  std::vector<SpriteBatch> m_batches;
+  gsl::not_null<std::shared_ptr<render::scene::Node>> m_node;
+};
+} // namespace engine
@@ -2,6 +2,7 @@
 
 #include "core/magic.h"
 
+#include <algorithm>
 #include <chrono>
 #include <numeric>
 #include <thread>
@@ -31,6 +32,21 @@ public:
     m_nextFrameTime += FrameDuration;
   }
 
+  //! Whether the next tick is due, i.e. wait() would return immediately.
+  [[nodiscard]] bool isTickDue() const
+  {
+    return std::chrono::high_resolution_clock::now() >= m_nextFrameTime;
+  }
+
+  //! Time passed since the last tick, relative to the tick duration; clamped to [0, 1].
+  [[nodiscard]] float getTickProgress() const
+  {
+    const auto remaining
+      = std::chrono::duration_cast<TimeType>(m_nextFrameTime - std::chrono::high_resolution_clock::now()).count();
+    return std::clamp(
+      1.0f - static_cast<float>(remaining) / static_cast<float>(FrameDuration.count()), 0.0f, 1.0f);
+  }
+
   void reset()
   {
     m_nextFrameTime = std::chrono::high_resolution_clock::now() + FrameDuration;
@@ -0,0 +1,107 @@
+#include "workerpool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace engine
+{
+WorkerPool::WorkerPool()
+    : WorkerPool{std::max(std::thread::hardware_concurrency(), 1u) - 1u}
+{
+}
+
+WorkerPool::WorkerPool(size_t workerCount)
+{
+  m_workers.reserve(workerCount);
+  for(size_t i = 0; i < workerCount; ++i)
+    m_workers.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::unique_lock lock{m_mutex};
+    m_stop = true;
+  }
+  m_jobAvailable.notify_all();
+
+  for(auto& worker : m_workers)
+    worker.join();
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& fn)
+{
+  if(count == 0)
+    return;
+
+  if(m_workers.empty() || count == 1)
+  {
+    for(size_t i = 0; i < count; ++i)
+      fn(i);
+    return;
+  }
+
+  {
+    std::unique_lock lock{m_mutex};
+    m_job = &fn;
+    m_jobSize = count;
+    m_nextIndex = 0;
+    m_busyWorkers = m_workers.size();
+    m_exception = nullptr;
+    ++m_jobSerial;
+  }
+  m_jobAvailable.notify_all();
+
+  process();
+
+  std::unique_lock lock{m_mutex};
+  m_jobDone.wait(lock, [this]() { return m_busyWorkers == 0; });
+  m_job = nullptr;
+  if(const auto exception = std::exchange(m_exception, nullptr))
+    std::rethrow_exception(exception);
+}
+
+void WorkerPool::run()
+{
+  size_t processedSerial = 0;
+  while(true)
+  {
+    {
+      std::unique_lock lock{m_mutex};
+      m_jobAvailable.wait(lock, [this, processedSerial]() { return m_stop || m_jobSerial != processedSerial; });
+      if(m_stop)
+        return;
+      processedSerial = m_jobSerial;
+    }
+
+    process();
+
+    {
+      std::unique_lock lock{m_mutex};
+      --m_busyWorkers;
+    }
+    m_jobDone.notify_one();
+  }
+}
+
+void WorkerPool::process()
+{
+  while(true)
+  {
+    const auto index = m_nextIndex++;
+    if(index >= m_jobSize)
+      return;
+
+    try
+    {
+      (*m_job)(index);
+    }
+    catch(...)
+    {
+      std::unique_lock lock{m_mutex};
+      if(m_exception == nullptr)
+        m_exception = std::current_exception();
+    }
+  }
+}
+} // namespace engine
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine
+{
+/**
+ * @brief A fixed set of threads to process independent work items in parallel.
+ *
+ * The calling thread takes part in processing, so a pool without any worker threads processes everything serially.
+ */
+class WorkerPool final
+{
+public:
+  //! Creates one worker less than the number of hardware threads, as the calling thread does work, too.
+  WorkerPool();
+  explicit WorkerPool(size_t workerCount);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool& operator=(WorkerPool&&) = delete;
+
+  /**
+   * @brief Calls @a fn for each index in [0, count), and waits until all calls have finished.
+   *
+   * The order of the calls is unspecified. If any call throws, the first exception is re-thrown after all other
+   * calls have finished.
+   */
+  void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+  [[nodiscard]] size_t getWorkerCount() const noexcept
+  {
+    return m_workers.size();
+  }
+
+private:
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_jobAvailable;
+  std::condition_variable m_jobDone;
+  //! Incremented for each job, so workers can tell a new job from the one they already processed.
+  size_t m_jobSerial = 0;
+  const std::function<void(size_t)>* m_job = nullptr;
+  size_t m_jobSize = 0;
+  std::atomic<size_t> m_nextIndex{0};
+  size_t m_busyWorkers = 0;
+  std::exception_ptr m_exception;
+  bool m_stop = false;
+
+  void run();
+  void process();
+};
+} // namespace engine
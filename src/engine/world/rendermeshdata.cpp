@@ -28,51 +28,54 @@ RenderMeshData::RenderMeshData(const loader::file::Mesh& mesh,
                                            quad.vertices[2].from(mesh.vertices).toRenderSystem(),
                                            quad.vertices[3].from(mesh.vertices).toRenderSystem());
 
+    uint16_t quadIndex = 0;
+    if(useQuadHandling)
+    {
+      m_quads.emplace_back(std::array<glm::vec3, 4>{quad.vertices[0].from(mesh.vertices).toRenderSystem(),
+                                                    quad.vertices[1].from(mesh.vertices).toRenderSystem(),
+                                                    quad.vertices[2].from(mesh.vertices).toRenderSystem(),
+                                                    quad.vertices[3].from(mesh.vertices).toRenderSystem()},
+                           tile.uvCoordinates);
+      quadIndex = gsl::narrow<uint16_t>(m_quads.size());
+    }
+
     for(int i = 0; i < 4; ++i)
     {
       RenderVertex iv{};
-      iv.textureIndex = tile.textureKey.tileAndFlag & loader::file::TextureIndexMask;
-      if(useQuadHandling)
-      {
-        iv.isQuad = 1;
-        iv.quadVert1 = quad.vertices[0].from(mesh.vertices).toRenderSystem();
-        iv.quadVert2 = quad.vertices[1].from(mesh.vertices).toRenderSystem();
-        iv.quadVert3 = quad.vertices[2].from(mesh.vertices).toRenderSystem();
-        iv.quadVert4 = quad.vertices[3].from(mesh.vertices).toRenderSystem();
-        iv.quadUv1 = tile.uvCoordinates[0];
-        iv.quadUv2 = tile.uvCoordinates[1];
-        iv.quadUv3 = tile.uvCoordinates[2];
-        iv.quadUv4 = tile.uvCoordinates[3];
-      }
+      iv.textureIndex = gsl::narrow<int16_t>(tile.textureKey.tileAndFlag & loader::file::TextureIndexMask);
+      iv.quadIndex = quadIndex;
 
       if(mesh.normals.empty())
-        iv.color = glm::vec4(glm::vec3{toBrightness(quad.vertices[i].from(mesh.vertex_shades)).get()}, 1.0f);
+        iv.color = render::scene::packColor(
+          glm::vec4(glm::vec3{toBrightness(quad.vertices[i].from(mesh.vertex_shades)).get()}, 1.0f));
 
+      glm::vec3 normal;
       if(mesh.isFlatShaded() || mesh.normals.empty()
          || quad.vertices[i].from(mesh.normals) == core::TRVec{0_len, 0_len, 0_len})
       {
         if(i <= 2)
         {
           static const std::array<int, 3> indices{0, 1, 2};
-          iv.normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
+          normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
         }
         else
         {
           static const std::array<int, 3> indices{0, 2, 3};
-          iv.normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
+          normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
         }
       }
       else
       {
-        iv.normal = quad.vertices[i].from(mesh.normals).toRenderSystem();
+        normal = quad.vertices[i].from(mesh.normals).toRenderSystem();
       }
+      iv.normal = render::scene::packNormal(normal);
 
-      iv.position = quad.vertices[i].from(mesh.vertices).toRenderSystem();
-      iv.uv = tile.uvCoordinates[i];
+      iv.position = render::scene::packPosition(quad.vertices[i].from(mesh.vertices).toRenderSystem());
+      iv.uv = render::scene::packUv(tile.uvCoordinates[i]);
       m_vertices.emplace_back(iv);
     }
 
@@ -90,34 +93,37 @@ RenderMeshData::RenderMeshData(const loader::file::Mesh& mesh,
     for(int i = 0; i < 4; ++i)
     {
       RenderVertex iv{};
-      iv.position = quad.vertices[i].from(mesh.vertices).toRenderSystem();
+      iv.position = render::scene::packPosition(quad.vertices[i].from(mesh.vertices).toRenderSystem());
       iv.textureIndex = -1;
-      iv.color = color;
+      auto vertexColor = color;
       if(mesh.normals.empty())
-        iv.color *= toBrightness(quad.vertices[i].from(mesh.vertex_shades)).get();
+        vertexColor *= toBrightness(quad.vertices[i].from(mesh.vertex_shades)).get();
+      iv.color = render::scene::packColor(vertexColor);
 
+      glm::vec3 normal;
       if(mesh.isFlatShaded() || mesh.normals.empty()
          || quad.vertices[i].from(mesh.normals) == core::TRVec{0_len, 0_len, 0_len})
       {
         if(i <= 2)
         {
           static const std::array<int, 3> indices{0, 1, 2};
-          iv.normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
+          normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
         }
         else
         {
           static const std::array<int, 3> indices{0, 2, 3};
-          iv.normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
-                                                    quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
+          normal = engine::world::generateNormal(quad.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
+                                                 quad.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
         }
       }
       else
       {
-        iv.normal = quad.vertices[i].from(mesh.normals).toRenderSystem();
+        normal = quad.vertices[i].from(mesh.normals).toRenderSystem();
       }
+      iv.normal = render::scene::packNormal(normal);
       m_vertices.emplace_back(iv);
     }
     for(size_t i : {0, 1, 2, 0, 2, 3})
@@ -134,24 +140,27 @@ RenderMeshData::RenderMeshData(const loader::file::Mesh& mesh,
     for(int i = 0; i < 3; ++i)
     {
       RenderVertex iv{};
-      iv.position = tri.vertices[i].from(mesh.vertices).toRenderSystem();
-      iv.textureIndex = tile.textureKey.tileAndFlag & loader::file::TextureIndexMask;
-      iv.uv = tile.uvCoordinates[i];
+      iv.position = render::scene::packPosition(tri.vertices[i].from(mesh.vertices).toRenderSystem());
+      iv.textureIndex = gsl::narrow<int16_t>(tile.textureKey.tileAndFlag & loader::file::TextureIndexMask);
+      iv.uv = render::scene::packUv(tile.uvCoordinates[i]);
       if(mesh.normals.empty())
-        iv.color = glm::vec4{glm::vec3{toBrightness(tri.vertices[i].from(mesh.vertex_shades)).get()}, 1.0f};
+        iv.color = render::scene::packColor(
+          glm::vec4{glm::vec3{toBrightness(tri.vertices[i].from(mesh.vertex_shades)).get()}, 1.0f});
 
+      glm::vec3 normal;
       if(mesh.isFlatShaded() || mesh.normals.empty()
          || tri.vertices[i].from(mesh.normals) == core::TRVec{0_len, 0_len, 0_len})
       {
         static const std::array<int, 3> indices{0, 1, 2};
-        iv.normal = engine::world::generateNormal(tri.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
-                                                  tri.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
-                                                  tri.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
+        normal = engine::world::generateNormal(tri.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
+                                               tri.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
+                                               tri.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
       }
       else
       {
-        iv.normal = tri.vertices[i].from(mesh.normals).toRenderSystem();
+        normal = tri.vertices[i].from(mesh.normals).toRenderSystem();
       }
+      iv.normal = render::scene::packNormal(normal);
       m_indices.emplace_back(gsl::narrow<IndexType>(m_vertices.size()));
       m_vertices.emplace_back(iv);
     }
@@ -164,24 +173,27 @@ RenderMeshData::RenderMeshData(const loader::file::Mesh& mesh,
     for(int i = 0; i < 3; ++i)
     {
       RenderVertex iv{};
-      iv.position = tri.vertices[i].from(mesh.vertices).toRenderSystem();
+      iv.position = render::scene::packPosition(tri.vertices[i].from(mesh.vertices).toRenderSystem());
       iv.textureIndex = -1;
-      iv.color = color;
+      auto vertexColor = color;
       if(mesh.normals.empty())
-        iv.color *= glm::vec4{glm::vec3{toBrightness(tri.vertices[i].from(mesh.vertex_shades)).get()}, 1.0f};
+        vertexColor *= glm::vec4{glm::vec3{toBrightness(tri.vertices[i].from(mesh.vertex_shades)).get()}, 1.0f};
+      iv.color = render::scene::packColor(vertexColor);
 
+      glm::vec3 normal;
       if(mesh.isFlatShaded() || mesh.normals.empty()
          || tri.vertices[i].from(mesh.normals) == core::TRVec{0_len, 0_len, 0_len})
       {
         static const std::array<int, 3> indices{0, 1, 2};
-        iv.normal = engine::world::generateNormal(tri.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
-                                                  tri.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
-                                                  tri.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
+        normal = engine::world::generateNormal(tri.vertices[indices[(i + 0) % 3]].from(mesh.vertices),
+                                               tri.vertices[indices[(i + 1) % 3]].from(mesh.vertices),
+                                               tri.vertices[indices[(i + 2) % 3]].from(mesh.vertices));
       }
       else
       {
-        iv.normal = tri.vertices[i].from(mesh.normals).toRenderSystem();
+        normal = tri.vertices[i].from(mesh.normals).toRenderSystem();
       }
+      iv.normal = render::scene::packNormal(normal);
       m_indices.emplace_back(gsl::narrow<IndexType>(m_vertices.size()));
       m_vertices.emplace_back(iv);
     }
@@ -225,6 +237,16 @@ gsl::not_null<std::shared_ptr<render::scene::Mesh>> RenderMeshDataCompositor::to
   mesh->getRenderState().setDepthWrite(true);
   mesh->getRenderState().setDepthFunction(gl::api::DepthFunction::Less);
 
+  if(!m_quads.empty())
+  {
+    auto quadBuffer = std::make_shared<gl::ShaderStorageBuffer<render::scene::DistortedQuad>>(label + "-quads");
+    quadBuffer->setData(m_quads, gl::api::BufferUsage::StaticDraw);
+    mesh->bind("b_quads",
+               [quadBuffer](const render::scene::Node& /*node*/,
+                            const render::scene::Mesh& /*mesh*/,
+                            gl::ShaderStorageBlock& shaderStorageBlock) { shaderStorageBlock.bind(*quadBuffer); });
+  }
+
   return mesh;
 }
 } // namespace engine::world
@@ -2,10 +2,13 @@
 
 #include "mesh.h"
 #include "render/scene/names.h"
+#include "render/scene/vertexpacking.h"
 
 #include <gl/pixel.h>
 #include <gl/vertexbuffer.h>
 #include <glm/common.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
 
 namespace render::scene
 {
@@ -30,39 +33,25 @@ public:
 
   struct RenderVertex
   {
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec4 color{1.0f};
-    glm::vec2 uv;
-    glm::int32 textureIndex{-1};
-    glm::int32 boneIndex{-1};
-    glm::int32 isQuad{0};
-    glm::vec3 quadVert1;
-    glm::vec3 quadVert2;
-    glm::vec3 quadVert3;
-    glm::vec3 quadVert4;
-    glm::vec2 quadUv1;
-    glm::vec2 quadUv2;
-    glm::vec2 quadUv3;
-    glm::vec2 quadUv4;
+    glm::i16vec3 position{0};
+    //! 1-based index into the distorted quads of the mesh, 0 if the vertex doesn't belong to one.
+    uint16_t quadIndex{0};
+    glm::i16vec2 normal{0};
+    glm::u8vec4 color{render::scene::packColor(glm::vec4{1.0f})};
+    glm::u16vec2 uv{0};
+    int16_t textureIndex{-1};
+    int16_t boneIndex{-1};
 
     static const gl::VertexLayout<RenderVertex>& getLayout()
     {
-      static const gl::VertexLayout<RenderVertex> layout{{VERTEX_ATTRIBUTE_POSITION_NAME, &RenderVertex::position},
-                                                         {VERTEX_ATTRIBUTE_NORMAL_NAME, &RenderVertex::normal},
-                                                         {VERTEX_ATTRIBUTE_COLOR_NAME, &RenderVertex::color},
-                                                         {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, &RenderVertex::uv},
-                                                         {VERTEX_ATTRIBUTE_TEXINDEX_NAME, &RenderVertex::textureIndex},
-                                                         {VERTEX_ATTRIBUTE_BONE_INDEX_NAME, &RenderVertex::boneIndex},
-                                                         {VERTEX_ATTRIBUTE_IS_QUAD, &RenderVertex::isQuad},
-                                                         {VERTEX_ATTRIBUTE_QUAD_VERT1, &RenderVertex::quadVert1},
-                                                         {VERTEX_ATTRIBUTE_QUAD_VERT2, &RenderVertex::quadVert2},
-                                                         {VERTEX_ATTRIBUTE_QUAD_VERT3, &RenderVertex::quadVert3},
-                                                         {VERTEX_ATTRIBUTE_QUAD_VERT4, &RenderVertex::quadVert4},
-                                                         {VERTEX_ATTRIBUTE_QUAD_UV1, &RenderVertex::quadUv1},
-                                                         {VERTEX_ATTRIBUTE_QUAD_UV2, &RenderVertex::quadUv2},
-                                                         {VERTEX_ATTRIBUTE_QUAD_UV3, &RenderVertex::quadUv3},
-                                                         {VERTEX_ATTRIBUTE_QUAD_UV4, &RenderVertex::quadUv4}};
+      static const gl::VertexLayout<RenderVertex> layout{
+        {VERTEX_ATTRIBUTE_POSITION_NAME, &RenderVertex::position},
+        {VERTEX_ATTRIBUTE_QUAD_INDEX, &RenderVertex::quadIndex},
+        {VERTEX_ATTRIBUTE_NORMAL_NAME, gl::VertexAttribute{&RenderVertex::normal, true}},
+        {VERTEX_ATTRIBUTE_COLOR_NAME, gl::VertexAttribute{&RenderVertex::color, true}},
+        {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, gl::VertexAttribute{&RenderVertex::uv, true}},
+        {VERTEX_ATTRIBUTE_TEXINDEX_NAME, &RenderVertex::textureIndex},
+        {VERTEX_ATTRIBUTE_BONE_INDEX_NAME, &RenderVertex::boneIndex}};
 
       return layout;
     }
@@ -82,9 +71,15 @@ public:
     return m_indices;
   }
 
+  [[nodiscard]] const auto& getQuads() const
+  {
+    return m_quads;
+  }
+
 private:
   std::vector<RenderVertex> m_vertices{};
   std::vector<IndexType> m_indices{};
+  std::vector<render::scene::DistortedQuad> m_quads{};
 };
 
 class RenderMeshDataCompositor final
@@ -93,18 +88,45 @@ public:
   void append(const RenderMeshData& data)
   {
     const auto vertexOffset = gsl::narrow<RenderMeshData::IndexType>(m_vertices.size());
+    const auto quadOffset = m_quads.size();
     for(auto v : data.getVertices())
     {
-      v.boneIndex = m_boneIndex;
+      v.boneIndex = gsl::narrow<int16_t>(m_boneIndex);
+      if(v.quadIndex != 0)
+        v.quadIndex = gsl::narrow<uint16_t>(v.quadIndex + quadOffset);
       m_vertices.emplace_back(v);
     }
 
-    for(auto i : data.getIndices())
+    m_quads.insert(m_quads.end(), data.getQuads().begin(), data.getQuads().end());
+    appendIndices(data, vertexOffset);
+    ++m_boneIndex;
+  }
+
+  //! Appends the mesh data with all vertices pre-transformed, so that multiple meshes can be drawn with one call.
+  void append(const RenderMeshData& data, const glm::mat4& transform)
+  {
+    const auto vertexOffset = gsl::narrow<RenderMeshData::IndexType>(m_vertices.size());
+    const auto quadOffset = m_quads.size();
+    const glm::mat3 normalTransform{transform};
+
+    for(auto v : data.getVertices())
     {
-      // cppcheck-suppress useStlAlgorithm
-      m_indices.emplace_back(gsl::narrow<RenderMeshData::IndexType>(i + vertexOffset));
+      v.position = render::scene::packPosition(glm::vec3{transform * glm::vec4{glm::vec3{v.position}, 1.0f}});
+      v.normal = render::scene::packNormal(normalTransform * render::scene::unpackNormal(v.normal));
+      v.boneIndex = gsl::narrow<int16_t>(m_boneIndex);
+      if(v.quadIndex != 0)
+        v.quadIndex = gsl::narrow<uint16_t>(v.quadIndex + quadOffset);
+      m_vertices.emplace_back(v);
     }
 
+    for(auto quad : data.getQuads())
+    {
+      for(auto& vertex : quad.vertices)
+        vertex = transform * vertex;
+      m_quads.emplace_back(quad);
+    }
+
+    appendIndices(data, vertexOffset);
     ++m_boneIndex;
   }
 
@@ -121,9 +143,24 @@ public:
     return m_vertices.empty() || m_indices.empty();
   }
 
+  [[nodiscard]] size_t getVertexCount() const
+  {
+    return m_vertices.size();
+  }
+
 private:
   std::vector<RenderMeshData::RenderVertex> m_vertices{};
   std::vector<RenderMeshData::IndexType> m_indices{};
+  std::vector<render::scene::DistortedQuad> m_quads{};
   glm::int32_t m_boneIndex = 0;
+
+  void appendIndices(const RenderMeshData& data, RenderMeshData::IndexType vertexOffset)
+  {
+    for(auto i : data.getIndices())
+    {
+      // cppcheck-suppress useStlAlgorithm
+      m_indices.emplace_back(gsl::narrow<RenderMeshData::IndexType>(i + vertexOffset));
+    }
+  }
 };
 } // namespace engine::world
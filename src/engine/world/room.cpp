@@ -9,15 +9,21 @@
 #include "render/scene/mesh.h"
 #include "render/scene/names.h"
 #include "render/scene/shaderprogram.h"
+#include "render/scene/sprite.h"
+#include "render/scene/vertexpacking.h"
 #include "render/textureanimator.h"
+#include "rendermeshdata.h"
 #include "serialization/serialization.h"
 #include "serialization/vector.h"
 #include "serialization/vector_element.h"
 #include "util.h"
 #include "world.h"
 
+#include <array>
 #include <gl/vertexarray.h>
 #include <gl/vertexbuffer.h>
+#include <limits>
+#include <set>
 
 namespace engine::world
 {
@@ -27,33 +33,19 @@ namespace
 
 struct RenderVertex
 {
-  glm::vec3 position{};
-  glm::vec4 color{1.0f};
-  glm::vec3 normal{0.0f};
-  glm::int32 isQuad{0};
-  glm::vec3 quadVert1{};
-  glm::vec3 quadVert2{};
-  glm::vec3 quadVert3{};
-  glm::vec3 quadVert4{};
-  glm::vec2 quadUv1{};
-  glm::vec2 quadUv2{};
-  glm::vec2 quadUv3{};
-  glm::vec2 quadUv4{};
+  glm::i16vec3 position{0};
+  //! 1-based index into the distorted quads of the room, 0 if the vertex doesn't belong to one.
+  uint16_t quadIndex{0};
+  glm::i16vec2 normal{0};
+  glm::u8vec4 color{render::scene::packColor(glm::vec4{1.0f})};
 
   static const gl::VertexLayout<RenderVertex>& getLayout()
   {
-    static const gl::VertexLayout<RenderVertex> layout{{VERTEX_ATTRIBUTE_POSITION_NAME, &RenderVertex::position},
-                                                       {VERTEX_ATTRIBUTE_NORMAL_NAME, &RenderVertex::normal},
-                                                       {VERTEX_ATTRIBUTE_COLOR_NAME, &RenderVertex::color},
-                                                       {VERTEX_ATTRIBUTE_IS_QUAD, &RenderVertex::isQuad},
-                                                       {VERTEX_ATTRIBUTE_QUAD_VERT1, &RenderVertex::quadVert1},
-                                                       {VERTEX_ATTRIBUTE_QUAD_VERT2, &RenderVertex::quadVert2},
-                                                       {VERTEX_ATTRIBUTE_QUAD_VERT3, &RenderVertex::quadVert3},
-                                                       {VERTEX_ATTRIBUTE_QUAD_VERT4, &RenderVertex::quadVert4},
-                                                       {VERTEX_ATTRIBUTE_QUAD_UV1, &RenderVertex::quadUv1},
-                                                       {VERTEX_ATTRIBUTE_QUAD_UV2, &RenderVertex::quadUv2},
-                                                       {VERTEX_ATTRIBUTE_QUAD_UV3, &RenderVertex::quadUv3},
-                                                       {VERTEX_ATTRIBUTE_QUAD_UV4, &RenderVertex::quadUv4}};
+    static const gl::VertexLayout<RenderVertex> layout{
+      {VERTEX_ATTRIBUTE_POSITION_NAME, &RenderVertex::position},
+      {VERTEX_ATTRIBUTE_QUAD_INDEX, &RenderVertex::quadIndex},
+      {VERTEX_ATTRIBUTE_NORMAL_NAME, gl::VertexAttribute{&RenderVertex::normal, true}},
+      {VERTEX_ATTRIBUTE_COLOR_NAME, gl::VertexAttribute{&RenderVertex::color, true}}};
 
     return layout;
   }
@@ -161,6 +153,7 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
 
   std::vector<RenderVertex> vbufData;
   std::vector<render::TextureAnimator::AnimatedUV> uvCoordsData;
+  std::vector<render::scene::DistortedQuad> quads;
 
   const auto label = "Room:" + std::to_string(roomId);
   auto vbuf = std::make_shared<gl::VertexBuffer<RenderVertex>>(RenderVertex::getLayout(), 0, label);
@@ -204,40 +197,41 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
                                            quad.vertices[2].from(srcRoom.vertices).position.toRenderSystem(),
                                            quad.vertices[3].from(srcRoom.vertices).position.toRenderSystem());
 
+    uint16_t quadIndex = 0;
+    if(useQuadHandling)
+    {
+      quads.emplace_back(std::array<glm::vec3, 4>{quad.vertices[0].from(srcRoom.vertices).position.toRenderSystem(),
+                                                  quad.vertices[1].from(srcRoom.vertices).position.toRenderSystem(),
+                                                  quad.vertices[2].from(srcRoom.vertices).position.toRenderSystem(),
+                                                  quad.vertices[3].from(srcRoom.vertices).position.toRenderSystem()},
+                         tile.uvCoordinates);
+      quadIndex = gsl::narrow<uint16_t>(quads.size());
+    }
+
     const auto firstVertex = vbufData.size();
     for(int i = 0; i < 4; ++i)
     {
       RenderVertex iv;
-      iv.position = quad.vertices[i].from(srcRoom.vertices).position.toRenderSystem();
-      iv.color = quad.vertices[i].from(srcRoom.vertices).color;
+      iv.position = render::scene::packPosition(quad.vertices[i].from(srcRoom.vertices).position.toRenderSystem());
+      iv.color = render::scene::packColor(quad.vertices[i].from(srcRoom.vertices).color);
+      iv.quadIndex = quadIndex;
       uvCoordsData.emplace_back(tile.textureKey.tileAndFlag & loader::file::TextureIndexMask, tile.uvCoordinates[i]);
 
-      if(useQuadHandling)
-      {
-        iv.isQuad = 1;
-        iv.quadVert1 = quad.vertices[0].from(srcRoom.vertices).position.toRenderSystem();
-        iv.quadVert2 = quad.vertices[1].from(srcRoom.vertices).position.toRenderSystem();
-        iv.quadVert3 = quad.vertices[2].from(srcRoom.vertices).position.toRenderSystem();
-        iv.quadVert4 = quad.vertices[3].from(srcRoom.vertices).position.toRenderSystem();
-        iv.quadUv1 = tile.uvCoordinates[0];
-        iv.quadUv2 = tile.uvCoordinates[1];
-        iv.quadUv3 = tile.uvCoordinates[2];
-        iv.quadUv4 = tile.uvCoordinates[3];
-      }
-
       if(i <= 2)
       {
         static const std::array<int, 3> indices{0, 1, 2};
-        iv.normal = generateNormal(quad.vertices[indices[(i + 0) % 3]].from(srcRoom.vertices).position,
-                                   quad.vertices[indices[(i + 1) % 3]].from(srcRoom.vertices).position,
-                                   quad.vertices[indices[(i + 2) % 3]].from(srcRoom.vertices).position);
+        const auto normal = generateNormal(quad.vertices[indices[(i + 0) % 3]].from(srcRoom.vertices).position,
+                                           quad.vertices[indices[(i + 1) % 3]].from(srcRoom.vertices).position,
+                                           quad.vertices[indices[(i + 2) % 3]].from(srcRoom.vertices).position);
+        iv.normal = render::scene::packNormal(normal);
       }
       else
       {
         static const std::array<int, 3> indices{0, 2, 3};
-        iv.normal = generateNormal(quad.vertices[indices[(i + 0) % 3]].from(srcRoom.vertices).position,
-                                   quad.vertices[indices[(i + 1) % 3]].from(srcRoom.vertices).position,
-                                   quad.vertices[indices[(i + 2) % 3]].from(srcRoom.vertices).position);
+        const auto normal = generateNormal(quad.vertices[indices[(i + 0) % 3]].from(srcRoom.vertices).position,
+                                           quad.vertices[indices[(i + 1) % 3]].from(srcRoom.vertices).position,
+                                           quad.vertices[indices[(i + 2) % 3]].from(srcRoom.vertices).position);
+        iv.normal = render::scene::packNormal(normal);
       }
 
       vbufData.emplace_back(iv);
@@ -273,14 +267,15 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
     for(int i = 0; i < 3; ++i)
     {
       RenderVertex iv;
-      iv.position = tri.vertices[i].from(srcRoom.vertices).position.toRenderSystem();
-      iv.color = tri.vertices[i].from(srcRoom.vertices).color;
+      iv.position = render::scene::packPosition(tri.vertices[i].from(srcRoom.vertices).position.toRenderSystem());
+      iv.color = render::scene::packColor(tri.vertices[i].from(srcRoom.vertices).color);
       uvCoordsData.emplace_back(tile.textureKey.tileAndFlag & loader::file::TextureIndexMask, tile.uvCoordinates[i]);
 
       static const std::array<int, 3> indices{0, 1, 2};
-      iv.normal = generateNormal(tri.vertices[indices[(i + 0) % 3]].from(srcRoom.vertices).position,
-                                 tri.vertices[indices[(i + 1) % 3]].from(srcRoom.vertices).position,
-                                 tri.vertices[indices[(i + 2) % 3]].from(srcRoom.vertices).position);
+      const auto normal = generateNormal(tri.vertices[indices[(i + 0) % 3]].from(srcRoom.vertices).position,
+                                         tri.vertices[indices[(i + 1) % 3]].from(srcRoom.vertices).position,
+                                         tri.vertices[indices[(i + 2) % 3]].from(srcRoom.vertices).position);
+      iv.normal = render::scene::packNormal(normal);
 
       vbufData.push_back(iv);
     }
@@ -296,6 +291,15 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
   uvCoords->setData(uvCoordsData, gl::api::BufferUsage::DynamicDraw);
 
   auto resMesh = renderMesh.toMesh(vbuf, uvCoords, label);
+  if(!quads.empty())
+  {
+    auto quadBuffer = std::make_shared<gl::ShaderStorageBuffer<render::scene::DistortedQuad>>(label + "-quads");
+    quadBuffer->setData(quads, gl::api::BufferUsage::StaticDraw);
+    resMesh->bind("b_quads",
+                  [quadBuffer](const render::scene::Node& /*node*/,
+                               const render::scene::Mesh& /*mesh*/,
+                               gl::ShaderStorageBlock& shaderStorageBlock) { shaderStorageBlock.bind(*quadBuffer); });
+  }
   resMesh->getRenderState().setCullFace(true);
   resMesh->getRenderState().setCullFaceSide(gl::api::CullFaceMode::Back);
   resMesh->getRenderState().setBlend(false);
@@ -312,16 +316,16 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
                                                            gl::ShaderStorageBlock& shaderStorageBlock)
              { shaderStorageBlock.bind(*emptyBuffer); });
 
-  for(const RoomStaticMesh& sm : staticMeshes)
+  // all static meshes share the room's ambient light and light sources, so they are merged into a few pre-transformed
+  // batches instead of getting a node each
+  RenderMeshDataCompositor staticMeshBatch;
+  const auto flushStaticMeshBatch = [this, &staticMeshBatch, &materialManager, &label]()
   {
-    if(sm.staticMesh->renderMesh == nullptr)
-      continue;
-
-    auto subNode = std::make_shared<render::scene::Node>("staticMesh");
-    subNode->setRenderable(sm.staticMesh->renderMesh);
-    subNode->setLocalMatrix(translate(glm::mat4{1.0f}, (sm.position - position).toRenderSystem())
-                            * rotate(glm::mat4{1.0f}, toRad(sm.rotation), glm::vec3{0, -1, 0}));
+    if(staticMeshBatch.empty())
+      return;
 
+    auto subNode = std::make_shared<render::scene::Node>("staticMeshes");
+    subNode->setRenderable(staticMeshBatch.toMesh(materialManager, false, label + "-staticMeshes"));
     subNode->bind("u_lightAmbient",
                   [brightness = toBrightness(ambientShade)](
                     const render::scene::Node& /*node*/, const render::scene::Mesh& /*mesh*/, gl::Uniform& uniform)
@@ -333,23 +337,53 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
                          gl::ShaderStorageBlock& shaderStorageBlock) { shaderStorageBlock.bind(*lightsBuffer); });
 
     sceneryNodes.emplace_back(std::move(subNode));
+    staticMeshBatch = RenderMeshDataCompositor{};
+  };
+
+  for(const RoomStaticMesh& sm : staticMeshes)
+  {
+    if(sm.staticMesh->meshData == nullptr)
+      continue;
+
+    if(staticMeshBatch.getVertexCount() + sm.staticMesh->meshData->getVertices().size()
+       > std::numeric_limits<RenderMeshData::IndexType>::max())
+    {
+      flushStaticMeshBatch();
+    }
+
+    staticMeshBatch.append(*sm.staticMesh->meshData,
+                           translate(glm::mat4{1.0f}, (sm.position - position).toRenderSystem())
+                             * rotate(glm::mat4{1.0f}, toRad(sm.rotation), glm::vec3{0, -1, 0}));
   }
+  flushStaticMeshBatch();
+
   node->setLocalMatrix(translate(glm::mat4{1.0f}, position.toRenderSystem()));
 
-  for(const loader::file::SpriteInstance& spriteInstance : srcRoom.sprites)
+  renderBoundsMin = glm::vec3{std::numeric_limits<float>::max()};
+  renderBoundsMax = glm::vec3{std::numeric_limits<float>::lowest()};
+  for(const auto& vertex : srcRoom.vertices)
   {
-    BOOST_ASSERT(spriteInstance.vertex.get() < srcRoom.vertices.size());
+    const auto v = (position + vertex.position).toRenderSystem();
+    renderBoundsMin = glm::min(renderBoundsMin, v);
+    renderBoundsMax = glm::max(renderBoundsMax, v);
+  }
+  if(srcRoom.vertices.empty())
+    renderBoundsMin = renderBoundsMax = position.toRenderSystem();
 
-    const auto& sprite = world.getSprites().at(spriteInstance.id.get());
+  // sprites are merged the same way; their individual brightness is baked into the vertex colors, which is
+  // equivalent as they don't receive any light from the room's light sources
+  std::vector<render::scene::SpriteVertex> spriteBatch;
+  const auto flushSpriteBatch = [this, &spriteBatch, &materialManager, &label]()
+  {
+    if(spriteBatch.empty())
+      return;
 
-    auto spriteNode = std::make_shared<render::scene::Node>("sprite");
-    spriteNode->setRenderable(sprite.mesh);
-    const auto& v = srcRoom.vertices.at(spriteInstance.vertex.get());
-    spriteNode->setLocalMatrix(translate(glm::mat4{1.0f}, v.position.toRenderSystem()));
+    auto spriteNode = std::make_shared<render::scene::Node>("sprites");
+    spriteNode->setRenderable(
+      render::scene::createSpriteBatchMesh(spriteBatch, materialManager.getSprite(), label + "-sprites"));
     spriteNode->bind("u_lightAmbient",
-                     [brightness = toBrightness(v.shade)](
-                       const render::scene::Node& /*node*/, const render::scene::Mesh& /*mesh*/, gl::Uniform& uniform)
-                     { uniform.set(brightness.get()); });
+                     [](const render::scene::Node& /*node*/, const render::scene::Mesh& /*mesh*/, gl::Uniform& uniform)
+                     { uniform.set(1.0f); });
     spriteNode->bind("b_lights",
                      [emptyLightsBuffer = ShaderLight::getEmptyBuffer()](const render::scene::Node&,
                                                                          const render::scene::Mesh& /*mesh*/,
@@ -357,7 +391,33 @@ void Room::createSceneNode(const loader::file::Room& srcRoom,
                      { shaderStorageBlock.bind(*emptyLightsBuffer); });
 
     sceneryNodes.emplace_back(std::move(spriteNode));
+    spriteBatch.clear();
+  };
+
+  for(const loader::file::SpriteInstance& spriteInstance : srcRoom.sprites)
+  {
+    BOOST_ASSERT(spriteInstance.vertex.get() < srcRoom.vertices.size());
+
+    if(spriteBatch.size() + 4 > std::numeric_limits<uint16_t>::max())
+      flushSpriteBatch();
+
+    const auto& sprite = world.getSprites().at(spriteInstance.id.get());
+    const auto& v = srcRoom.vertices.at(spriteInstance.vertex.get());
+    const auto color = render::scene::packColor(glm::vec4{glm::vec3{toBrightness(v.shade).get()}, 1.0f});
+    for(auto vertex : render::scene::createSpriteVertices(static_cast<float>(sprite.render0.x),
+                                                          static_cast<float>(-sprite.render0.y),
+                                                          static_cast<float>(sprite.render1.x),
+                                                          static_cast<float>(-sprite.render1.y),
+                                                          sprite.uv0,
+                                                          sprite.uv1,
+                                                          sprite.textureId.get_as<int32_t>()))
+    {
+      vertex.color = color;
+      vertex.center = v.position.toRenderSystem();
+      spriteBatch.emplace_back(vertex);
+    }
   }
+  flushSpriteBatch();
 
   std::transform(srcRoom.portals.begin(),
                  srcRoom.portals.end(),
@@ -444,6 +504,39 @@ void Room::resetScenery()
   }
 }
 
+bool Room::canBeCulled(const glm::mat4& viewProjection) const
+{
+  // objects and static meshes may stick out of the room geometry
+  static const glm::vec3 margin{core::SectorSize.get<float>()};
+  const auto min = renderBoundsMin - margin;
+  const auto max = renderBoundsMax + margin;
+  const std::array<glm::vec3, 8> corners{
+    glm::vec3{min.x, min.y, min.z},
+    glm::vec3{min.x, min.y, max.z},
+    glm::vec3{min.x, max.y, min.z},
+    glm::vec3{min.x, max.y, max.z},
+    glm::vec3{max.x, min.y, min.z},
+    glm::vec3{max.x, min.y, max.z},
+    glm::vec3{max.x, max.y, min.z},
+    glm::vec3{max.x, max.y, max.z},
+  };
+
+  glm::vec2 projMin{std::numeric_limits<float>::max()};
+  glm::vec2 projMax{std::numeric_limits<float>::lowest()};
+  for(const auto& corner : corners)
+  {
+    auto proj = viewProjection * glm::vec4{corner, 1.0f};
+    if(proj.w <= 0)
+      return false;
+
+    proj /= proj.w;
+    projMin = glm::min(projMin, glm::vec2{proj});
+    projMax = glm::max(projMax, glm::vec2{proj});
+  }
+
+  return projMin.x > 1 || projMin.y > 1 || projMax.x < -1 || projMax.y < -1;
+}
+
 void Room::serialize(const serialization::Serializer<World>& ser)
 {
   ser(S_NV("sectors", serialization::FrozenVector{sectors}),
@@ -8,6 +8,7 @@
 #include "sector.h"
 
 #include <algorithm>
+#include <glm/glm.hpp>
 
 namespace render
 {
@@ -84,6 +85,12 @@ struct Room
   std::shared_ptr<render::scene::Node> node = nullptr;
   std::vector<std::shared_ptr<render::scene::Node>> sceneryNodes{};
 
+  //! @brief World space bounds of the room geometry, in render system coordinates
+  //! @{
+  glm::vec3 renderBoundsMin{0.0f};
+  glm::vec3 renderBoundsMax{0.0f};
+  //! @}
+
   void createSceneNode(const loader::file::Room& srcRoom,
                        size_t roomId,
                        World&,
@@ -144,6 +151,9 @@ struct Room
 
   void resetScenery();
 
+  //! Returns true if neither the room nor anything close to it is visible with the given projection.
+  [[nodiscard]] bool canBeCulled(const glm::mat4& viewProjection) const;
+
   void serialize(const serialization::Serializer<World>& ser);
 
   std::vector<engine::ShaderLight> bufferLights{};
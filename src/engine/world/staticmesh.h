@@ -3,19 +3,17 @@
 #include "core/boundingbox.h"
 #include "core/id.h"
 
-namespace render::scene
-{
-class Mesh;
-}
-
 namespace engine::world
 {
+class RenderMeshData;
+
 struct StaticMesh
 {
   const core::BoundingBox collisionBox;
   const bool doNotCollide;
   const bool isVisible;
 
-  std::shared_ptr<render::scene::Mesh> renderMesh{nullptr};
+  //! Kept as vertex data instead of a render mesh, as rooms merge their static meshes into batches.
+  std::shared_ptr<RenderMeshData> meshData{nullptr};
 };
 } // namespace engine::world
@@ -0,0 +1,265 @@
+#include "texturecache.h"
+
+#include "atlastile.h"
+#include "loader/file/io/sdlreader.h"
+#include "loader/file/level/level.h"
+#include "loader/trx/trx.h"
+#include "sprite.h"
+#include "util/md5.h"
+
+#include <algorithm>
+#include <array>
+#include <boost/log/trivial.hpp>
+#include <gl/texture2darray.h>
+#include <sstream>
+
+namespace engine::world
+{
+namespace
+{
+constexpr std::array<char, 4> Magic{'E', 'T', 'C', 'A'};
+constexpr int32_t EndOfImages = -1;
+
+template<typename T>
+void write(std::ofstream& stream, const T& value)
+{
+  static_assert(std::is_arithmetic_v<T>);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+glm::ivec2 getLevelSize(const glm::ivec3& size, int level)
+{
+  return glm::max(glm::ivec2{1, 1}, glm::ivec2{size.x, size.y} / (1 << level));
+}
+
+std::filesystem::file_time_type getNewestWriteTime(const std::filesystem::path& dir)
+{
+  std::filesystem::file_time_type result{};
+  if(!std::filesystem::is_directory(dir))
+    return result;
+
+  for(const auto& entry : std::filesystem::recursive_directory_iterator{dir})
+  {
+    if(entry.is_regular_file())
+      result = std::max(result, entry.last_write_time());
+  }
+  return result;
+}
+} // namespace
+
+TextureCache::Writer::Writer(std::filesystem::path path,
+                             const std::string& key,
+                             const glm::ivec3& size,
+                             int levels,
+                             const std::vector<AtlasTile>& atlasTiles,
+                             const std::vector<Sprite>& sprites)
+    : m_path{std::move(path)}
+    , m_tmpPath{std::filesystem::path{m_path}.concat(".tmp")}
+    , m_stream{m_tmpPath, std::ios::binary | std::ios::trunc}
+{
+  m_stream.write(Magic.data(), Magic.size());
+  write(m_stream, FormatVersion);
+  write(m_stream, gsl::narrow<uint32_t>(key.size()));
+  m_stream.write(key.data(), gsl::narrow<std::streamsize>(key.size()));
+
+  write(m_stream, int32_t{size.x});
+  write(m_stream, int32_t{size.y});
+  write(m_stream, int32_t{size.z});
+  write(m_stream, int32_t{levels});
+
+  write(m_stream, gsl::narrow<uint32_t>(atlasTiles.size()));
+  for(const auto& tile : atlasTiles)
+  {
+    write(m_stream, tile.textureKey.tileAndFlag);
+    for(const auto& uv : tile.uvCoordinates)
+    {
+      write(m_stream, uv.x);
+      write(m_stream, uv.y);
+    }
+  }
+
+  write(m_stream, gsl::narrow<uint32_t>(sprites.size()));
+  for(const auto& sprite : sprites)
+  {
+    write(m_stream, sprite.textureId.get());
+    write(m_stream, sprite.uv0.x);
+    write(m_stream, sprite.uv0.y);
+    write(m_stream, sprite.uv1.x);
+    write(m_stream, sprite.uv1.y);
+  }
+}
+
+TextureCache::Writer::~Writer()
+{
+  if(m_committed)
+    return;
+
+  m_stream.close();
+  std::error_code ec;
+  std::filesystem::remove(m_tmpPath, ec);
+}
+
+void TextureCache::Writer::add(const gsl::span<const gl::SRGBA8>& pixels, int layer, int level)
+{
+  Expects(layer >= 0 && level >= 0);
+  write(m_stream, int32_t{layer});
+  write(m_stream, int32_t{level});
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_stream.write(reinterpret_cast<const char*>(pixels.data()),
+                 gsl::narrow<std::streamsize>(pixels.size() * sizeof(gl::SRGBA8)));
+}
+
+void TextureCache::Writer::commit()
+{
+  write(m_stream, EndOfImages);
+  m_stream.close();
+  if(!m_stream)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Failed to write texture cache " << m_tmpPath;
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(m_tmpPath, m_path, ec);
+  if(ec)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Failed to replace texture cache " << m_path << ": " << ec.message();
+    return;
+  }
+
+  m_committed = true;
+}
+
+std::filesystem::path TextureCache::getPath(const std::filesystem::path& cacheRootPath,
+                                           const std::filesystem::path& levelPath)
+{
+  const auto levelPathStr = levelPath.generic_string();
+  return cacheRootPath
+         / (levelPath.stem().string() + "-" + util::md5(levelPathStr.data(), levelPathStr.size()) + ".textures");
+}
+
+std::string TextureCache::createKey(const loader::file::level::Level& level,
+                                    const std::unique_ptr<loader::trx::Glidos>& glidos,
+                                    const std::filesystem::path& atlasSourcesDir,
+                                    const int32_t atlasSize)
+{
+  std::ostringstream key;
+  key << FormatVersion << '|' << atlasSize;
+
+  {
+    loader::file::io::SDLReader reader{level.getFilename()};
+    std::vector<uint8_t> data;
+    reader.readVector(data, gsl::narrow<size_t>(reader.size()));
+    key << '|' << util::md5(data.data(), data.size());
+  }
+
+  if(glidos != nullptr)
+  {
+    key << '|' << glidos->getBaseDir().string();
+    for(const auto& texture : level.m_textures)
+      key << '|' << glidos->getMappingsForTexture(texture.md5).newestSource.time_since_epoch().count();
+  }
+
+  key << '|' << getNewestWriteTime(atlasSourcesDir).time_since_epoch().count();
+
+  const auto keyStr = key.str();
+  return util::md5(keyStr.data(), keyStr.size());
+}
+
+std::unique_ptr<gl::Texture2DArray<gl::SRGBA8>> TextureCache::load(std::vector<AtlasTile>& atlasTiles,
+                                                                   std::vector<Sprite>& sprites) const
+{
+  if(!std::filesystem::is_regular_file(m_path))
+    return nullptr;
+
+  try
+  {
+    loader::file::io::SDLReader reader{m_path};
+    if(!reader.isOpen())
+      return nullptr;
+
+    std::array<char, 4> magic{};
+    reader.readBytes(magic.data(), magic.size());
+    if(magic != Magic || reader.readU32() != FormatVersion)
+      return nullptr;
+
+    std::vector<char> key;
+    reader.readVector(key, reader.readU32());
+    if(std::string{key.begin(), key.end()} != m_key)
+    {
+      BOOST_LOG_TRIVIAL(info) << "Texture cache " << m_path << " is outdated";
+      return nullptr;
+    }
+
+    glm::ivec3 size;
+    size.x = reader.readI32();
+    size.y = reader.readI32();
+    size.z = reader.readI32();
+    const auto levels = reader.readI32();
+    if(size.x <= 0 || size.y <= 0 || size.z <= 0 || levels <= 0)
+      return nullptr;
+
+    if(reader.readU32() != atlasTiles.size())
+      return nullptr;
+    auto cachedTiles = atlasTiles;
+    for(auto& tile : cachedTiles)
+    {
+      tile.textureKey.tileAndFlag = reader.readU16();
+      for(auto& uv : tile.uvCoordinates)
+      {
+        uv.x = reader.readF();
+        uv.y = reader.readF();
+      }
+    }
+
+    if(reader.readU32() != sprites.size())
+      return nullptr;
+    auto cachedSprites = sprites;
+    for(auto& sprite : cachedSprites)
+    {
+      sprite.textureId = core::TextureId{reader.readU16()};
+      sprite.uv0.x = reader.readF();
+      sprite.uv0.y = reader.readF();
+      sprite.uv1.x = reader.readF();
+      sprite.uv1.y = reader.readF();
+    }
+
+    auto allTextures = std::make_unique<gl::Texture2DArray<gl::SRGBA8>>(size, levels, "all-textures");
+    std::vector<gl::SRGBA8> pixels;
+    std::vector<bool> loadedImages(gsl::narrow<size_t>(size.z * levels), false);
+    while(true)
+    {
+      const auto layer = reader.readI32();
+      if(layer == EndOfImages)
+        break;
+
+      const auto level = reader.readI32();
+      if(layer < 0 || layer >= size.z || level < 0 || level >= levels)
+        return nullptr;
+
+      const auto levelSize = getLevelSize(size, level);
+      pixels.resize(gsl::narrow<size_t>(levelSize.x * levelSize.y));
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      reader.readBytes(reinterpret_cast<uint8_t*>(pixels.data()), pixels.size() * sizeof(gl::SRGBA8));
+      allTextures->assign(pixels.data(), layer, level);
+      loadedImages[gsl::narrow<size_t>(layer * levels + level)] = true;
+    }
+
+    if(std::find(loadedImages.begin(), loadedImages.end(), false) != loadedImages.end())
+    {
+      BOOST_LOG_TRIVIAL(warning) << "Texture cache " << m_path << " is incomplete";
+      return nullptr;
+    }
+
+    atlasTiles = std::move(cachedTiles);
+    sprites = std::move(cachedSprites);
+    return allTextures;
+  }
+  catch(const std::exception& ex)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Failed to load texture cache " << m_path << ": " << ex.what();
+    return nullptr;
+  }
+}
+} // namespace engine::world
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gl/pixel.h>
+#include <gl/soglb_fwd.h>
+#include <glm/glm.hpp>
+#include <gsl/gsl-lite.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace loader::file::level
+{
+class Level;
+}
+
+namespace loader::trx
+{
+class Glidos;
+}
+
+namespace engine::world
+{
+struct AtlasTile;
+struct Sprite;
+
+/**
+ * @brief Stores the texture atlases built for a level on disk, including their mipmaps and the re-mapped tiles.
+ *
+ * The cache is only valid for the key it was written with, which covers all sources of the atlases.
+ */
+class TextureCache final
+{
+public:
+  /**
+   * @brief Part of every key, so caches written by other engine builds are never used.
+   *
+   * Must be increased whenever the cache layout or the way the atlases and their mipmaps are built changes, including
+   * everything in texturing.cpp.
+   */
+  static constexpr uint32_t FormatVersion = 3;
+
+  class Writer final
+  {
+  public:
+    Writer(std::filesystem::path path,
+           const std::string& key,
+           const glm::ivec3& size,
+           int levels,
+           const std::vector<AtlasTile>& atlasTiles,
+           const std::vector<Sprite>& sprites);
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer(Writer&&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    Writer& operator=(Writer&&) = delete;
+
+    void add(const gsl::span<const gl::SRGBA8>& pixels, int layer, int level);
+
+    //! Replaces the cache file with everything added so far.
+    void commit();
+
+  private:
+    const std::filesystem::path m_path;
+    const std::filesystem::path m_tmpPath;
+    std::ofstream m_stream;
+    bool m_committed = false;
+  };
+
+  TextureCache(std::filesystem::path path, std::string key)
+      : m_path{std::move(path)}
+      , m_key{std::move(key)}
+  {
+  }
+
+  /**
+   * @brief Returns the cache file of a level.
+   * @param levelPath The level's path relative to the engine's root, so levels with the same file name in different
+   *                  directories don't share a cache file.
+   */
+  static std::filesystem::path getPath(const std::filesystem::path& cacheRootPath,
+                                       const std::filesystem::path& levelPath);
+
+  /**
+   * @brief Creates a key from everything the texture atlases are built from.
+   * @param atlasSourcesDir Directory with additional images the atlases contain.
+   * @param atlasSize Width and height of a single atlas page.
+   */
+  static std::string createKey(const loader::file::level::Level& level,
+                               const std::unique_ptr<loader::trx::Glidos>& glidos,
+                               const std::filesystem::path& atlasSourcesDir,
+                               int32_t atlasSize);
+
+  //! Restores the textures, tiles and sprites; returns nullptr and leaves everything untouched if the cache is invalid
+  //! or doesn't contain every mipmap level of every layer.
+  [[nodiscard]] std::unique_ptr<gl::Texture2DArray<gl::SRGBA8>> load(std::vector<AtlasTile>& atlasTiles,
+                                                                     std::vector<Sprite>& sprites) const;
+
+  [[nodiscard]] std::unique_ptr<Writer> createWriter(const glm::ivec3& size,
+                                                     int levels,
+                                                     const std::vector<AtlasTile>& atlasTiles,
+                                                     const std::vector<Sprite>& sprites) const
+  {
+    return std::make_unique<Writer>(m_path, m_key, size, levels, atlasTiles, sprites);
+  }
+
+private:
+  const std::filesystem::path m_path;
+  const std::string m_key;
+};
+} // namespace engine::world
@@ -7,6 +7,7 @@
 #include "loader/trx/trx.h"
 #include "render/textureatlas.h"
 #include "sprite.h"
+#include "texturecache.h"
 
 #include <array>
 #include <boost/log/trivial.hpp>
@@ -116,12 +117,16 @@ void remap(Sprite& sprite, size_t atlas, const glm::vec2& replacementUvPos, cons
 
 void createMipmaps(const std::vector<std::shared_ptr<gl::CImgWrapper>>& images,
                    size_t nMips,
-                   gl::Texture2DArray<gl::SRGBA8>& allTextures,
+                   const std::function<void(const gsl::span<const gl::SRGBA8>&, int, int)>& assign,
                    const std::vector<AtlasTile>& atlasTiles,
                    const std::vector<Sprite>& sprites,
                    const std::function<void(const std::string&)>& drawLoadingScreen)
 {
   std::map<int, std::set<UVRect>> tilesByTexture;
+  // every layer gets its mipmaps, even if it only contains additional images, so the texture cache can verify that
+  // it's complete
+  for(size_t i = 0; i < images.size(); ++i)
+    tilesByTexture[gsl::narrow<int>(i)];
   BOOST_LOG_TRIVIAL(debug) << atlasTiles.size() << " total atlas tiles";
   for(const auto& tile : atlasTiles)
   {
@@ -157,7 +162,7 @@ void createMipmaps(const std::vector<std::shared_ptr<gl::CImgWrapper>>& images,
       BOOST_LOG_TRIVIAL(debug) << "Mipmap level " << mipmapLevel << " (size " << dstSize << ", " << tiles.size()
                                << " tiles)";
       src.resizePow2Mipmap(1);
-      allTextures.assign(src.pixels().data(), texture, mipmapLevel);
+      assign(src.pixels(), texture, mipmapLevel);
     }
   }
 }
@@ -393,10 +398,17 @@ std::unique_ptr<gl::Texture2DArray<gl::SRGBA8>>
                 render::MultiTextureAtlas& atlases,
                 std::vector<AtlasTile>& atlasTiles,
                 std::vector<Sprite>& sprites,
+                const TextureCache& cache,
                 const std::function<void(const std::string&)>& drawLoadingScreen)
 {
   drawLoadingScreen(_("Building textures"));
 
+  if(auto cached = cache.load(atlasTiles, sprites))
+  {
+    BOOST_LOG_TRIVIAL(info) << "Loaded texture atlases from cache";
+    return cached;
+  }
+
   for(auto& texture : level.m_textures)
   {
     texture.toImage();
@@ -417,13 +429,20 @@ std::unique_ptr<gl::Texture2DArray<gl::SRGBA8>>
   const int textureLevels = static_cast<int>(std::log2(atlases.getSize()) + 1) / 2;
   auto images = atlases.takeImages();
 
-  auto allTextures = std::make_unique<gl::Texture2DArray<gl::SRGBA8>>(
-    glm::ivec3{atlases.getSize(), atlases.getSize(), gsl::narrow<int>(images.size())}, textureLevels, "all-textures");
+  const glm::ivec3 size{atlases.getSize(), atlases.getSize(), gsl::narrow<int>(images.size())};
+  auto allTextures = std::make_unique<gl::Texture2DArray<gl::SRGBA8>>(size, textureLevels, "all-textures");
+  const auto cacheWriter = cache.createWriter(size, textureLevels, atlasTiles, sprites);
+  const auto assign = [&allTextures, &cacheWriter](const gsl::span<const gl::SRGBA8>& pixels, int layer, int level)
+  {
+    allTextures->assign(pixels.data(), layer, level);
+    cacheWriter->add(pixels, layer, level);
+  };
 
   for(size_t i = 0; i < images.size(); ++i)
-    allTextures->assign(images[i]->pixels().data(), gsl::narrow_cast<int>(i), 0);
-  createMipmaps(images, textureLevels, *allTextures, atlasTiles, sprites, drawLoadingScreen);
+    assign(images[i]->pixels(), gsl::narrow_cast<int>(i), 0);
+  createMipmaps(images, textureLevels, assign, atlasTiles, sprites, drawLoadingScreen);
 
+  cacheWriter->commit();
   return allTextures;
 }
 } // namespace engine::world
@@ -25,6 +25,7 @@ namespace engine::world
 {
 struct AtlasTile;
 struct Sprite;
+class TextureCache;
 
 extern std::unique_ptr<gl::Texture2DArray<gl::SRGBA8>>
   buildTextures(const loader::file::level::Level& level,
@@ -32,5 +33,6 @@ extern std::unique_ptr<gl::Texture2DArray<gl::SRGBA8>>
                 render::MultiTextureAtlas& atlases,
                 std::vector<AtlasTile>& atlasTiles,
                 std::vector<Sprite>& sprites,
+                const TextureCache& cache,
                 const std::function<void(const std::string&)>& drawLoadingScreen);
 } // namespace engine::world
@@ -11,6 +11,9 @@
 #include "engine/objects/tallblock.h"
 #include "engine/player.h"
 #include "engine/presenter.h"
+#include "engine/profiler.h"
+#include "engine/savegameindex.h"
+#include "engine/savegamewriter.h"
 #include "engine/tracks_tr1.h"
 #include "loader/file/level/level.h"
 #include "loader/trx/trx.h"
@@ -33,6 +36,7 @@
 #include "serialization/serialization.h"
 #include "serialization/vector.h"
 #include "serialization/yamldocument.h"
+#include "texturecache.h"
 #include "texturing.h"
 #include "ui/core.h"
 #include "ui/text.h"
@@ -173,6 +177,8 @@ void World::swapAllRooms()
   m_roomsAreSwapped = !m_roomsAreSwapped;
   connectSectors();
   updateStaticSoundEffects();
+  getPresenter().resetHiZBuffer();
+  getPresenter().resetStaticShadows();
 }
 
 bool World::isValid(const loader::file::AnimFrame* frame) const
@@ -193,6 +199,38 @@ const std::unique_ptr<SpriteSequence>& World::findSpriteSequenceForType(core::Ty
   return none;
 }
 
+const gsl::not_null<std::shared_ptr<const World::RenderableSequence>>&
+  World::getParticleRenderables(core::TypeId type)
+{
+  if(const auto it = m_particleRenderables.find(type); it != m_particleRenderables.end())
+    return it->second;
+
+  auto renderables = std::make_shared<RenderableSequence>();
+  if(const auto& modelType = findAnimatedModelForType(type))
+  {
+    for(const auto& bone : modelType->bones)
+    {
+      RenderMeshDataCompositor compositor;
+      compositor.append(*bone.mesh);
+      renderables->emplace_back(compositor.toMesh(*getPresenter().getMaterialManager(), false, {}));
+    }
+  }
+  else if(const auto& spriteSequence = findSpriteSequenceForType(type))
+  {
+    for(const Sprite& spr : spriteSequence->sprites)
+    {
+      renderables->emplace_back(spr.mesh);
+    }
+  }
+  else
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Missing sprite/model referenced by particle: "
+                               << toString(static_cast<TR1ItemId>(type.get()));
+  }
+
+  return m_particleRenderables.emplace(type, std::move(renderables)).first->second;
+}
+
 const StaticMesh* World::findStaticMeshById(core::StaticMeshId meshId) const
 {
   auto it = m_staticMeshes.find(meshId);
@@ -217,6 +255,12 @@ const std::vector<Box>& World::getBoxes() const
   return m_boxes;
 }
 
+std::shared_ptr<const ai::BoxGraph>
+  World::getBoxGraph(bool flying, const core::Length& step, const core::Length& drop) const
+{
+  return m_boxGraphs.get(m_boxes, m_roomsAreSwapped, flying, step, drop);
+}
+
 void World::useAlternativeLaraAppearance(const bool withHead)
 {
   const auto& base = *findAnimatedModelForType(TR1ItemId::Lara);
@@ -441,16 +485,13 @@ void World::swapWithAlternate(Room& orig, Room& alternate)
 {
   // find any blocks in the original room and un-patch the floor heights
 
-  for(const auto& object : m_objectManager.getObjects() | boost::adaptors::map_values)
+  for(const auto& entry : m_objectManager.getObjectsByRoom().getObjects(&orig))
   {
-    if(object->m_state.position.room != &orig)
-      continue;
-
-    if(const auto tmp = std::dynamic_pointer_cast<objects::Block>(object.get()))
+    if(const auto tmp = dynamic_cast<objects::Block*>(entry.object.get()))
     {
       patchHeightsForBlock(*tmp, core::SectorSize);
     }
-    else if(const auto tmp2 = std::dynamic_pointer_cast<objects::TallBlock>(object.get()))
+    else if(const auto tmp2 = dynamic_cast<objects::TallBlock*>(entry.object.get()))
     {
       patchHeightsForBlock(*tmp2, core::SectorSize * 2);
     }
@@ -463,42 +504,31 @@ void World::swapWithAlternate(Room& orig, Room& alternate)
   // patch heights in the new room, and swap object ownerships.
   // note that this is exactly the same code as above,
   // except for the heights.
-  for(const auto& object : m_objectManager.getObjects() | boost::adaptors::map_values)
+  for(const auto& entry : m_objectManager.getObjectsByRoom().getObjects(&alternate))
   {
-    if(object->m_state.position.room == &orig)
-    {
-      // although this seems contradictory, remember the nodes have been swapped above
-      setParent(object->getNode(), orig.node);
-    }
-    else if(object->m_state.position.room == &alternate)
-    {
-      setParent(object->getNode(), alternate.node);
-      continue;
-    }
-    else
-    {
-      continue;
-    }
+    setParent(entry.object->getNode(), alternate.node);
+  }
+
+  for(const auto& entry : m_objectManager.getObjectsByRoom().getObjects(&orig))
+  {
+    // although this seems contradictory, remember the nodes have been swapped above
+    setParent(entry.object->getNode(), orig.node);
 
-    if(const auto tmp = std::dynamic_pointer_cast<objects::Block>(object.get()))
+    if(const auto tmp = dynamic_cast<objects::Block*>(entry.object.get()))
     {
       patchHeightsForBlock(*tmp, -core::SectorSize);
     }
-    else if(const auto tmp2 = std::dynamic_pointer_cast<objects::TallBlock>(object.get()))
+    else if(const auto tmp2 = dynamic_cast<objects::TallBlock*>(entry.object.get()))
     {
       patchHeightsForBlock(*tmp2, -core::SectorSize * 2);
     }
   }
 
-  for(const auto& object : m_objectManager.getDynamicObjects())
+  for(const auto* room : {&orig, &alternate})
   {
-    if(object->m_state.position.room == &orig)
-    {
-      setParent(object->getNode(), orig.node);
-    }
-    else if(object->m_state.position.room == &alternate)
+    for(const auto& entry : m_objectManager.getDynamicObjectsByRoom().getObjects(room))
     {
-      setParent(object->getNode(), alternate.node);
+      setParent(entry.object->getNode(), room->node);
     }
   }
 }
@@ -551,6 +581,7 @@ const std::vector<int16_t>& World::getAnimCommands() const
 
 void World::update(const bool godMode)
 {
+  ENGINE_PROFILE_ZONE("World::update");
   m_objectManager.update(*this, godMode);
 
   static constexpr auto UVAnimTime = 10_frame;
@@ -809,6 +840,10 @@ void World::serialize(const serialization::Serializer<World>& ser)
 
   if(ser.loading)
   {
+    // the objects are re-created, and pierre registers himself again when he's updated
+    m_pierre = nullptr;
+    m_pickupWidgets.clear();
+
     getPresenter().getRenderer().getRootNode()->clear();
     for(auto& room : m_rooms)
     {
@@ -851,8 +886,14 @@ void World::serialize(const serialization::Serializer<World>& ser)
 
 void World::gameLoop(bool godMode, float delayRatio, float blackAlpha)
 {
+  ENGINE_PROFILE_ZONE("World::gameLoop");
   ui::Ui ui{getPresenter().getMaterialManager()->getUi(), getPalette()};
+  const auto waterEntryPortals = updateFrame(godMode, ui);
+  presentFrame(std::move(ui), waterEntryPortals, delayRatio, blackAlpha);
+}
 
+std::unordered_set<const Portal*> World::updateFrame(bool godMode, ui::Ui& ui)
+{
   update(godMode);
   m_player->laraHealth = m_objectManager.getLara().m_state.health;
 
@@ -885,6 +926,15 @@ void World::gameLoop(bool godMode, float delayRatio, float blackAlpha)
   }
 
   drawPickupWidgets(ui);
+  drawSavegameFailureNotice(ui);
+  return waterEntryPortals;
+}
+
+void World::presentFrame(ui::Ui ui,
+                         const std::unordered_set<const Portal*>& waterEntryPortals,
+                         float delayRatio,
+                         float blackAlpha)
+{
   getPresenter().renderWorld(getObjectManager(), getRooms(), getCameraController(), waterEntryPortals, delayRatio);
   getPresenter().renderScreenOverlay();
   if(blackAlpha > 0)
@@ -920,56 +970,113 @@ bool World::cinematicLoop()
 void World::load(const std::optional<size_t>& slot)
 {
   getPresenter().drawLoadingScreen(_("Loading..."));
+  m_engine.getSavegameWriter().wait();
   const auto filename = m_engine.getSavegamePath(slot);
   BOOST_LOG_TRIVIAL(info) << "Load " << filename;
   serialization::YAMLDocument<true> doc{filename};
   SavegameMeta meta{};
   doc.load("meta", meta, meta);
-  if(!std::filesystem::equivalent(meta.filename, std::filesystem::relative(m_levelFilename, m_engine.getRootPath())))
+  if(!isSavegameOfThisLevel(meta))
   {
     BOOST_LOG_TRIVIAL(error) << "Savegame mismatch. File is for " << meta.filename << ", but current level is "
                              << m_levelFilename;
     return;
   }
   doc.load("data", *this, *this);
+  finishLoadingState();
+  getPresenter().disableScreenOverlay();
+}
+
+void World::finishLoadingState()
+{
+  // the rooms may be swapped differently, and the camera is moved anyway
+  getPresenter().resetHiZBuffer();
+  getPresenter().resetStaticShadows();
   m_objectManager.getLara().m_state.health = m_player->laraHealth;
   m_objectManager.getLara().initWeaponAnimData();
   connectSectors();
-  getPresenter().disableScreenOverlay();
 }
 
 void World::save(const std::optional<size_t>& slot)
 {
-  getPresenter().drawLoadingScreen(_("Saving..."));
   const auto filename = m_engine.getSavegamePath(slot);
   BOOST_LOG_TRIVIAL(info) << "Save " << filename;
   serialization::YAMLDocument<false> doc{filename};
   SavegameMeta meta{std::filesystem::relative(m_levelFilename, m_engine.getRootPath()).string(), m_title};
   doc.save("meta", meta, meta);
   doc.save("data", *this, *this);
-  doc.write();
-  getPresenter().disableScreenOverlay();
+  // only taking the snapshot needs the world; the deferred nodes are filled, encoded and written in the background
+  m_engine.getSavegameWriter().write(filename, doc.releaseSaved(), !m_engine.getEngineConfig()->yamlSavegames);
+
+  // written after the savegame, so the savegame list can tell whether it's up to date
+  const auto metaFilename = SavegameIndex::getMetaPath(filename);
+  serialization::YAMLDocument<false> metaDoc{metaFilename};
+  metaDoc.save("meta", meta, meta);
+  m_engine.getSavegameWriter().write(metaFilename, metaDoc.releaseSaved(), false);
+}
+
+void World::capturePristineState()
+{
+  m_pristineState = captureState();
+}
+
+std::unique_ptr<ryml::Tree> World::captureState()
+{
+  serialization::YAMLDocument<false> doc;
+  doc.save("data", *this, *this);
+  return std::make_unique<ryml::Tree>(doc.release());
+}
+
+void World::restoreState(const ryml::Tree& state)
+{
+  serialization::YAMLDocument<true> doc{state};
+  doc.load("data", *this, *this);
+  finishLoadingState();
+}
+
+bool World::reload(const std::optional<size_t>& slot)
+{
+  if(m_pristineState == nullptr)
+    return false;
+
+  const auto meta = m_engine.getSavegameMeta(slot);
+  if(!meta.has_value() || !isSavegameOfThisLevel(*meta))
+    return false;
+
+  BOOST_LOG_TRIVIAL(info) << "Resetting level state";
+  // this is what happens when the level is loaded
+  m_audioEngine->stopAll();
+  m_globalSoundEffect.reset();
+  if(m_levelTrack.has_value())
+    m_audioEngine->playStopCdTrack(m_levelTrack.value(), false);
+
+  serialization::YAMLDocument<true> doc{*m_pristineState};
+  doc.load("data", *this, *this);
+  load(slot);
+  return true;
+}
+
+bool World::isSavegameOfThisLevel(const SavegameMeta& meta) const
+{
+  return std::filesystem::equivalent(meta.filename,
+                                     std::filesystem::relative(m_levelFilename, m_engine.getRootPath()));
 }
 
 std::map<size_t, SavegameInfo> World::getSavedGames() const
 {
+  m_engine.getSavegameWriter().wait();
   std::map<size_t, SavegameInfo> result;
   for(size_t i = 0; i < 100; ++i)
   {
-    const auto path = m_engine.getSavegamePath(i);
-    if(!std::filesystem::is_regular_file(path))
-      continue;
-
-    serialization::YAMLDocument<true> doc{path};
-    SavegameMeta meta{};
-    doc.load("meta", meta, meta);
-    result.emplace(i, SavegameInfo{std::move(meta), std::filesystem::last_write_time(path)});
+    if(auto info = m_engine.getSavegameIndex().get(m_engine.getSavegamePath(i)); info.has_value())
+      result.emplace(i, std::move(*info));
   }
   return result;
 }
 
 bool World::hasSavedGames() const
 {
+  m_engine.getSavegameWriter().wait();
   for(size_t i = 0; i < 100; ++i)
   {
     const auto path = m_engine.getSavegamePath(i);
@@ -991,6 +1098,7 @@ World::World(Engine& engine,
              std::shared_ptr<Player> player)
     : m_engine{engine}
     , m_levelFilename{level->getFilename()}
+    , m_levelTrack{track}
     , m_audioEngine{std::make_unique<AudioEngine>(
         *this, engine.getRootPath() / "data" / "tr1" / "AUDIO", engine.getPresenter().getSoundEngine())}
     , m_title{std::move(title)}
@@ -1005,15 +1113,20 @@ World::World(Engine& engine,
   initTextureDependentDataFromLevel(*level);
 
   render::MultiTextureAtlas atlases{2048};
-  m_controllerLayouts = loadControllerButtonIcons(
-    atlases,
-    util::ensureFileExists(m_engine.getRootPath() / "share" / "button-icons" / "buttons.yaml"),
-    getPresenter().getMaterialManager()->getSprite());
+  const auto buttonIconsPath = m_engine.getRootPath() / "share" / "button-icons";
+  m_controllerLayouts = loadControllerButtonIcons(atlases,
+                                                  util::ensureFileExists(buttonIconsPath / "buttons.yaml"),
+                                                  getPresenter().getMaterialManager()->getSprite());
+  const TextureCache textureCache{
+    TextureCache::getPath(m_engine.getCacheRootPath(),
+                          std::filesystem::relative(m_levelFilename, m_engine.getRootPath())),
+    TextureCache::createKey(*level, m_engine.getGlidos(), buttonIconsPath, atlases.getSize())};
   m_allTextures = buildTextures(*level,
                                 m_engine.getGlidos(),
                                 atlases,
                                 m_atlasTiles,
                                 m_sprites,
+                                textureCache,
                                 [this](const std::string& s) { getPresenter().drawLoadingScreen(s); });
 
   auto sampler = std::make_unique<gl::Sampler>("all-textures");
@@ -1055,6 +1168,9 @@ World::World(Engine& engine,
   getPresenter().drawLoadingScreen(util::unescape(m_title));
 
   initFromLevel(*level);
+  // the occlusion depth and the scenery shadows may still be the ones of the previous level
+  getPresenter().resetHiZBuffer();
+  getPresenter().resetStaticShadows();
 
   if(useAlternativeLara)
   {
@@ -1088,6 +1204,21 @@ void World::drawPickupWidgets(ui::Ui& ui)
   }
 }
 
+void World::drawSavegameFailureNotice(ui::Ui& ui)
+{
+  if(!m_engine.getSavegameWriter().takeFailures().empty())
+    m_savegameFailureNoticeTime = 150_frame;
+
+  if(m_savegameFailureNoticeTime <= 0_frame)
+    return;
+
+  m_savegameFailureNoticeTime -= 1_frame;
+  const ui::Text text{/* translators: TR charmap encoding */ _("SAVING FAILED")};
+  text.draw(ui,
+            getPresenter().getTrFont(),
+            glm::ivec2{(getPresenter().getViewport().x - text.getWidth()) / 2, getPresenter().getViewport().y / 4});
+}
+
 const Presenter& World::getPresenter() const
 {
   return m_engine.getPresenter();
@@ -1310,14 +1441,12 @@ void World::initFromLevel(loader::file::level::Level& level)
 
   for(const auto& staticMesh : level.m_staticMeshes)
   {
-    RenderMeshDataCompositor compositor;
-    compositor.append(*meshesDirect.at(staticMesh.mesh)->meshData);
     const bool distinct = m_staticMeshes
                             .emplace(staticMesh.id,
                                      StaticMesh{staticMesh.collision_box,
                                                 staticMesh.doNotCollide(),
                                                 staticMesh.isVisible(),
-                                                compositor.toMesh(*getPresenter().getMaterialManager(), false, {})})
+                                                meshesDirect.at(staticMesh.mesh)->meshData})
                             .second;
 
     Expects(distinct);
@@ -6,6 +6,7 @@
 #include "box.h"
 #include "camerasink.h"
 #include "cinematicframe.h"
+#include "engine/ai/boxgraph.h"
 #include "engine/controllerbuttons.h"
 #include "engine/floordata/floordata.h"
 #include "engine/objectmanager.h"
@@ -20,7 +21,14 @@
 #include "transition.h"
 #include "ui/pickupwidget.h"
 
+#include <map>
 #include <pybind11/pytypes.h>
+#include <unordered_set>
+
+namespace c4::yml
+{
+class Tree;
+}
 
 namespace gl
 {
@@ -50,6 +58,11 @@ class TextureAnimator;
 class MultiTextureAtlas;
 } // namespace render
 
+namespace render::scene
+{
+class Renderable;
+}
+
 namespace engine::objects
 {
 class ModelObject;
@@ -62,6 +75,7 @@ class Presenter;
 class Engine;
 class AudioEngine;
 struct SavegameInfo;
+struct SavegameMeta;
 class CameraController;
 class Player;
 enum class TR1TrackId : int32_t;
@@ -168,10 +182,19 @@ public:
   bool isValid(const loader::file::AnimFrame* frame) const;
   void swapWithAlternate(Room& orig, Room& alternate);
   [[nodiscard]] const std::vector<Box>& getBoxes() const;
+  //! The box graph for path finders with the given movement limits, matching the current state of the rooms.
+  [[nodiscard]] std::shared_ptr<const ai::BoxGraph>
+    getBoxGraph(bool flying, const core::Length& step, const core::Length& drop) const;
   [[nodiscard]] const std::vector<Room>& getRooms() const;
   std::vector<Room>& getRooms();
   [[nodiscard]] const StaticMesh* findStaticMeshById(core::StaticMeshId meshId) const;
   [[nodiscard]] const std::unique_ptr<SpriteSequence>& findSpriteSequenceForType(core::TypeId type) const;
+
+  using RenderableSequence = std::vector<gsl::not_null<std::shared_ptr<render::scene::Renderable>>>;
+  //! The renderables of a particle type, i.e. its sprite frames or model bones; built once and shared by all
+  //! particles of that type. Returns an empty sequence if the type has neither a sprite sequence nor a model.
+  [[nodiscard]] const gsl::not_null<std::shared_ptr<const RenderableSequence>>&
+    getParticleRenderables(core::TypeId type);
   [[nodiscard]] const Animation& getAnimation(loader::file::AnimationId id) const;
   [[nodiscard]] const std::vector<CinematicFrame>& getCinematicFrames() const;
   [[nodiscard]] const std::vector<int16_t>& getAnimCommands() const;
@@ -209,9 +232,28 @@ public:
   core::TypeId find(const Sprite* sprite) const;
   void serialize(const serialization::Serializer<World>& ser);
   void gameLoop(bool godMode, float delayRatio, float blackAlpha);
+  //! Advances the simulation by one tick and draws the HUD into @a ui; returns the portals to render for presentFrame.
+  std::unordered_set<const Portal*> updateFrame(bool godMode, ui::Ui& ui);
+  void presentFrame(ui::Ui ui,
+                    const std::unordered_set<const Portal*>& waterEntryPortals,
+                    float delayRatio,
+                    float blackAlpha);
   bool cinematicLoop();
   void load(const std::optional<size_t>& slot);
   void save(const std::optional<size_t>& slot);
+  //! Keeps the current state of the level, so reload() can return to it; must be called before the level is played.
+  void capturePristineState();
+  //! Serializes the current state of the level in memory, the same way as a savegame.
+  [[nodiscard]] std::unique_ptr<c4::yml::Tree> captureState();
+  //! Applies a state returned by captureState() in place, the same way as loading a savegame.
+  void restoreState(const c4::yml::Tree& state);
+  /**
+   * @brief Applies a savegame to this level without loading the level again.
+   *
+   * The level is reset to the state kept by capturePristineState() first, so the result is the same as loading the
+   * savegame into a freshly loaded level. Returns false if the savegame belongs to another level, or no state was kept.
+   */
+  bool reload(const std::optional<size_t>& slot);
   [[nodiscard]] std::map<size_t, SavegameInfo> getSavedGames() const;
   [[nodiscard]] bool hasSavedGames() const;
 
@@ -323,9 +365,16 @@ public:
 
 private:
   void drawPickupWidgets(ui::Ui& ui);
+  //! Tells the player for a while if a savegame could not be written in the background.
+  void drawSavegameFailureNotice(ui::Ui& ui);
+  [[nodiscard]] bool isSavegameOfThisLevel(const SavegameMeta& meta) const;
+  //! Re-creates everything derived from the serialized state after it has been loaded.
+  void finishLoadingState();
 
   Engine& m_engine;
   const std::filesystem::path m_levelFilename;
+  const std::optional<TR1TrackId> m_levelTrack;
+  std::unique_ptr<c4::yml::Tree> m_pristineState;
 
   std::unique_ptr<AudioEngine> m_audioEngine;
 
@@ -372,6 +421,7 @@ private:
   std::unique_ptr<render::TextureAnimator> m_textureAnimator;
 
   std::vector<ui::PickupWidget> m_pickupWidgets{};
+  core::Frame m_savegameFailureNoticeTime = 0_frame;
   const std::shared_ptr<Player> m_player;
 
   std::vector<int16_t> m_poseFrames;
@@ -385,11 +435,13 @@ private:
   std::vector<Transitions> m_transitions;
   std::vector<TransitionCase> m_transitionCases;
   std::vector<Box> m_boxes;
+  mutable ai::BoxGraphCache m_boxGraphs;
   std::unordered_map<core::StaticMeshId, StaticMesh> m_staticMeshes;
   std::vector<Mesh> m_meshes;
   std::map<core::TypeId, std::unique_ptr<SkeletalModelType>> m_animatedModels;
   std::vector<Sprite> m_sprites;
   std::map<core::TypeId, std::unique_ptr<SpriteSequence>> m_spriteSequences;
+  std::map<core::TypeId, gsl::not_null<std::shared_ptr<const RenderableSequence>>> m_particleRenderables;
   std::vector<AtlasTile> m_atlasTiles;
   std::vector<Room> m_rooms;
   std::vector<CinematicFrame> m_cinematicFrames;
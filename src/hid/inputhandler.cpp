@@ -181,10 +181,14 @@ void InputHandler::update()
     }
   }
 
+  setActionStates(states);
+}
+
+void InputHandler::setActionStates(const boost::container::flat_map<Action, bool>& states)
+{
   for(const auto& [action, state] : states)
   {
-    auto it = states.find(action);
-    m_inputState.actions[action] = it->second;
+    m_inputState.actions[action] = state;
   }
   m_inputState.setXAxisMovement(m_inputState.actions[Action::Left], m_inputState.actions[Action::Right]);
   m_inputState.setZAxisMovement(m_inputState.actions[Action::Backward], m_inputState.actions[Action::Forward]);
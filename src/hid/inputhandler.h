@@ -22,6 +22,8 @@ public:
   void setMappings(const std::vector<engine::NamedInputMappingConfig>& inputMappings);
 
   void update();
+  //! Replaces the device state with the given action states, e.g. for replaying scripted input.
+  void setActionStates(const boost::container::flat_map<Action, bool>& states);
 
   [[nodiscard]] const InputState& getInputState() const
   {
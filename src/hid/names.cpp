@@ -202,6 +202,7 @@ std::string getName(Action action)
   case Action::StepRight: return /* translators: TR charmap encoding */ pgettext("Action", "Step Right");
   case Action::CheatDive: return /* translators: TR charmap encoding */ pgettext("Action", "Cheat Dive");
   case Action::Screenshot: return /* translators: TR charmap encoding */ pgettext("Action", "Screenshot");
+  case Action::Profile: return /* translators: TR charmap encoding */ pgettext("Action", "Save Profile");
   }
   BOOST_THROW_EXCEPTION(std::domain_error("action"));
 }
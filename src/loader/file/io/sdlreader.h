@@ -2,15 +2,20 @@
 
 #include "type_safe/integer.hpp"
 
-#include <boost/iostreams/device/array.hpp>
-#include <boost/iostreams/device/file.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/throw_exception.hpp>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
-#include <iostream>
+#include <gsl/gsl-lite.hpp>
+#include <ios>
 #include <memory>
 #include <stdexcept>
+#include <system_error>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <zlib.h>
@@ -23,8 +28,12 @@ struct quantity;
 
 namespace loader::file::io
 {
-using DataStreamBuf = boost::iostreams::filtering_istreambuf;
-
+/**
+ * @brief Reads little-endian level data from memory.
+ *
+ * Files are memory-mapped instead of being read through a stream, so seeking is free, and arrays of plain numbers are
+ * copied in bulk.
+ */
 class SDLReader
 {
 public:
@@ -34,35 +43,48 @@ public:
 
   SDLReader& operator=(SDLReader&&) = delete;
 
-  explicit SDLReader(std::shared_ptr<DataStreamBuf> stream)
-      : m_streamBuf{std::move(stream)}
-      , m_stream{m_streamBuf.get()}
-  {
-  }
-
   SDLReader(SDLReader&& rhs) noexcept
-      : m_memory{move(rhs.m_memory)}
-      , m_file{move(rhs.m_file)}
-      , m_array{move(rhs.m_array)}
-      , m_streamBuf{move(rhs.m_streamBuf)}
-      , m_stream{m_streamBuf.get()}
+      : m_storage{std::move(rhs.m_storage)}
+      , m_data{std::exchange(rhs.m_data, nullptr)}
+      , m_size{std::exchange(rhs.m_size, 0)}
+      , m_position{std::exchange(rhs.m_position, 0)}
+      , m_isOpen{std::exchange(rhs.m_isOpen, false)}
   {
   }
 
   explicit SDLReader(const std::filesystem::path& filename)
-      : m_file{std::make_unique<boost::iostreams::file>(
-        filename.string(), std::ios::in | std::ios::binary, std::ios::in | std::ios::binary)}
-      , m_streamBuf{std::make_shared<DataStreamBuf>(*m_file)}
-      , m_stream{m_streamBuf.get()}
   {
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(filename, ec);
+    if(ec)
+      return;
+
+    if(fileSize > 0)
+    {
+      try
+      {
+        const boost::interprocess::file_mapping file{filename.string().c_str(), boost::interprocess::read_only};
+        auto region = std::make_shared<boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+        m_data = static_cast<const uint8_t*>(region->get_address());
+        m_size = region->get_size();
+        m_storage = std::move(region);
+      }
+      catch(const boost::interprocess::interprocess_exception&)
+      {
+        return;
+      }
+    }
+
+    m_isOpen = true;
   }
 
   explicit SDLReader(std::vector<char> data)
-      : m_memory{std::move(data)}
-      , m_array{std::make_unique<boost::iostreams::array>(m_memory.data(), m_memory.size())}
-      , m_streamBuf{std::make_shared<DataStreamBuf>(*m_array)}
-      , m_stream{m_streamBuf.get()}
   {
+    auto storage = std::make_shared<std::vector<char>>(std::move(data));
+    m_data = reinterpret_cast<const uint8_t*>(storage->data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_size = storage->size();
+    m_storage = std::move(storage);
+    m_isOpen = true;
   }
 
   ~SDLReader() = default;
@@ -91,42 +113,60 @@ public:
 
   [[nodiscard]] bool isOpen() const
   {
-    return !m_stream.bad();
+    return m_isOpen;
   }
 
-  std::streampos tell()
+  [[nodiscard]] std::streampos tell() const
   {
-    return m_stream.tellg();
+    return static_cast<std::streamoff>(m_position);
   }
 
-  std::streamsize size()
+  [[nodiscard]] std::streamsize size() const
   {
-    const auto pos = m_stream.tellg();
-    m_stream.seekg(0, std::ios::end);
-    const auto size = m_stream.tellg();
-    m_stream.seekg(pos, std::ios::beg);
-    return size;
+    return static_cast<std::streamsize>(m_size);
   }
 
   void skip(const std::streamoff delta)
   {
-    m_stream.seekg(delta, std::ios::cur);
+    seek(tell() + delta);
   }
 
   void seek(const std::streampos position)
   {
-    m_stream.seekg(position, std::ios::beg);
+    if(position < 0 || static_cast<size_t>(static_cast<std::streamoff>(position)) > m_size)
+    {
+      BOOST_THROW_EXCEPTION(std::out_of_range("Seek position out of range"));
+    }
+    m_position = static_cast<size_t>(static_cast<std::streamoff>(position));
   }
 
   template<typename T>
   void readBytes(T* dest, const size_t n)
   {
     static_assert(std::is_integral_v<T> && sizeof(T) == 1, "readBytes() only allowed for byte-compatible data");
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    m_stream.read(reinterpret_cast<char*>(dest), n);
-    if(static_cast<size_t>(m_stream.gcount()) != n)
+    std::copy_n(consume(n), n, dest);
+  }
+
+  //! Fills @a elements with consecutive values; plain numbers are copied in one go.
+  template<typename T>
+  void readElements(const gsl::span<T>& elements)
+  {
+    if constexpr(std::is_arithmetic_v<T>)
     {
-      BOOST_THROW_EXCEPTION(std::runtime_error("EOF unexpectedly reached"));
+      const auto byteSize = elements.size() * sizeof(T);
+      const auto source = consume(byteSize);
+      if(byteSize != 0)
+        std::memcpy(elements.data(), source, byteSize);
+      if constexpr(sizeof(T) > 1 && boost::endian::order::native != boost::endian::order::little)
+      {
+        for(auto& element : elements)
+          SwapTraits<T, sizeof(T), true>::doSwap(element);
+      }
+    }
+    else
+    {
+      for(auto& element : elements)
+        element = read<T>();
     }
   }
 
@@ -174,10 +214,18 @@ public:
   void readVector(std::vector<T>& elements, size_t count)
   {
     elements.clear();
-    elements.reserve(count);
-    for(size_t i = 0; i < count; ++i)
+    if constexpr(std::is_arithmetic_v<T>)
+    {
+      elements.resize(count);
+      readElements(gsl::span<T>{elements.data(), count});
+    }
+    else
     {
-      elements.emplace_back(read<T>());
+      elements.reserve(count);
+      for(size_t i = 0; i < count; ++i)
+      {
+        elements.emplace_back(read<T>());
+      }
     }
   }
 
@@ -198,7 +246,7 @@ public:
   template<typename T>
   T read()
   {
-    return ReadTraits<T>::read(m_stream);
+    return ReadTraits<T>::read(*this);
   }
 
   uint8_t readU8()
@@ -237,16 +285,25 @@ public:
   }
 
 private:
-  // Do not change the order of these member variables.
-  std::vector<char> m_memory;
-
-  std::unique_ptr<boost::iostreams::file> m_file;
-
-  std::unique_ptr<boost::iostreams::array> m_array;
+  //! Keeps the memory mapping or the decompressed data alive.
+  std::shared_ptr<const void> m_storage;
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_position = 0;
+  bool m_isOpen = false;
 
-  std::shared_ptr<DataStreamBuf> m_streamBuf;
+  //! Returns the next @a n bytes, and advances the read position past them.
+  const uint8_t* consume(const size_t n)
+  {
+    if(m_position > m_size || n > m_size - m_position)
+    {
+      BOOST_THROW_EXCEPTION(std::runtime_error("EOF unexpectedly reached"));
+    }
 
-  std::istream m_stream;
+    const auto result = m_data + m_position;
+    m_position += n;
+    return result;
+  }
 
   template<typename T, int dataSize, bool isIntegral>
   struct SwapTraits
@@ -256,9 +313,14 @@ private:
   template<typename T, int dataSize>
   struct SwapTraits<T, dataSize, true>
   {
-    static void doSwap(T& /*data*/)
+    static void doSwap(T& data)
     {
-      //! @todo For now, no endian conversion
+      // level data is little-endian
+      if constexpr(boost::endian::order::native != boost::endian::order::little)
+      {
+        auto bytes = reinterpret_cast<uint8_t*>(&data); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        std::reverse(bytes, bytes + dataSize);
+      }
     }
   };
 
@@ -287,15 +349,10 @@ private:
   template<typename T>
   struct ReadTraits
   {
-    static T read(std::istream& stream)
+    static T read(SDLReader& reader)
     {
       T result;
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-      stream.read(reinterpret_cast<char*>(&result), sizeof(T));
-      if(stream.gcount() != sizeof(T))
-      {
-        BOOST_THROW_EXCEPTION(std::runtime_error("EOF unexpectedly reached"));
-      }
+      std::memcpy(&result, reader.consume(sizeof(T)), sizeof(T));
 
       SwapTraits<T, sizeof(T), std::is_integral_v<T> || std::is_floating_point_v<T>>::doSwap(result);
 
@@ -306,9 +363,9 @@ private:
   template<typename T>
   struct ReadTraits<type_safe::integer<T>>
   {
-    static type_safe::integer<T> read(std::istream& stream)
+    static type_safe::integer<T> read(SDLReader& reader)
     {
-      return type_safe::integer<T>{ReadTraits<T>::read(stream)};
+      return type_safe::integer<T>{ReadTraits<T>::read(reader)};
     }
   };
 };
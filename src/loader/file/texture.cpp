@@ -5,6 +5,7 @@
 
 #include <boost/log/trivial.hpp>
 #include <gl/image.h>
+#include <vector>
 
 namespace loader::file
 {
@@ -17,11 +18,14 @@ std::unique_ptr<DWordTexture> DWordTexture::read(io::SDLReader& reader)
 {
   auto texture = std::make_unique<DWordTexture>();
 
+  std::vector<uint32_t> argb;
+  reader.readVector(argb, 256 * 256);
+  auto src = argb.cbegin();
   for(auto& row : texture->pixels)
   {
     for(auto& element : row)
     {
-      const auto tmp = reader.readU32(); // format is ARGB
+      const auto tmp = *src++; // format is ARGB
       const uint8_t a = (tmp >> 24u) & 0xffu;
       const uint8_t r = (tmp >> 16u) & 0xffu;
       const uint8_t g = (tmp >> 8u) & 0xffu;
@@ -48,7 +52,7 @@ std::unique_ptr<WordTexture> WordTexture::read(io::SDLReader& reader)
 
   for(auto& row : texture->pixels)
   {
-    std::generate(row.begin(), row.end(), [&reader]() { return reader.readU16(); });
+    reader.readElements(gsl::span<uint16_t>{row.data(), row.size()});
   }
 
   return texture;
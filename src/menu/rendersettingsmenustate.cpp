@@ -185,6 +185,14 @@ RenderSettingsMenuState::RenderSettingsMenuState(const std::shared_ptr<MenuRingT
       auto& b = engine.getEngineConfig()->displaySettings.performanceMeter;
       b = !b;
     });
+  listBox->addSetting(
+    /* translators: TR charmap encoding */ _("Smooth Motion"),
+    [&engine]() { return engine.getEngineConfig()->displaySettings.interpolateFrames; },
+    [&engine]()
+    {
+      auto& b = engine.getEngineConfig()->displaySettings.interpolateFrames;
+      b = !b;
+    });
 }
 
 std::unique_ptr<MenuState>
@@ -0,0 +1,106 @@
+#include "hizpass.h"
+
+#include "config.h"
+#include "render/scene/material.h"
+#include "render/scene/materialmanager.h"
+#include "render/scene/mesh.h"
+#include "render/scene/rendercontext.h"
+
+#include <gl/debuggroup.h>
+#include <gl/framebuffer.h>
+#include <gl/texture2d.h>
+#include <vector>
+
+namespace render::pass
+{
+HiZPass::HiZPass(scene::MaterialManager& materialManager,
+                 const glm::ivec2& viewport,
+                 const std::shared_ptr<gl::TextureHandle<gl::TextureDepth<float>>>& depth)
+    : m_material{materialManager.getHiZDownsample()}
+    , m_renderMesh{scene::createScreenQuad(m_material, "hiz")}
+    , m_size{(viewport + BlockSize - 1) / BlockSize}
+    , m_texture{std::make_shared<gl::Texture2D<gl::Scalar32F>>(m_size, "hiz-depth")}
+{
+  m_renderMesh->bind(
+    "u_depth",
+    [depth](const render::scene::Node& /*node*/, const render::scene::Mesh& /*mesh*/, gl::Uniform& uniform)
+    { uniform.set(depth); });
+
+  m_fb = gl::FrameBufferBuilder()
+           .textureNoBlend(gl::api::FramebufferAttachment::ColorAttachment0, m_texture)
+           .build("hiz-fb");
+
+  const std::vector<float> empty(static_cast<size_t>(m_size.x) * static_cast<size_t>(m_size.y));
+  for(size_t i = 0; i < ReadbackCount; ++i)
+  {
+    auto& readback = m_readbacks[i];
+    readback.buffer = std::make_unique<gl::Buffer<float, gl::api::BufferTarget::PixelPackBuffer>>(
+      "hiz-readback/" + std::to_string(i));
+    readback.buffer->setData(empty, gl::api::BufferUsage::StreamRead);
+  }
+}
+
+void HiZPass::reset()
+{
+  // the pending readbacks still complete, but they are never used
+  for(auto& readback : m_readbacks)
+    readback.fence.reset();
+  m_hiZBuffer.reset();
+}
+
+void HiZPass::render(const glm::mat4& viewProjection)
+{
+  SOGLB_DEBUGGROUP("hiz-pass");
+
+  // readbacks complete in the order they were issued, so only the newest completed one is of interest
+  Readback* completed = nullptr;
+  for(size_t i = 0; i < ReadbackCount; ++i)
+  {
+    auto& readback = m_readbacks[(m_next + i) % ReadbackCount];
+    if(!readback.fence.has_value())
+      continue;
+    if(!readback.fence->isSignaled())
+      break;
+
+    readback.fence.reset();
+    completed = &readback;
+  }
+
+  if(completed != nullptr)
+  {
+    const auto* data = completed->buffer->map();
+    std::vector<float> depths{data, data + completed->buffer->size()};
+    completed->buffer->unmap();
+    m_hiZBuffer.assign(std::move(depths), m_size, completed->viewProjection);
+  }
+
+  auto& readback = m_readbacks[m_next];
+  // the GPU is too far behind, so don't queue even more work
+  if(readback.fence.has_value())
+    return;
+
+  m_fb->bindWithAttachments();
+
+  gl::RenderState::resetWantedState();
+  gl::RenderState::getWantedState().setBlend(false);
+  gl::RenderState::getWantedState().setViewport(m_size);
+  scene::RenderContext context{scene::RenderMode::Full, std::nullopt};
+
+  m_renderMesh->render(context);
+
+  readback.buffer->bind();
+  GL_ASSERT(gl::api::getTextureImage(m_texture->getHandle(),
+                                     0,
+                                     gl::Scalar32F::PixelFormat,
+                                     gl::Scalar32F::PixelType,
+                                     gsl::narrow<gl::api::core::SizeType>(sizeof(float) * readback.buffer->size()),
+                                     nullptr));
+  readback.buffer->unbind();
+  readback.fence.emplace();
+  readback.viewProjection = viewProjection;
+  m_next = (m_next + 1) % ReadbackCount;
+
+  if constexpr(FlushPasses)
+    GL_ASSERT(gl::api::finish());
+}
+} // namespace render::pass
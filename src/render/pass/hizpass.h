@@ -0,0 +1,71 @@
+#pragma once
+
+#include "render/scene/hizbuffer.h"
+
+#include <array>
+#include <gl/buffer.h>
+#include <gl/fence.h>
+#include <gl/pixel.h>
+#include <gl/soglb_fwd.h>
+#include <gl/texturedepth.h>
+#include <glm/glm.hpp>
+#include <gsl/gsl-lite.hpp>
+#include <optional>
+
+namespace render::scene
+{
+class MaterialManager;
+class Material;
+class Mesh;
+} // namespace render::scene
+
+namespace render::pass
+{
+/**
+ * @brief Downsamples the depth buffer and reads it back to the CPU without stalling.
+ *
+ * Readbacks complete a few frames later, so the occlusion data lags behind the rendered frame.
+ */
+class HiZPass
+{
+public:
+  //! The size of the depth buffer area covered by a single texel of the downsampled depth; must match
+  //! hiz_downsample.frag.
+  static constexpr int BlockSize = 8;
+
+  explicit HiZPass(scene::MaterialManager& materialManager,
+                   const glm::ivec2& viewport,
+                   const std::shared_ptr<gl::TextureHandle<gl::TextureDepth<float>>>& depth);
+
+  //! Captures the current depth, which was rendered with @a viewProjection, and collects completed readbacks.
+  void render(const glm::mat4& viewProjection);
+
+  [[nodiscard]] const auto& getHiZBuffer() const
+  {
+    return m_hiZBuffer;
+  }
+
+  //! Discards the captured depth including all pending readbacks, e.g. when the level geometry changes.
+  void reset();
+
+private:
+  struct Readback
+  {
+    std::unique_ptr<gl::Buffer<float, gl::api::BufferTarget::PixelPackBuffer>> buffer;
+    std::optional<gl::Fence> fence;
+    glm::mat4 viewProjection{1.0f};
+  };
+
+  static constexpr size_t ReadbackCount = 3;
+
+  const std::shared_ptr<scene::Material> m_material;
+  std::shared_ptr<scene::Mesh> m_renderMesh;
+  const glm::ivec2 m_size;
+  std::shared_ptr<gl::Texture2D<gl::Scalar32F>> m_texture;
+  std::shared_ptr<gl::Framebuffer> m_fb;
+  std::array<Readback, ReadbackCount> m_readbacks;
+  //! The readback to issue next, which is also the oldest one still pending, if any.
+  size_t m_next = 0;
+  scene::HiZBuffer m_hiZBuffer;
+};
+} // namespace render::pass
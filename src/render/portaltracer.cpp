@@ -4,16 +4,20 @@
 #include "engine/world/world.h"
 #include "scene/camera.h"
 
+#include <algorithm>
 #include <boost/range/adaptor/transformed.hpp>
 
 namespace render
 {
+namespace
+{
+constexpr auto Eps = 1.0f / (1 << 14);
+}
+
 std::optional<PortalTracer::CullBox> PortalTracer::narrowCullBox(const PortalTracer::CullBox& parentCullBox,
                                                                  const engine::world::Portal& portal,
                                                                  const engine::CameraController& camera)
 {
-  static constexpr auto Eps = 1.0f / (1 << 14);
-
   if(dot(portal.normal, portal.vertices[0] - camera.getPosition()) >= 0)
   {
     return std::nullopt; // wrong orientation (normals must face the camera)
@@ -128,14 +132,31 @@ std::optional<PortalTracer::CullBox> PortalTracer::narrowCullBox(const PortalTra
 bool PortalTracer::traceRoom(const engine::world::Room& room,
                              const PortalTracer::CullBox& roomCullBox,
                              const engine::world::World& world,
-                             std::vector<const engine::world::Room*>& seenRooms,
+                             TraceState& state,
                              const bool inWater,
-                             std::unordered_set<const engine::world::Portal*>& waterSurfacePortals,
                              const bool startFromWater)
 {
-  if(std::find(seenRooms.rbegin(), seenRooms.rend(), &room) != seenRooms.rend())
+  if(std::find(state.path.rbegin(), state.path.rend(), &room) != state.path.rend())
     return false;
-  seenRooms.emplace_back(&room);
+
+  // a room reachable through many portal chains is only traversed again if it is seen through a screen area that is
+  // not within an area it has been traversed with before, as the rooms behind it can't become more visible otherwise;
+  // the areas must not be merged, as the union of two areas covers parts of the screen neither of them is seen through
+  auto& tracedCullBoxes = state.tracedCullBoxes[inWater ? 1 : 0][&room];
+  if(std::any_of(tracedCullBoxes.begin(),
+                 tracedCullBoxes.end(),
+                 [&roomCullBox](const CullBox& tracedCullBox) { return tracedCullBox.contains(roomCullBox, Eps); }))
+  {
+    return true;
+  }
+  tracedCullBoxes.erase(std::remove_if(tracedCullBoxes.begin(),
+                                       tracedCullBoxes.end(),
+                                       [&roomCullBox](const CullBox& tracedCullBox)
+                                       { return roomCullBox.contains(tracedCullBox, Eps); }),
+                        tracedCullBoxes.end());
+  tracedCullBoxes.emplace_back(roomCullBox);
+
+  state.path.emplace_back(&room);
 
   room.node->setVisible(true);
   for(const auto& portal : room.portals)
@@ -144,32 +165,42 @@ bool PortalTracer::traceRoom(const engine::world::Room& room,
     {
       const auto& childRoom = portal.adjoiningRoom;
       const bool waterChanged = inWater == startFromWater && childRoom->isWaterRoom != startFromWater;
-      if(traceRoom(*childRoom,
-                   *narrowedCullBox,
-                   world,
-                   seenRooms,
-                   inWater || childRoom->isWaterRoom,
-                   waterSurfacePortals,
-                   startFromWater)
+      if(traceRoom(*childRoom, *narrowedCullBox, world, state, inWater || childRoom->isWaterRoom, startFromWater)
          && waterChanged)
       {
-        waterSurfacePortals.emplace(&portal);
+        state.waterSurfacePortals.emplace(&portal);
       }
     }
   }
-  seenRooms.pop_back();
+  state.path.pop_back();
   return true;
 }
 
 std::unordered_set<const engine::world::Portal*> PortalTracer::trace(const engine::world::Room& startRoom,
-                                                                     const engine::world::World& world)
+                                                                     const engine::world::World& world,
+                                                                     RoomCullBoxes& roomCullBoxes)
 {
-  std::vector<const engine::world::Room*> seenRooms;
-  seenRooms.reserve(32);
-  std::unordered_set<const engine::world::Portal*> waterSurfacePortals;
-  traceRoom(
-    startRoom, {-1, -1, 1, 1}, world, seenRooms, startRoom.isWaterRoom, waterSurfacePortals, startRoom.isWaterRoom);
-  Expects(seenRooms.empty());
-  return waterSurfacePortals;
+  TraceState state;
+  state.path.reserve(32);
+  traceRoom(startRoom, {-1, -1, 1, 1}, world, state, startRoom.isWaterRoom, startRoom.isWaterRoom);
+  Expects(state.path.empty());
+
+  // the screen area of a room is the union of all areas it's seen through
+  roomCullBoxes.clear();
+  for(const auto& tracedCullBoxes : state.tracedCullBoxes)
+  {
+    for(const auto& [room, cullBoxes] : tracedCullBoxes)
+    {
+      for(const auto& cullBox : cullBoxes)
+      {
+        if(const auto it = roomCullBoxes.find(room); it != roomCullBoxes.end())
+          it->second.extend(cullBox);
+        else
+          roomCullBoxes.emplace(room, cullBox);
+      }
+    }
+  }
+
+  return std::move(state.waterSurfacePortals);
 }
 } // namespace render
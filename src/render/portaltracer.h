@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
 #include <glm/glm.hpp>
 #include <gsl/gsl-lite.hpp>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -32,17 +34,56 @@ struct PortalTracer
         , max{maxX, maxY}
     {
     }
+
+    [[nodiscard]] bool contains(const CullBox& other, float eps) const
+    {
+      return other.min.x >= min.x - eps && other.min.y >= min.y - eps && other.max.x <= max.x + eps
+             && other.max.y <= max.y + eps;
+    }
+
+    void extend(const CullBox& other)
+    {
+      min = glm::min(min, other.min);
+      max = glm::max(max, other.max);
+    }
+
+    //! Returns a matrix that maps this box to the full clip space when applied after a projection matrix.
+    [[nodiscard]] glm::mat4 getCropMatrix() const
+    {
+      const auto center = (min + max) / 2.0f;
+      const auto halfSize = (max - min) / 2.0f;
+      glm::mat4 result{1.0f};
+      result[0][0] = 1 / halfSize.x;
+      result[1][1] = 1 / halfSize.y;
+      result[3][0] = -center.x / halfSize.x;
+      result[3][1] = -center.y / halfSize.y;
+      return result;
+    }
+  };
+
+  using RoomCullBoxes = std::unordered_map<const engine::world::Room*, CullBox>;
+
+  struct TraceState
+  {
+    //! The rooms on the current portal path.
+    std::vector<const engine::world::Room*> path{};
+    //! All cull boxes a room has been entered with, separately for paths that have been in water or not.
+    std::array<std::unordered_map<const engine::world::Room*, std::vector<CullBox>>, 2> tracedCullBoxes{};
+    std::unordered_set<const engine::world::Portal*> waterSurfacePortals{};
   };
 
-  static std::unordered_set<const engine::world::Portal*> trace(const engine::world::Room& startRoom,
-                                                                const engine::world::World& world);
+  /**
+   * @brief Determines the visible rooms and the water surface portals.
+   * @param[out] roomCullBoxes receives the screen area each visible room can be seen through
+   */
+  static std::unordered_set<const engine::world::Portal*>
+    trace(const engine::world::Room& startRoom, const engine::world::World& world, RoomCullBoxes& roomCullBoxes);
 
   static bool traceRoom(const engine::world::Room& room,
                         const CullBox& roomCullBox,
                         const engine::world::World& world,
-                        std::vector<const engine::world::Room*>& seenRooms,
+                        TraceState& state,
                         bool inWater,
-                        std::unordered_set<const engine::world::Portal*>& waterSurfacePortals,
                         bool startFromWater);
 
   static std::optional<CullBox> narrowCullBox(const CullBox& parentCullBox,
@@ -1,9 +1,11 @@
 #include "renderpipeline.h"
 
+#include "engine/profiler.h"
 #include "pass/compositionpass.h"
 #include "pass/fxaapass.h"
 #include "pass/geometrypass.h"
 #include "pass/hbaopass.h"
+#include "pass/hizpass.h"
 #include "pass/linearizedepthpass.h"
 #include "pass/portalpass.h"
 #include "pass/uipass.h"
@@ -22,19 +24,32 @@ RenderPipeline::RenderPipeline(scene::MaterialManager& materialManager, const gl
 
 void RenderPipeline::compositionPass(const bool water)
 {
+  ENGINE_PROFILE_GPU_ZONE("composition-pass");
   BOOST_ASSERT(m_portalPass != nullptr);
   if(m_renderSettings.waterDenoise)
+  {
+    ENGINE_PROFILE_GPU_ZONE("portal-blur-pass");
     m_portalPass->renderBlur();
+  }
   BOOST_ASSERT(m_hbaoPass != nullptr);
   if(m_renderSettings.hbao)
+  {
+    ENGINE_PROFILE_GPU_ZONE("hbao-pass");
     m_hbaoPass->render(m_size);
+  }
   BOOST_ASSERT(m_fxaaPass != nullptr);
   if(m_renderSettings.fxaa)
+  {
+    ENGINE_PROFILE_GPU_ZONE("fxaa-pass");
     m_fxaaPass->render(m_size);
-  BOOST_ASSERT(m_linearizeDepthPass != nullptr);
-  m_linearizeDepthPass->render();
-  BOOST_ASSERT(m_linearizePortalDepthPass != nullptr);
-  m_linearizePortalDepthPass->render();
+  }
+  {
+    ENGINE_PROFILE_GPU_ZONE("linearize-depth-pass");
+    BOOST_ASSERT(m_linearizeDepthPass != nullptr);
+    m_linearizeDepthPass->render();
+    BOOST_ASSERT(m_linearizePortalDepthPass != nullptr);
+    m_linearizePortalDepthPass->render();
+  }
   BOOST_ASSERT(m_compositionPass != nullptr);
   m_compositionPass->render(water, m_renderSettings);
 }
@@ -81,6 +96,25 @@ void RenderPipeline::resize(scene::MaterialManager& materialManager, const glm::
                                                               *m_linearizeDepthPass,
                                                               *m_linearizePortalDepthPass);
   m_uiPass = std::make_shared<pass::UIPass>(materialManager, viewport);
+  m_hiZPass = std::make_shared<pass::HiZPass>(materialManager, viewport, m_geometryPass->getDepthBuffer());
+}
+
+void RenderPipeline::hiZPass(const glm::mat4& viewProjection)
+{
+  BOOST_ASSERT(m_hiZPass != nullptr);
+  m_hiZPass->render(viewProjection);
+}
+
+const scene::HiZBuffer& RenderPipeline::getHiZBuffer() const
+{
+  BOOST_ASSERT(m_hiZPass != nullptr);
+  return m_hiZPass->getHiZBuffer();
+}
+
+void RenderPipeline::resetHiZBuffer()
+{
+  BOOST_ASSERT(m_hiZPass != nullptr);
+  m_hiZPass->reset();
 }
 
 void RenderPipeline::bindPortalFrameBuffer()
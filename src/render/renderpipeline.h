@@ -15,6 +15,7 @@ namespace render
 {
 namespace scene
 {
+class HiZBuffer;
 class MaterialManager;
 } // namespace scene
 
@@ -27,6 +28,7 @@ class FXAAPass;
 class CompositionPass;
 class UIPass;
 class LinearizeDepthPass;
+class HiZPass;
 } // namespace pass
 
 class RenderPipeline
@@ -42,6 +44,7 @@ private:
   std::shared_ptr<pass::FXAAPass> m_fxaaPass;
   std::shared_ptr<pass::CompositionPass> m_compositionPass;
   std::shared_ptr<pass::UIPass> m_uiPass;
+  std::shared_ptr<pass::HiZPass> m_hiZPass;
 
 public:
   explicit RenderPipeline(scene::MaterialManager& materialManager, const glm::ivec2& viewport);
@@ -51,6 +54,10 @@ public:
   void bindUiFrameBuffer();
   void renderUiFrameBuffer(float alpha);
   void compositionPass(bool water);
+  //! Captures the geometry depth for occlusion tests; the depth must have been rendered with @a viewProjection.
+  void hiZPass(const glm::mat4& viewProjection);
+  [[nodiscard]] const scene::HiZBuffer& getHiZBuffer() const;
+  void resetHiZBuffer();
 
   void updateCamera(const gsl::not_null<std::shared_ptr<scene::Camera>>& camera);
 
@@ -4,16 +4,18 @@
 #include "mesh.h"
 #include "node.h"
 
+#include <utility>
+
 namespace render::scene
 {
 bool BufferParameter::bind(const Node& node,
                            const Mesh& mesh,
                            const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram)
 {
-  auto binder = mesh.findShaderStorageBlockBinder(getName());
+  auto binder = mesh.findShaderStorageBlockBinder(getSlot());
   if(!m_bufferBinder && binder == nullptr)
   {
-    binder = node.findShaderStorageBlockBinder(getName());
+    binder = node.findShaderStorageBlockBinder(getSlot());
     if(!m_bufferBinder && binder == nullptr)
     {
       // don't have an explicit binder present on material, node or mesh level, assuming it's set on shader level
@@ -33,23 +35,27 @@ bool BufferParameter::bind(const Node& node,
   return true;
 }
 
-void BufferParameter::bindBoneTransformBuffer()
+void BufferParameter::bindBoneTransformBuffer(const gsl::not_null<std::shared_ptr<FrameArena>>& arena)
 {
-  m_bufferBinder = [](const Node& node, const Mesh& /*mesh*/, gl::ShaderStorageBlock& ssb) {
+  m_bufferBinder = [arena](const Node& node, const Mesh& /*mesh*/, gl::ShaderStorageBlock& ssb) {
     if(const auto* mo = dynamic_cast<const engine::SkeletalModelNode*>(&node))
-      ssb.bind(mo->getMeshMatricesBuffer());
+      arena->bind(ssb, mo->getMeshMatricesRange(*arena));
   };
 }
 
 gl::ShaderStorageBlock*
-  BufferParameter::findShaderStorageBlock(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) const
+  BufferParameter::findShaderStorageBlock(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram)
 {
-  if(const auto block = shaderProgram->findShaderStorageBlock(getName().c_str()))
-    return block;
+  if(std::exchange(m_resolvedProgram, shaderProgram.get().get()) == shaderProgram.get().get())
+    return m_shaderStorageBlock;
 
-  BOOST_LOG_TRIVIAL(warning) << "Shader storage block '" << getName() << "' not found in program '"
-                             << shaderProgram->getId() << "'";
+  m_shaderStorageBlock = shaderProgram->findShaderStorageBlock(getName());
+  if(m_shaderStorageBlock == nullptr)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Shader storage block '" << getName() << "' not found in program '"
+                               << shaderProgram->getId() << "'";
+  }
 
-  return nullptr;
+  return m_shaderStorageBlock;
 }
 } // namespace render::scene
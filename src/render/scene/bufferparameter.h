@@ -8,6 +8,7 @@
 
 namespace render::scene
 {
+class FrameArena;
 class Mesh;
 class Node;
 class ShaderProgram;
@@ -51,12 +52,15 @@ public:
   bool bind(const Node& node,
             const Mesh& mesh,
             const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) override;
-  void bindBoneTransformBuffer();
+  void bindBoneTransformBuffer(const gsl::not_null<std::shared_ptr<FrameArena>>& arena);
 
 private:
   [[nodiscard]] gl::ShaderStorageBlock*
-    findShaderStorageBlock(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) const;
+    findShaderStorageBlock(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram);
 
   std::function<BufferBinder> m_bufferBinder;
+  //! The shader storage block is only looked up by name when the program changes.
+  const ShaderProgram* m_resolvedProgram = nullptr;
+  gl::ShaderStorageBlock* m_shaderStorageBlock = nullptr;
 };
 } // namespace render::scene
@@ -38,6 +38,12 @@ void CSM::Split::init(int32_t resolution, size_t idx, MaterialManager& materialM
     .set(gl::api::SamplerParameterI::TextureWrapS, gl::api::TextureWrapMode::ClampToEdge)
     .set(gl::api::SamplerParameterI::TextureWrapT, gl::api::TextureWrapMode::ClampToEdge);
 
+  staticDepthTexture = std::make_shared<gl::TextureDepth<float>>(glm::ivec2{resolution, resolution},
+                                                                 "csm-texture/" + std::to_string(idx) + "/static");
+  staticDepthFramebuffer = gl::FrameBufferBuilder()
+                             .textureNoBlend(gl::api::FramebufferAttachment::DepthAttachment, staticDepthTexture)
+                             .build("csm-split-fb/" + std::to_string(idx) + "/static");
+
   squaredTextureHandle
     = std::make_shared<gl::TextureHandle<gl::Texture2D<gl::RG16F>>>(squaredTexture, std::move(squaredSampler));
   squareFramebuffer = gl::FrameBufferBuilder()
@@ -122,6 +128,43 @@ std::array<float, CSMBuffer::NSplits> CSM::getSplitEnds() const
   return result;
 }
 
+bool CSM::beginStaticLayer(std::vector<const Node*>&& roomNodes)
+{
+  auto& split = m_splits.at(m_activeSplit);
+  // the matrices are snapped to a grid, so they only change when the camera moved or turned noticeably
+  split.staticLayerChanged = split.staticVpMatrix != split.vpMatrix || split.staticRoomNodes != roomNodes;
+  if(!split.staticLayerChanged)
+    return false;
+
+  split.staticVpMatrix = split.vpMatrix;
+  split.staticRoomNodes = std::move(roomNodes);
+  split.staticDepthFramebuffer->bindWithAttachments();
+  return true;
+}
+
+bool CSM::beginDynamicLayer(bool hasDynamicGeometry)
+{
+  auto& split = m_splits.at(m_activeSplit);
+  // if there were moving objects in the last frame, their shadows must be removed
+  split.dirty = split.staticLayerChanged || hasDynamicGeometry || split.hasDynamicGeometry;
+  split.hasDynamicGeometry = hasDynamicGeometry;
+  if(!split.dirty)
+    return false;
+
+  split.depthTextureHandle->getTexture()->copyFrom(*split.staticDepthTexture);
+  split.depthFramebuffer->bindWithAttachments();
+  return true;
+}
+
+void CSM::resetStaticLayers()
+{
+  for(auto& split : m_splits)
+  {
+    split.staticVpMatrix.reset();
+    split.staticRoomNodes.clear();
+  }
+}
+
 void CSM::updateCamera(const Camera& camera)
 {
   //Start off by calculating the split distances
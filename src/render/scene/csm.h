@@ -9,6 +9,8 @@
 #include <gl/soglb_fwd.h>
 #include <glm/glm.hpp>
 #include <gsl/gsl-lite.hpp>
+#include <optional>
+#include <vector>
 
 namespace render::scene
 {
@@ -16,6 +18,7 @@ class Camera;
 class Material;
 class Mesh;
 class MaterialManager;
+class Node;
 
 struct CSMBuffer
 {
@@ -42,6 +45,21 @@ public:
     std::shared_ptr<SeparableBlur<gl::RG16F>> squareBlur;
     float end = 0;
 
+    //! @brief Depth of the static geometry only, copied into the depth texture before rendering moving objects
+    //! @{
+    std::shared_ptr<gl::TextureDepth<float>> staticDepthTexture;
+    std::shared_ptr<gl::Framebuffer> staticDepthFramebuffer{};
+    //! @}
+    //! @brief The static layer contains the scenery of these room nodes, rendered with this matrix
+    //! @{
+    std::optional<glm::mat4> staticVpMatrix{};
+    std::vector<const Node*> staticRoomNodes{};
+    //! @}
+    bool staticLayerChanged = true;
+    bool hasDynamicGeometry = false;
+    //! Set if the depth texture was re-rendered, and needs to be squared and blurred again.
+    bool dirty = true;
+
     void init(int32_t resolution, size_t idx, MaterialManager& materialManager);
     void renderSquare();
     void renderBlur();
@@ -72,6 +90,33 @@ public:
 
   void updateCamera(const Camera& camera);
 
+  /**
+   * @brief Checks whether the active split's static layer is outdated.
+   * @param roomNodes The nodes of the rooms whose scenery is visible in the active split.
+   * @returns true if the static layer needs to be re-rendered, in which case its framebuffer is bound.
+   */
+  bool beginStaticLayer(std::vector<const Node*>&& roomNodes);
+
+  /**
+   * @brief Initializes the active split's depth texture with its static layer.
+   * @param hasDynamicGeometry Whether any moving objects are visible in the active split.
+   * @returns false if the active split is unchanged since the last frame, otherwise its framebuffer is bound.
+   */
+  bool beginDynamicLayer(bool hasDynamicGeometry);
+
+  /**
+   * @brief Forces all static layers to be re-rendered.
+   *
+   * Must be called whenever the room geometry changes or room nodes are destroyed, as the static layers only remember
+   * the room nodes they were rendered with, and a room node may be replaced by another one at the same address.
+   */
+  void resetStaticLayers();
+
+  [[nodiscard]] bool isActiveSplitDirty() const
+  {
+    return m_splits.at(m_activeSplit).dirty;
+  }
+
   auto& getBuffer(const glm::mat4& modelMatrix)
   {
     const auto splitEnds = getSplitEnds();
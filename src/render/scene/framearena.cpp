@@ -0,0 +1,67 @@
+#include "framearena.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cstring>
+
+namespace render::scene
+{
+namespace
+{
+std::size_t getOffsetAlignment()
+{
+  int32_t uniformAlignment = 0;
+  GL_ASSERT(gl::api::getIntegerv(gl::api::GetPName::UniformBufferOffsetAlignment, &uniformAlignment));
+  int32_t storageAlignment = 0;
+  GL_ASSERT(gl::api::getIntegerv(gl::api::GetPName::ShaderStorageBufferOffsetAlignment, &storageAlignment));
+  return gsl::narrow<std::size_t>(std::max({uniformAlignment, storageAlignment, 1}));
+}
+} // namespace
+
+FrameArena::FrameArena(const std::string& label)
+    : m_buffer{label}
+    , m_data{m_buffer.allocatePersistent(gsl::narrow<gl::api::core::SizeType>(RegionCount * RegionSize))}
+    , m_alignment{getOffsetAlignment()}
+{
+}
+
+FrameArena::Range FrameArena::push(const void* data, const std::size_t size)
+{
+  Expects(size > 0 && size <= RegionSize);
+
+  auto offset = (m_offset + m_alignment - 1) / m_alignment * m_alignment;
+  if(offset + size > RegionSize)
+  {
+    BOOST_LOG_TRIVIAL(debug) << "Frame arena region exhausted, advancing early";
+    nextRegion();
+    offset = 0;
+  }
+
+  const auto regionStart = m_region * RegionSize;
+  std::memcpy(m_data + regionStart + offset, data, size);
+  m_offset = offset + size;
+  return Range{gsl::narrow<std::intptr_t>(regionStart + offset), size, m_generation};
+}
+
+void FrameArena::nextFrame()
+{
+  // nothing has been written, so the current region can be kept
+  if(m_offset == 0)
+    return;
+
+  nextRegion();
+}
+
+void FrameArena::nextRegion()
+{
+  m_fences[m_region].emplace();
+  m_region = (m_region + 1) % RegionCount;
+  if(const auto& fence = m_fences[m_region]; fence.has_value())
+  {
+    fence->wait();
+    m_fences[m_region].reset();
+  }
+  m_offset = 0;
+  ++m_generation;
+}
+} // namespace render::scene
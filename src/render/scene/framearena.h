@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gl/buffer.h>
+#include <gl/fence.h>
+#include <gl/program.h>
+#include <optional>
+#include <string>
+
+namespace render::scene
+{
+/**
+ * @brief A persistently mapped buffer for data that changes every frame, like node transforms and bone matrices.
+ *
+ * The buffer is split into regions which are used round-robin, one per frame. Before a region is written again, the
+ * fence placed after its last use is waited on, so data is never overwritten while the GPU may still read it.
+ */
+class FrameArena final
+{
+public:
+  struct Range
+  {
+    std::intptr_t offset = 0;
+    std::size_t size = 0;
+    //! Ranges are only valid as long as the arena's generation doesn't change.
+    uint64_t generation = 0;
+  };
+
+  explicit FrameArena(const std::string& label);
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena(FrameArena&&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+  FrameArena& operator=(FrameArena&&) = delete;
+
+  template<typename T>
+  [[nodiscard]] Range push(const T* data, const std::size_t count)
+  {
+    return push(static_cast<const void*>(data), sizeof(T) * count);
+  }
+
+  [[nodiscard]] Range push(const void* data, std::size_t size);
+
+  [[nodiscard]] bool isValid(const Range& range) const noexcept
+  {
+    return range.generation == m_generation;
+  }
+
+  //! Must be called after all draw calls of a frame have been submitted.
+  void nextFrame();
+
+  void bind(gl::UniformBlock& block, const Range& range) const
+  {
+    Expects(isValid(range));
+    block.bindRange(m_buffer, range.offset, range.size);
+  }
+
+  void bind(gl::ShaderStorageBlock& block, const Range& range) const
+  {
+    Expects(isValid(range));
+    block.bindRange(m_buffer, range.offset, range.size);
+  }
+
+private:
+  static constexpr std::size_t RegionCount = 3;
+  static constexpr std::size_t RegionSize = 1024 * 1024;
+
+  gl::ShaderStorageBuffer<std::byte> m_buffer;
+  std::byte* m_data;
+  std::size_t m_alignment;
+  std::size_t m_region = 0;
+  std::size_t m_offset = 0;
+  //! Starts at 1, so default constructed ranges are never valid.
+  uint64_t m_generation = 1;
+  std::array<std::optional<gl::Fence>, RegionCount> m_fences{};
+
+  void nextRegion();
+};
+} // namespace render::scene
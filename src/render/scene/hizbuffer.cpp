@@ -0,0 +1,137 @@
+#include "hizbuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <gsl/gsl-lite.hpp>
+#include <limits>
+#include <utility>
+
+namespace render::scene
+{
+namespace
+{
+//! Returns the center of the near plane and the view direction.
+std::pair<glm::vec3, glm::vec3> getViewRay(const glm::mat4& viewProjection)
+{
+  const auto inverse = glm::inverse(viewProjection);
+  const auto unproject = [&inverse](const float z)
+  {
+    const auto tmp = inverse * glm::vec4{0, 0, z, 1};
+    return glm::vec3{tmp} / tmp.w;
+  };
+
+  const auto nearCenter = unproject(-1);
+  return {nearCenter, glm::normalize(unproject(1) - nearCenter)};
+}
+} // namespace
+
+void HiZBuffer::assign(std::vector<float> depths, const glm::ivec2& size, const glm::mat4& viewProjection)
+{
+  Expects(size.x > 0 && size.y > 0);
+  Expects(depths.size() == static_cast<size_t>(size.x) * static_cast<size_t>(size.y));
+
+  m_viewProjection = viewProjection;
+  m_levels.clear();
+  m_levels.emplace_back(Level{size, std::move(depths)});
+  while(m_levels.back().size != glm::ivec2{1, 1})
+  {
+    const auto& src = m_levels.back();
+    Level dst{(src.size + 1) / 2, {}};
+    dst.depths.resize(static_cast<size_t>(dst.size.x) * static_cast<size_t>(dst.size.y));
+    for(int y = 0; y < dst.size.y; ++y)
+    {
+      const auto y0 = 2 * y;
+      const auto y1 = std::min(y0 + 1, src.size.y - 1);
+      for(int x = 0; x < dst.size.x; ++x)
+      {
+        const auto x0 = 2 * x;
+        const auto x1 = std::min(x0 + 1, src.size.x - 1);
+        dst.depths[y * dst.size.x + x] = std::max({src.at(x0, y0), src.at(x1, y0), src.at(x0, y1), src.at(x1, y1)});
+      }
+    }
+    m_levels.emplace_back(std::move(dst));
+  }
+}
+
+std::optional<float>
+  HiZBuffer::getCameraOffset(const glm::mat4& viewProjection, const float maxDistance, const float maxAngle) const
+{
+  if(m_levels.empty())
+    return std::nullopt;
+
+  const auto [capturedPosition, capturedDirection] = getViewRay(m_viewProjection);
+  const auto [position, direction] = getViewRay(viewProjection);
+  const auto distance = glm::distance(capturedPosition, position);
+  if(distance > maxDistance || glm::dot(capturedDirection, direction) < std::cos(maxAngle))
+    return std::nullopt;
+
+  return distance;
+}
+
+bool HiZBuffer::isOccluded(const std::array<glm::vec3, 8>& corners, const float margin) const
+{
+  if(m_levels.empty())
+    return false;
+
+  glm::vec3 boxMin{std::numeric_limits<float>::max()};
+  glm::vec3 boxMax{std::numeric_limits<float>::lowest()};
+  for(const auto& corner : corners)
+  {
+    boxMin = glm::min(boxMin, corner);
+    boxMax = glm::max(boxMax, corner);
+  }
+  boxMin -= margin;
+  boxMax += margin;
+
+  glm::vec2 min{std::numeric_limits<float>::max()};
+  glm::vec2 max{std::numeric_limits<float>::lowest()};
+  float nearest = std::numeric_limits<float>::max();
+  for(int i = 0; i < 8; ++i)
+  {
+    const glm::vec3 corner{(i & 1) != 0 ? boxMax.x : boxMin.x,
+                           (i & 2) != 0 ? boxMax.y : boxMin.y,
+                           (i & 4) != 0 ? boxMax.z : boxMin.z};
+    auto proj = m_viewProjection * glm::vec4{corner, 1.0f};
+    // the projection flips everything behind the camera
+    if(proj.w <= 0)
+      return false;
+
+    proj /= proj.w;
+    min = glm::min(min, glm::vec2{proj});
+    max = glm::max(max, glm::vec2{proj});
+    nearest = std::min(nearest, proj.z);
+  }
+
+  // nothing is known about anything outside of the captured area
+  if(min.x > 1 || min.y > 1 || max.x < -1 || max.y < -1)
+    return false;
+
+  const auto& base = m_levels.front();
+  const auto toTexel = [&base](const glm::vec2& ndc)
+  {
+    return glm::clamp(
+      glm::ivec2{glm::floor((ndc * 0.5f + 0.5f) * glm::vec2{base.size})}, glm::ivec2{0}, base.size - 1);
+  };
+  auto texelMin = toTexel(min);
+  auto texelMax = toTexel(max);
+
+  // use the level where the bounds cover at most three texels in each direction
+  const auto extent = std::max(texelMax.x - texelMin.x, texelMax.y - texelMin.y);
+  size_t level = 0;
+  while((extent >> level) > 1 && level + 1 < m_levels.size())
+    ++level;
+
+  const auto& hiZ = m_levels[level];
+  texelMin /= 1 << level;
+  texelMax = glm::min(texelMax / (1 << level), hiZ.size - 1);
+
+  float farthest = 0;
+  for(int y = texelMin.y; y <= texelMax.y; ++y)
+  {
+    for(int x = texelMin.x; x <= texelMax.x; ++x)
+      farthest = std::max(farthest, hiZ.at(x, y));
+  }
+
+  return nearest * 0.5f + 0.5f > farthest;
+}
+} // namespace render::scene
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+#include <optional>
+#include <vector>
+
+namespace render::scene
+{
+/**
+ * @brief A CPU side depth pyramid for occlusion tests, built from a downsampled depth buffer.
+ *
+ * Each texel holds the farthest depth of the area it covers, so a box is only reported as occluded if it is behind
+ * everything within its screen bounds. The depth is usually a few frames old, so tests use the view projection the
+ * depth was rendered with.
+ */
+class HiZBuffer final
+{
+public:
+  //! Replaces the pyramid; @a depths are window space depths, row by row from the bottom of the screen.
+  void assign(std::vector<float> depths, const glm::ivec2& size, const glm::mat4& viewProjection);
+
+  void reset()
+  {
+    m_levels.clear();
+  }
+
+  [[nodiscard]] bool empty() const noexcept
+  {
+    return m_levels.empty();
+  }
+
+  /**
+   * @brief Returns how far the camera moved since the depth was rendered, if the depth can be used for occlusion tests
+   *        of a view rendered with @a viewProjection.
+   *
+   * Occlusion depends on the point of view, so the depth is only usable if the camera didn't move farther than
+   * @a maxDistance or turn by more than @a maxAngle radians since the depth was rendered.
+   */
+  [[nodiscard]] std::optional<float>
+    getCameraOffset(const glm::mat4& viewProjection, float maxDistance, float maxAngle) const;
+
+  /**
+   * @brief Tests a world space box given by its corners; boxes crossing the near plane are never occluded.
+   *
+   * The box is grown by @a margin in every direction before testing, which accounts for the camera having moved since
+   * the depth was rendered, see getCameraOffset().
+   */
+  [[nodiscard]] bool isOccluded(const std::array<glm::vec3, 8>& corners, float margin) const;
+
+private:
+  struct Level
+  {
+    glm::ivec2 size;
+    std::vector<float> depths;
+
+    [[nodiscard]] float at(const int x, const int y) const
+    {
+      return depths[y * size.x + x];
+    }
+  };
+
+  std::vector<Level> m_levels;
+  glm::mat4 m_viewProjection{1.0f};
+};
+} // namespace render::scene
@@ -35,7 +35,7 @@ const std::shared_ptr<Material>& MaterialManager::getSprite()
   m_sprite = std::make_shared<Material>(m_shaderCache->getGeometry(false, false, true));
   m_sprite->getRenderState().setCullFace(false);
 
-  m_sprite->getUniformBlock("Transform")->bindTransformBuffer();
+  m_sprite->getUniformBlock("Transform")->bindTransformBuffer(m_renderer->getFrameArena());
   m_sprite->getUniformBlock("Camera")->bindCameraBuffer(m_renderer->getCamera());
   m_sprite->getUniform("u_isSprite")->set(1);
 
@@ -57,7 +57,7 @@ const std::shared_ptr<Material>& MaterialManager::getCSMDepthOnly(bool skeletal)
   m_csmDepthOnly[skeletal]->getRenderState().setDepthTest(true);
   m_csmDepthOnly[skeletal]->getRenderState().setDepthWrite(true);
   if(auto buffer = m_csmDepthOnly[skeletal]->tryGetBuffer("BoneTransform"))
-    buffer->bindBoneTransformBuffer();
+    buffer->bindBoneTransformBuffer(m_renderer->getFrameArena());
 
   return m_csmDepthOnly[skeletal];
 }
@@ -70,10 +70,10 @@ const std::shared_ptr<Material>& MaterialManager::getDepthOnly(bool skeletal)
   m_depthOnly[skeletal] = std::make_shared<Material>(m_shaderCache->getDepthOnly(skeletal));
   m_depthOnly[skeletal]->getRenderState().setDepthTest(true);
   m_depthOnly[skeletal]->getRenderState().setDepthWrite(true);
-  m_depthOnly[skeletal]->getUniformBlock("Transform")->bindTransformBuffer();
+  m_depthOnly[skeletal]->getUniformBlock("Transform")->bindTransformBuffer(m_renderer->getFrameArena());
   m_depthOnly[skeletal]->getUniformBlock("Camera")->bindCameraBuffer(m_renderer->getCamera());
   if(auto buffer = m_depthOnly[skeletal]->tryGetBuffer("BoneTransform"))
-    buffer->bindBoneTransformBuffer();
+    buffer->bindBoneTransformBuffer(m_renderer->getFrameArena());
   m_depthOnly[skeletal]
     ->getUniform("u_diffuseTextures")
     ->bind([this](const Node& /*node*/, const Mesh& /*mesh*/, gl::Uniform& uniform)
@@ -95,9 +95,9 @@ std::shared_ptr<Material> MaterialManager::getGeometry(bool water, bool skeletal
            { uniform.set(m_geometryTextures); });
   m->getUniform("u_isSprite")->set(0);
 
-  m->getUniformBlock("Transform")->bindTransformBuffer();
+  m->getUniformBlock("Transform")->bindTransformBuffer(m_renderer->getFrameArena());
   if(auto buffer = m->tryGetBuffer("BoneTransform"))
-    buffer->bindBoneTransformBuffer();
+    buffer->bindBoneTransformBuffer(m_renderer->getFrameArena());
   m->getUniformBlock("Camera")->bindCameraBuffer(m_renderer->getCamera());
   m->getUniformBlock("CSM")->bind(
     [this](const Node& node, const Mesh& /*mesh*/, gl::UniformBlock& ub)
@@ -158,7 +158,7 @@ const std::shared_ptr<Material>& MaterialManager::getLightning()
     return m_lightning;
 
   m_lightning = std::make_shared<render::scene::Material>(m_shaderCache->getLightning());
-  m_lightning->getUniformBlock("Transform")->bindTransformBuffer();
+  m_lightning->getUniformBlock("Transform")->bindTransformBuffer(m_renderer->getFrameArena());
   m_lightning->getUniformBlock("Camera")->bindCameraBuffer(m_renderer->getCamera());
 
   return m_lightning;
@@ -308,6 +308,17 @@ const std::shared_ptr<Material>& MaterialManager::getLinearDepth()
   return m_linearDepth;
 }
 
+const std::shared_ptr<Material>& MaterialManager::getHiZDownsample()
+{
+  if(m_hiZDownsample != nullptr)
+    return m_hiZDownsample;
+
+  auto m = std::make_shared<Material>(m_shaderCache->getHiZDownsample());
+  configureForScreenSpaceEffect(*m);
+  m_hiZDownsample = m;
+  return m_hiZDownsample;
+}
+
 const std::shared_ptr<Material>& MaterialManager::getVSMSquare()
 {
   if(m_vsmSquare != nullptr)
@@ -42,6 +42,7 @@ public:
   [[nodiscard]] const std::shared_ptr<Material>& getFXAA();
   [[nodiscard]] const std::shared_ptr<Material>& getHBAO();
   [[nodiscard]] const std::shared_ptr<Material>& getLinearDepth();
+  [[nodiscard]] const std::shared_ptr<Material>& getHiZDownsample();
   [[nodiscard]] const std::shared_ptr<Material>& getVSMSquare();
   [[nodiscard]] std::shared_ptr<Material> getFastGaussBlur(uint8_t extent, uint8_t blurDir, uint8_t blurDim);
   [[nodiscard]] std::shared_ptr<Material> getFastBoxBlur(uint8_t extent, uint8_t blurDir, uint8_t blurDim);
@@ -74,6 +75,7 @@ private:
   std::shared_ptr<Material> m_fxaa{nullptr};
   std::shared_ptr<Material> m_hbao{nullptr};
   std::shared_ptr<Material> m_linearDepth{nullptr};
+  std::shared_ptr<Material> m_hiZDownsample{nullptr};
   std::shared_ptr<Material> m_vsmSquare{nullptr};
 
   std::shared_ptr<CSM> m_csm;
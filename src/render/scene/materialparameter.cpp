@@ -0,0 +1,16 @@
+#include "materialparameter.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace render::scene
+{
+ParameterSlot getParameterSlot(const std::string& name)
+{
+  static std::mutex mutex;
+  static std::unordered_map<std::string, ParameterSlot> slots;
+
+  std::lock_guard lock{mutex};
+  return slots.emplace(name, slots.size()).first->second;
+}
+} // namespace render::scene
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <gsl/gsl-lite.hpp>
+#include <string>
 
 namespace render::scene
 {
@@ -8,11 +10,18 @@ class Mesh;
 class Node;
 class ShaderProgram;
 
+//! Identifies a parameter name, so that overrides can be looked up without comparing strings.
+using ParameterSlot = size_t;
+
+//! Returns the same slot for the same name; safe to use from multiple threads.
+extern ParameterSlot getParameterSlot(const std::string& name);
+
 class MaterialParameter
 {
 public:
   explicit MaterialParameter(std::string name)
       : m_name{std::move(name)}
+      , m_slot{getParameterSlot(m_name)}
   {
   }
 
@@ -27,7 +36,13 @@ public:
     return m_name;
   }
 
+  [[nodiscard]] ParameterSlot getSlot() const
+  {
+    return m_slot;
+  }
+
 private:
   const std::string m_name;
+  const ParameterSlot m_slot;
 };
 } // namespace render::scene
@@ -12,66 +12,63 @@ class MaterialParameterOverrider
 public:
   virtual ~MaterialParameterOverrider() = default;
 
-  const std::function<UniformParameter::UniformValueSetter>* findUniformSetter(const std::string& name) const
+  const std::function<UniformParameter::UniformValueSetter>* findUniformSetter(ParameterSlot slot) const
   {
-    const auto it = m_uniformSetters.find(name);
-    if(it != m_uniformSetters.end())
-      return &it->second;
-
-    return nullptr;
+    return find(m_uniformSetters, slot);
   }
 
-  const std::function<UniformBlockParameter::BufferBinder>* findUniformBlockBinder(const std::string& name) const
+  const std::function<UniformBlockParameter::BufferBinder>* findUniformBlockBinder(ParameterSlot slot) const
   {
-    const auto it = m_uniformBlockBinders.find(name);
-    if(it != m_uniformBlockBinders.end())
-      return &it->second;
-
-    return nullptr;
+    return find(m_uniformBlockBinders, slot);
   }
 
-  const std::function<BufferParameter::BufferBinder>* findShaderStorageBlockBinder(const std::string& name) const
+  const std::function<BufferParameter::BufferBinder>* findShaderStorageBlockBinder(ParameterSlot slot) const
   {
-    const auto it = m_bufferBinders.find(name);
-    if(it != m_bufferBinders.end())
-      return &it->second;
-
-    return nullptr;
+    return find(m_bufferBinders, slot);
   }
 
   void bind(const std::string& name, const std::function<UniformParameter::UniformValueSetter>& setter)
   {
-    m_uniformSetters[name] = setter;
+    m_uniformSetters[getParameterSlot(name)] = setter;
   }
 
   void bind(const std::string& name, std::function<UniformParameter::UniformValueSetter>&& setter)
   {
-    m_uniformSetters[name] = std::move(setter);
+    m_uniformSetters[getParameterSlot(name)] = std::move(setter);
   }
 
   void bind(const std::string& name, const std::function<BufferParameter::BufferBinder>& binder)
   {
-    m_bufferBinders[name] = binder;
+    m_bufferBinders[getParameterSlot(name)] = binder;
   }
 
   void bind(const std::string& name, std::function<BufferParameter::BufferBinder>&& binder)
   {
-    m_bufferBinders[name] = std::move(binder);
+    m_bufferBinders[getParameterSlot(name)] = std::move(binder);
   }
 
   void bind(const std::string& name, const std::function<UniformBlockParameter::BufferBinder>& binder)
   {
-    m_uniformBlockBinders[name] = binder;
+    m_uniformBlockBinders[getParameterSlot(name)] = binder;
   }
 
   void bind(const std::string& name, std::function<UniformBlockParameter::BufferBinder>&& binder)
   {
-    m_uniformBlockBinders[name] = std::move(binder);
+    m_uniformBlockBinders[getParameterSlot(name)] = std::move(binder);
   }
 
 private:
-  boost::container::flat_map<std::string, std::function<UniformParameter::UniformValueSetter>> m_uniformSetters;
-  boost::container::flat_map<std::string, std::function<UniformBlockParameter::BufferBinder>> m_uniformBlockBinders;
-  boost::container::flat_map<std::string, std::function<BufferParameter::BufferBinder>> m_bufferBinders;
+  // keyed by slot instead of name, so that binding a material doesn't need any string comparisons; a node only
+  // overrides a few parameters, so this is smaller than an array covering all slots
+  boost::container::flat_map<ParameterSlot, std::function<UniformParameter::UniformValueSetter>> m_uniformSetters;
+  boost::container::flat_map<ParameterSlot, std::function<UniformBlockParameter::BufferBinder>> m_uniformBlockBinders;
+  boost::container::flat_map<ParameterSlot, std::function<BufferParameter::BufferBinder>> m_bufferBinders;
+
+  template<typename T>
+  static const T* find(const boost::container::flat_map<ParameterSlot, T>& map, ParameterSlot slot)
+  {
+    const auto it = map.find(slot);
+    return it == map.end() ? nullptr : &it->second;
+  }
 };
 } // namespace render::scene
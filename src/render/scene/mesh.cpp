@@ -3,6 +3,7 @@
 #include "material.h"
 #include "names.h"
 #include "rendercontext.h"
+#include "renderqueue.h"
 
 #include <gl/vertexarray.h>
 #include <gl/vertexbuffer.h>
@@ -59,11 +60,16 @@ bool Mesh::render(RenderContext& context)
 
   context.pushState(getRenderState());
   context.pushState(material->getRenderState());
-  context.bindState();
-
-  material->bind(*context.getCurrentNode(), *this);
-
-  drawIndexBuffer(m_primitiveType);
+  if(auto* queue = context.getRenderQueue(); queue != nullptr)
+  {
+    queue->enqueue(context, *this, *material);
+  }
+  else
+  {
+    context.bindState();
+    material->bind(*context.getCurrentNode(), *this);
+    draw();
+  }
 
   context.popState();
   context.popState();
@@ -6,6 +6,7 @@
 
 #include <gl/api/gl.hpp>
 #include <gl/soglb_fwd.h>
+#include <optional>
 
 namespace render::scene
 {
@@ -40,11 +41,26 @@ public:
 
   bool render(RenderContext& context) final;
 
+  //! Draws the mesh with the wanted render state and the currently bound material.
+  void draw()
+  {
+    drawIndexBuffer(m_primitiveType, m_instanceCount);
+  }
+
+  //! Draws the mesh this many times, for meshes with per-instance vertex attributes; unset draws it once.
+  void setInstanceCount(const std::optional<gl::api::core::SizeType>& instanceCount)
+  {
+    m_instanceCount = instanceCount;
+  }
+
 private:
   MaterialGroup m_materialGroup{};
   const gl::api::PrimitiveType m_primitiveType{};
+  std::optional<gl::api::core::SizeType> m_instanceCount{};
 
-  virtual void drawIndexBuffer(gl::api::PrimitiveType primitiveType) = 0;
+  virtual void drawIndexBuffer(gl::api::PrimitiveType primitiveType,
+                               const std::optional<gl::api::core::SizeType>& instanceCount)
+    = 0;
 };
 
 template<typename IndexT, typename... VertexTs>
@@ -68,9 +84,13 @@ public:
 private:
   gsl::not_null<std::shared_ptr<gl::VertexArray<IndexT, VertexTs...>>> m_vao;
 
-  void drawIndexBuffer(gl::api::PrimitiveType primitiveType) override
+  void drawIndexBuffer(gl::api::PrimitiveType primitiveType,
+                       const std::optional<gl::api::core::SizeType>& instanceCount) override
   {
-    m_vao->drawIndexBuffer(primitiveType);
+    if(instanceCount.has_value())
+      m_vao->drawIndexBuffer(primitiveType, *instanceCount);
+    else
+      m_vao->drawIndexBuffer(primitiveType);
   }
 };
 
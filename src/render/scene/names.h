@@ -10,13 +10,6 @@
 #define VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME "a_texCoord"
 #define VERTEX_ATTRIBUTE_TEXINDEX_NAME "a_texIndex"
 #define VERTEX_ATTRIBUTE_BONE_INDEX_NAME "a_boneIndex"
+#define VERTEX_ATTRIBUTE_SPRITE_CENTER_NAME "a_spriteCenter"
 
-#define VERTEX_ATTRIBUTE_IS_QUAD "a_isQuad"
-#define VERTEX_ATTRIBUTE_QUAD_VERT1 "a_quadVert1"
-#define VERTEX_ATTRIBUTE_QUAD_VERT2 "a_quadVert2"
-#define VERTEX_ATTRIBUTE_QUAD_VERT3 "a_quadVert3"
-#define VERTEX_ATTRIBUTE_QUAD_VERT4 "a_quadVert4"
-#define VERTEX_ATTRIBUTE_QUAD_UV1 "a_quadUv1"
-#define VERTEX_ATTRIBUTE_QUAD_UV2 "a_quadUv2"
-#define VERTEX_ATTRIBUTE_QUAD_UV3 "a_quadUv3"
-#define VERTEX_ATTRIBUTE_QUAD_UV4 "a_quadUv4"
+#define VERTEX_ATTRIBUTE_QUAD_INDEX "a_quadIndex"
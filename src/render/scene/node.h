@@ -1,10 +1,12 @@
 #pragma once
 
+#include "framearena.h"
 #include "materialparameteroverrider.h"
 #include "visitor.h"
 
 namespace render::scene
 {
+class HiZBuffer;
 class Renderable;
 
 struct Transform
@@ -24,7 +26,6 @@ public:
 
   explicit Node(std::string name)
       : m_name{std::move(name)}
-      , m_transformBuffer{m_name + "-transform-ubo"}
   {
   }
 
@@ -129,15 +130,16 @@ public:
     return *it;
   }
 
-  [[nodiscard]] const auto& getTransformBuffer() const
+  //! Writes the transform to the arena at most once per frame, unless it changes in between.
+  [[nodiscard]] const FrameArena::Range& getTransformRange(FrameArena& arena) const
   {
     getModelMatrix(); // update data if dirty
-    if(!m_bufferDirty)
-      return m_transformBuffer;
+    if(!m_bufferDirty && arena.isValid(m_transformRange))
+      return m_transformRange;
 
     m_bufferDirty = false;
-    m_transformBuffer.setData(m_transform, ::gl::api::BufferUsage::StreamDraw);
-    return m_transformBuffer;
+    m_transformRange = arena.push(&m_transform, 1);
+    return m_transformRange;
   }
 
   virtual bool canBeCulled(const glm::mat4& /*viewProjection*/) const
@@ -145,6 +147,11 @@ public:
     return false;
   }
 
+  virtual bool isOccluded(const HiZBuffer& /*hiZBuffer*/, float /*margin*/) const
+  {
+    return false;
+  }
+
   void clear()
   {
     auto tmp = m_children;
@@ -165,7 +172,7 @@ private:
   mutable bool m_dirty = false;
   mutable bool m_bufferDirty = true;
   mutable Transform m_transform{};
-  mutable gl::UniformBuffer<Transform> m_transformBuffer;
+  mutable FrameArena::Range m_transformRange{};
 
   friend void setParent(gsl::not_null<std::shared_ptr<Node>> node, const std::shared_ptr<Node>& newParent);
   friend void setParent(Node* node, const std::shared_ptr<Node>& newParent);
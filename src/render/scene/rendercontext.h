@@ -11,6 +11,9 @@
 
 namespace render::scene
 {
+class HiZBuffer;
+class RenderQueue;
+
 class RenderContext final
 {
 public:
@@ -50,6 +53,12 @@ public:
     m_renderStates.pop();
   }
 
+  [[nodiscard]] const gl::RenderState& getState() const
+  {
+    Expects(!m_renderStates.empty());
+    return m_renderStates.top();
+  }
+
   [[nodiscard]] RenderMode getRenderMode() const noexcept
   {
     return m_renderMode;
@@ -60,11 +69,43 @@ public:
     return m_viewProjection;
   }
 
+  //! If set, meshes are queued for sorted submission instead of being drawn immediately.
+  void setRenderQueue(RenderQueue* queue) noexcept
+  {
+    m_renderQueue = queue;
+  }
+
+  [[nodiscard]] RenderQueue* getRenderQueue() const noexcept
+  {
+    return m_renderQueue;
+  }
+
+  //! If set, nodes hidden behind the depth captured in the buffer are skipped; their bounds are grown by @a margin
+  //! before testing, see HiZBuffer::isOccluded().
+  void setHiZBuffer(const HiZBuffer* hiZBuffer, float margin) noexcept
+  {
+    m_hiZBuffer = hiZBuffer;
+    m_hiZMargin = margin;
+  }
+
+  [[nodiscard]] const HiZBuffer* getHiZBuffer() const noexcept
+  {
+    return m_hiZBuffer;
+  }
+
+  [[nodiscard]] float getHiZMargin() const noexcept
+  {
+    return m_hiZMargin;
+  }
+
 private:
   Node m_dummyNode{""};
   Node* m_currentNode;
   std::stack<gl::RenderState> m_renderStates{};
   const RenderMode m_renderMode;
   const std::optional<glm::mat4> m_viewProjection;
+  RenderQueue* m_renderQueue = nullptr;
+  const HiZBuffer* m_hiZBuffer = nullptr;
+  float m_hiZMargin = 0;
 };
 } // namespace render::scene
@@ -1,7 +1,9 @@
 #include "renderer.h"
 
 #include "camera.h"
+#include "framearena.h"
 #include "rendercontext.h"
+#include "renderqueue.h"
 
 #include <gl/api/gl_api_provider.hpp>
 #include <utility>
@@ -11,6 +13,8 @@ namespace render::scene
 Renderer::Renderer(gsl::not_null<std::shared_ptr<Camera>> camera)
     : m_rootNode{std::make_shared<Node>("<rootnode>")}
     , m_camera{std::move(camera)}
+    , m_frameArena{std::make_shared<FrameArena>("frame-arena")}
+    , m_renderQueue{std::make_unique<RenderQueue>()}
 {
 }
 
@@ -19,10 +23,31 @@ Renderer::~Renderer() = default;
 void Renderer::render()
 {
   RenderContext context{RenderMode::Full, std::nullopt};
+  context.setRenderQueue(m_renderQueue.get());
   Visitor visitor{context};
   m_rootNode->accept(visitor);
+  m_renderQueue->submit();
+  updateFrameRate();
+}
 
-  // Update FPS.
+void Renderer::render(const std::vector<std::pair<Node*, std::optional<glm::mat4>>>& nodes,
+                      const HiZBuffer* hiZBuffer,
+                      const float hiZMargin)
+{
+  for(const auto& [node, viewProjection] : nodes)
+  {
+    RenderContext context{RenderMode::Full, viewProjection};
+    context.setRenderQueue(m_renderQueue.get());
+    context.setHiZBuffer(hiZBuffer, hiZMargin);
+    Visitor visitor{context};
+    visitor.visit(*node);
+  }
+  m_renderQueue->submit();
+  updateFrameRate();
+}
+
+void Renderer::updateFrameRate()
+{
   ++m_frameCount;
   const auto t = getGameTime();
   const auto dt = t - m_frameLastFPS;
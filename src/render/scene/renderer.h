@@ -3,12 +3,18 @@
 #include <chrono>
 #include <gl/pixel.h>
 #include <gl/renderstate.h>
+#include <glm/mat4x4.hpp>
+#include <optional>
+#include <vector>
 
 namespace render::scene
 {
 class Camera;
+class FrameArena;
+class HiZBuffer;
 class Node;
 class RenderContext;
+class RenderQueue;
 
 class Renderer final
 {
@@ -29,6 +35,12 @@ public:
 
   void render();
 
+  //! Renders the given nodes of the scene, each with its own projection used for culling; nodes occluded according
+  //! to @a hiZBuffer are skipped if it is set, see RenderContext::setHiZBuffer().
+  void render(const std::vector<std::pair<Node*, std::optional<glm::mat4>>>& nodes,
+              const HiZBuffer* hiZBuffer = nullptr,
+              float hiZMargin = 0);
+
   [[nodiscard]] float getFrameRate() const
   {
     return m_frameRate;
@@ -58,6 +70,16 @@ public:
     return m_camera;
   }
 
+  [[nodiscard]] const auto& getFrameArena() const
+  {
+    return m_frameArena;
+  }
+
+  [[nodiscard]] RenderQueue& getRenderQueue() const
+  {
+    return *m_renderQueue;
+  }
+
   void resetRootNode();
 
 private:
@@ -71,5 +93,11 @@ private:
 
   std::shared_ptr<Node> m_rootNode;
   gsl::not_null<std::shared_ptr<Camera>> m_camera;
+  //! Per-frame node transforms and bone matrices.
+  gsl::not_null<std::shared_ptr<FrameArena>> m_frameArena;
+  //! Shared by all passes, so that the packet storage is reused across frames.
+  std::unique_ptr<RenderQueue> m_renderQueue;
+
+  void updateFrameRate();
 };
 } // namespace render::scene
@@ -0,0 +1,65 @@
+#include "renderqueue.h"
+
+#include "material.h"
+#include "mesh.h"
+#include "node.h"
+#include "rendercontext.h"
+#include "shaderprogram.h"
+
+#include <algorithm>
+#include <gl/debuggroup.h>
+#include <gl/program.h>
+#include <tuple>
+
+namespace render::scene
+{
+void RenderQueue::enqueue(const RenderContext& context, Mesh& mesh, const Material& material)
+{
+  const auto* node = context.getCurrentNode();
+  BOOST_ASSERT(node != nullptr);
+
+  float depth = 0;
+  if(const auto& vp = context.getViewProjection(); vp.has_value())
+  {
+    const auto clip = vp.value() * glm::vec4{node->getTranslationWorld(), 1.0f};
+    if(clip.w > 0)
+      depth = clip.z / clip.w;
+  }
+
+  const auto& state = context.getState();
+  auto& packets = state.isBlendEnabled() ? m_translucent : m_opaque;
+  packets.emplace_back(Packet{node,
+                              &mesh,
+                              &material,
+                              state,
+                              material.getShaderProgram()->getHandle().getHandle(),
+                              state.getSortKey(),
+                              depth});
+}
+
+void RenderQueue::submit()
+{
+  std::sort(m_opaque.begin(),
+            m_opaque.end(),
+            [](const Packet& a, const Packet& b)
+            { return std::tie(a.program, a.stateKey, a.depth) < std::tie(b.program, b.stateKey, b.depth); });
+  // keep the traversal order for packets at the same depth, as it is the only order the scene defines for them
+  std::stable_sort(m_translucent.begin(),
+                   m_translucent.end(),
+                   [](const Packet& a, const Packet& b) { return a.depth > b.depth; });
+
+  for(const auto* packets : {&m_opaque, &m_translucent})
+  {
+    for(const auto& packet : *packets)
+    {
+      SOGLB_DEBUGGROUP(packet.node->getName());
+      gl::RenderState::getWantedState() = packet.state;
+      packet.material->bind(*packet.node, *packet.mesh);
+      packet.mesh->draw();
+    }
+  }
+
+  m_opaque.clear();
+  m_translucent.clear();
+}
+} // namespace render::scene
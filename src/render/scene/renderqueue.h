@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <gl/renderstate.h>
+#include <vector>
+
+namespace render::scene
+{
+class Material;
+class Mesh;
+class Node;
+class RenderContext;
+
+/**
+ * @brief Collects the draws of a scene traversal, so that they can be submitted in an order that minimizes state
+ * changes.
+ *
+ * Opaque draws are grouped by program and render state, and drawn front-to-back within each group to benefit from
+ * early depth rejection. Blended draws are drawn back-to-front after all opaque draws.
+ */
+class RenderQueue final
+{
+public:
+  //! Adds a draw of the mesh with the context's current node and render state.
+  void enqueue(const RenderContext& context, Mesh& mesh, const Material& material);
+
+  //! Draws and removes all queued packets.
+  void submit();
+
+  [[nodiscard]] bool empty() const noexcept
+  {
+    return m_opaque.empty() && m_translucent.empty();
+  }
+
+private:
+  struct Packet
+  {
+    const Node* node;
+    Mesh* mesh;
+    const Material* material;
+    gl::RenderState state;
+    uint32_t program;
+    size_t stateKey;
+    //! Normalized device depth of the node's origin, 0 if the context has no projection.
+    float depth;
+  };
+
+  std::vector<Packet> m_opaque;
+  std::vector<Packet> m_translucent;
+};
+} // namespace render::scene
@@ -1,11 +1,94 @@
 #include "shadercache.h"
 
 #include "shaderprogram.h"
+#include "util/md5.h"
 
+#include <array>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/log/trivial.hpp>
+#include <fstream>
+#include <gl/glew_init.h>
 
 namespace render::scene
 {
+namespace
+{
+// increase this whenever the layout of the binary files changes
+constexpr uint32_t FormatVersion = 1;
+constexpr std::array<char, 4> Magic{'E', 'S', 'P', 'B'};
+
+template<typename T>
+void write(std::ofstream& stream, const T& value)
+{
+  static_assert(std::is_arithmetic_v<T>);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T read(std::ifstream& stream)
+{
+  static_assert(std::is_arithmetic_v<T>);
+  T value{};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+
+std::shared_ptr<ShaderProgram> loadBinary(const std::string& id, const std::filesystem::path& path)
+{
+  std::ifstream stream{path, std::ios::binary};
+  if(!stream.is_open())
+    return nullptr;
+
+  std::array<char, 4> magic{};
+  stream.read(magic.data(), magic.size());
+  if(magic != Magic || read<uint32_t>(stream) != FormatVersion)
+    return nullptr;
+
+  const auto format = read<gl::api::core::EnumType>(stream);
+  std::vector<uint8_t> binary(read<uint32_t>(stream));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.read(reinterpret_cast<char*>(binary.data()), gsl::narrow<std::streamsize>(binary.size()));
+  if(!stream || binary.empty())
+    return nullptr;
+
+  auto program = ShaderProgram::createFromBinary(id, format, binary);
+  if(program == nullptr)
+    BOOST_LOG_TRIVIAL(info) << "Program binary " << path << " was rejected by the driver";
+  return program;
+}
+
+void storeBinary(const ShaderProgram& program, const std::filesystem::path& path)
+{
+  gl::api::core::EnumType format{};
+  const auto binary = program.getBinary(format);
+  if(binary.empty())
+    return;
+
+  const auto tmpPath = std::filesystem::path{path}.concat(".tmp");
+  {
+    std::ofstream stream{tmpPath, std::ios::binary | std::ios::trunc};
+    stream.write(Magic.data(), Magic.size());
+    write(stream, FormatVersion);
+    write(stream, format);
+    write(stream, gsl::narrow<uint32_t>(binary.size()));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    stream.write(reinterpret_cast<const char*>(binary.data()), gsl::narrow<std::streamsize>(binary.size()));
+    if(!stream)
+    {
+      BOOST_LOG_TRIVIAL(warning) << "Failed to write program binary " << tmpPath;
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, path, ec);
+  if(ec)
+    BOOST_LOG_TRIVIAL(warning) << "Failed to replace program binary " << path << ": " << ec.message();
+}
+} // namespace
+
 std::string ShaderCache::makeId(const std::filesystem::path& vshPath,
                                 const std::filesystem::path& fshPath,
                                 const std::vector<std::string>& defines)
@@ -18,6 +101,26 @@ std::string ShaderCache::makeId(const std::filesystem::path& vshPath,
   return id;
 }
 
+ShaderCache::ShaderCache(std::filesystem::path root, std::filesystem::path binaryRoot)
+    : m_root{std::move(root)}
+    , m_binaryRoot{gl::hasProgramBinarySupport() ? std::move(binaryRoot) : std::filesystem::path{}}
+    , m_driverId{gl::getDriverId()}
+{
+  if(m_binaryRoot.empty())
+  {
+    BOOST_LOG_TRIVIAL(info) << "Program binaries are not supported, shaders will always be compiled";
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(m_binaryRoot, ec);
+  if(ec)
+  {
+    BOOST_LOG_TRIVIAL(warning) << "Failed to create shader cache directory " << m_binaryRoot << ": " << ec.message();
+    m_binaryRoot.clear();
+  }
+}
+
 gsl::not_null<std::shared_ptr<ShaderProgram>> ShaderCache::get(const std::filesystem::path& vshPath,
                                                                const std::filesystem::path& fshPath,
                                                                const std::vector<std::string>& defines)
@@ -27,8 +130,91 @@ gsl::not_null<std::shared_ptr<ShaderProgram>> ShaderCache::get(const std::filesy
   if(it != m_programs.end())
     return it->second;
 
-  auto shader = ShaderProgram::createFromFile(id, m_root / vshPath, m_root / fshPath, defines);
-  m_programs.emplace(id, shader);
-  return shader;
+  auto pending = create(id, m_root / vshPath, m_root / fshPath, defines);
+  if(m_deferFinalize)
+    m_pending.emplace_back(pending);
+  else
+    finalize(pending);
+
+  m_programs.emplace(id, pending.program);
+  return pending.program;
+}
+
+void ShaderCache::warmUp()
+{
+  BOOST_LOG_TRIVIAL(info) << "Creating shader programs";
+  m_deferFinalize = true;
+  {
+    const auto resetDeferFinalize = gsl::finally([this]() { m_deferFinalize = false; });
+
+    for(const bool skeletal : {false, true})
+    {
+      for(const bool water : {false, true})
+      {
+        for(const bool roomShadowing : {false, true})
+          getGeometry(water, skeletal, roomShadowing);
+      }
+      getCSMDepthOnly(skeletal);
+      getDepthOnly(skeletal);
+    }
+
+    for(uint8_t flags = 0; flags < 1u << 6u; ++flags)
+    {
+      getComposition(
+        flags & 1u, flags & (1u << 1u), flags & (1u << 2u), flags & (1u << 3u), flags & (1u << 4u), flags & (1u << 5u));
+    }
+
+    for(uint8_t flags = 0; flags < 1u << 3u; ++flags)
+      getFlat(flags & 1u, flags & (1u << 1u), flags & (1u << 2u));
+
+    // the extents for which blur shaders exist, for one and two channel textures
+    for(const uint8_t extent : {2, 4})
+    {
+      for(const uint8_t blurDim : {1, 2})
+      {
+        getFastGaussBlur(extent, blurDim);
+        getFastBoxBlur(extent, blurDim);
+      }
+    }
+
+    getBackdrop();
+    getWaterSurface();
+    getFXAA();
+    getHBAO();
+    getVSMSquare();
+    getLightning();
+    getCrt();
+    getLinearDepth();
+    getHiZDownsample();
+    getUi();
+  }
+
+  // all programs have been submitted, so a driver compiling in parallel had the chance to work on all of them
+  for(const auto& pending : std::exchange(m_pending, {}))
+    finalize(pending);
+}
+
+ShaderCache::Pending ShaderCache::create(const std::string& id,
+                                         const std::filesystem::path& vshPath,
+                                         const std::filesystem::path& fshPath,
+                                         const std::vector<std::string>& defines) const
+{
+  const auto sources = ShaderProgram::loadSources(vshPath, fshPath, defines);
+  if(m_binaryRoot.empty())
+    return Pending{ShaderProgram::compile(id, sources, false), {}};
+
+  const auto key = m_driverId + '\0' + sources.vertex + '\0' + sources.fragment;
+  auto binaryPath = m_binaryRoot / (util::md5(key.data(), key.size()) + ".bin");
+  if(auto program = loadBinary(id, binaryPath))
+    return Pending{program, {}};
+
+  return Pending{ShaderProgram::compile(id, sources, true), std::move(binaryPath)};
+}
+
+void ShaderCache::finalize(const Pending& pending) const
+{
+  pending.program->finalize();
+  if(!pending.binaryPath.empty())
+    storeBinary(*pending.program, pending.binaryPath);
 }
 } // namespace render::scene
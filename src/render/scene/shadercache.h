@@ -9,17 +9,42 @@ namespace render::scene
 {
 class ShaderProgram;
 
+/**
+ * @brief Creates shader programs on first use and keeps them.
+ *
+ * Linked programs are stored as driver specific binaries, keyed by the driver and the complete program sources, so
+ * that they only need to be compiled once.
+ */
 class ShaderCache final
 {
+  struct Pending
+  {
+    gsl::not_null<std::shared_ptr<ShaderProgram>> program;
+    //! Where to store the program binary after linking; empty if the program was loaded from a binary.
+    std::filesystem::path binaryPath;
+  };
+
   std::unordered_map<std::string, gsl::not_null<std::shared_ptr<ShaderProgram>>> m_programs{};
+  //! Programs created during warmUp() which haven't been finalized yet.
+  std::vector<Pending> m_pending{};
+  bool m_deferFinalize = false;
 
   const std::filesystem::path m_root;
+  //! Empty if the driver doesn't support program binaries.
+  std::filesystem::path m_binaryRoot;
+  const std::string m_driverId;
+
+  [[nodiscard]] Pending create(const std::string& id,
+                               const std::filesystem::path& vshPath,
+                               const std::filesystem::path& fshPath,
+                               const std::vector<std::string>& defines) const;
+  void finalize(const Pending& pending) const;
 
 public:
-  explicit ShaderCache(std::filesystem::path root)
-      : m_root{std::move(root)}
-  {
-  }
+  explicit ShaderCache(std::filesystem::path root, std::filesystem::path binaryRoot);
+
+  //! Creates all program permutations up front, so they don't need to be compiled when they're first used.
+  void warmUp();
 
   static std::string makeId(const std::filesystem::path& vshPath,
                             const std::filesystem::path& fshPath,
@@ -145,6 +170,11 @@ public:
     return get("flat.vert", "linearize_depth.frag");
   }
 
+  auto getHiZDownsample()
+  {
+    return get("flat.vert", "hiz_downsample.frag");
+  }
+
   auto getUi()
   {
     return get("ui.vert", "ui.frag");
@@ -113,19 +113,24 @@ void replaceIncludes(const std::filesystem::path& filepath,
     }
   }
 }
+
+template<gl::api::ShaderType Type>
+void logCompileErrors(const std::unique_ptr<gl::Shader<Type>>& shader, const std::string& id)
+{
+  if(shader != nullptr && !shader->getCompileStatus())
+    BOOST_LOG_TRIVIAL(error) << "Failed to compile shader for program " << id << ": " << shader->getInfoLog();
+}
 } // namespace
 
 ShaderProgram::ShaderProgram() = default;
 
 ShaderProgram::~ShaderProgram() = default;
 
-gsl::not_null<std::shared_ptr<ShaderProgram>> ShaderProgram::createFromFile(const std::string& id,
-                                                                            const std::filesystem::path& vshPath,
-                                                                            const std::filesystem::path& fshPath,
-                                                                            const std::vector<std::string>& defines)
+ShaderProgram::Sources ShaderProgram::loadSources(const std::filesystem::path& vshPath,
+                                                 const std::filesystem::path& fshPath,
+                                                 const std::vector<std::string>& defines)
 {
-  util::ensureFileExists(vshPath);
-  util::ensureFileExists(fshPath);
+  static constexpr gsl::czstring Header = "#version 450\n#extension GL_ARB_bindless_texture : require\n";
 
   const std::string vshSource = readAll(vshPath);
   if(vshSource.empty())
@@ -140,109 +145,104 @@ gsl::not_null<std::shared_ptr<ShaderProgram>> ShaderProgram::createFromFile(cons
     BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create shader from sources"));
   }
 
-  auto shaderProgram = createFromSource(vshPath, vshSource, fshPath, fshSource, defines);
-
-  if(shaderProgram == nullptr)
-  {
-    BOOST_LOG_TRIVIAL(error) << "Failed to create effect from shaders '" << vshPath << "', '" << fshPath << "'.";
-    BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create shader from sources"));
-  }
-
-  shaderProgram->m_id = id;
-  return shaderProgram;
-}
-
-std::shared_ptr<ShaderProgram> ShaderProgram::createFromSource(const std::filesystem::path& vshPath,
-                                                               const std::string& vshSource,
-                                                               const std::filesystem::path& fshPath,
-                                                               const std::string& fshSource,
-                                                               const std::vector<std::string>& defines)
-{
-  static constexpr size_t SHADER_SOURCE_LENGTH = 3;
-  std::array<gsl::czstring, SHADER_SOURCE_LENGTH> shaderSource{nullptr};
-  shaderSource[0] = "#version 450\n#extension GL_ARB_bindless_texture : require\n";
-
-  std::string vshSourceStr;
-  if(!vshPath.empty())
+  Sources sources{Header + replaceDefines(defines, false), Header + replaceDefines(defines, true)};
   {
     // Replace the #include "foo.bar" with the sources that come from file paths
     std::set<std::filesystem::path> included;
-    replaceIncludes(vshPath, vshSource, vshSourceStr, included);
+    replaceIncludes(vshPath, vshSource, sources.vertex, included);
   }
-  shaderSource[2] = !vshPath.empty() ? vshSourceStr.c_str() : vshSource.c_str();
-
-  std::string definesStr = replaceDefines(defines, false);
-  shaderSource[1] = definesStr.c_str();
-  gl::VertexShader vertexShader{shaderSource, vshPath.string() + ";" + boost::algorithm::join(defines, ";")};
-
-  // Compile the fragment shader.
-  std::string fshSourceStr;
-  if(!fshPath.empty())
   {
-    // Replace the #include "foo.bar" with the sources that come from file paths
     std::set<std::filesystem::path> included;
-    replaceIncludes(std::filesystem::path{fshPath}, fshSource, fshSourceStr, included);
+    replaceIncludes(fshPath, fshSource, sources.fragment, included);
   }
-  shaderSource[2] = !fshPath.empty() ? fshSourceStr.c_str() : fshSource.c_str();
-
-  definesStr = replaceDefines(defines, true);
-  shaderSource[1] = definesStr.c_str();
-  gl::FragmentShader fragmentShader{shaderSource, fshPath.string() + ";" + boost::algorithm::join(defines, ";")};
+  return sources;
+}
 
+gsl::not_null<std::shared_ptr<ShaderProgram>>
+  ShaderProgram::compile(const std::string& id, const Sources& sources, const bool binaryRetrievable)
+{
   auto shaderProgram = std::make_shared<ShaderProgram>();
-  shaderProgram->m_handle.attach(vertexShader);
-  shaderProgram->m_handle.attach(fragmentShader);
-  shaderProgram->m_handle.link(vshPath.string() + ";" + fshPath.string() + ";" + boost::algorithm::join(defines, ";"));
+  shaderProgram->m_id = id;
 
-  if(!shaderProgram->m_handle.getLinkStatus())
-  {
-    BOOST_LOG_TRIVIAL(error) << "Linking program failed (" << (vshPath.empty() ? "<none>" : vshPath) << ","
-                             << (fshPath.empty() ? "<none>" : fshPath) << "): " << shaderProgram->m_handle.getInfoLog();
+  std::array<gsl::czstring, 1> shaderSource{sources.vertex.c_str()};
+  shaderProgram->m_vertexShader = std::make_unique<gl::VertexShader>(shaderSource, id);
+  shaderSource[0] = sources.fragment.c_str();
+  shaderProgram->m_fragmentShader = std::make_unique<gl::FragmentShader>(shaderSource, id);
+
+  shaderProgram->m_handle.attach(*shaderProgram->m_vertexShader);
+  shaderProgram->m_handle.attach(*shaderProgram->m_fragmentShader);
+  if(binaryRetrievable)
+    shaderProgram->m_handle.setBinaryRetrievable();
+  shaderProgram->m_handle.link(id);
+
+  return shaderProgram;
+}
 
+std::shared_ptr<ShaderProgram> ShaderProgram::createFromBinary(const std::string& id,
+                                                               const gl::api::core::EnumType format,
+                                                               const std::vector<uint8_t>& binary)
+{
+  auto shaderProgram = std::make_shared<ShaderProgram>();
+  shaderProgram->m_id = id;
+  shaderProgram->m_handle.setBinary(format, binary, id);
+  if(!shaderProgram->m_handle.getLinkStatus())
     return nullptr;
+
+  return shaderProgram;
+}
+
+void ShaderProgram::finalize()
+{
+  // the link status query is the first call that needs to wait for the compiler
+  if(!m_handle.getLinkStatus())
+  {
+    logCompileErrors(m_vertexShader, m_id);
+    logCompileErrors(m_fragmentShader, m_id);
+    BOOST_LOG_TRIVIAL(error) << "Linking program failed (" << m_id << "): " << m_handle.getInfoLog();
+    BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create shader from sources"));
   }
 
-  BOOST_LOG_TRIVIAL(debug) << "Program vertex=" << vshPath << " fragment=" << fshPath
-                           << " defines=" << boost::algorithm::join(defines, ";");
+  m_vertexShader.reset();
+  m_fragmentShader.reset();
+
+  BOOST_LOG_TRIVIAL(debug) << "Program " << m_id;
 
-  for(auto&& input : shaderProgram->m_handle.getInputs())
+  for(auto&& input : m_handle.getInputs())
   {
     if(input.getLocation() < 0)
       continue; // only accept directly accessible uniforms
 
     BOOST_LOG_TRIVIAL(debug) << "  input " << input.getName() << ", location=" << input.getLocation();
 
-    shaderProgram->m_vertexAttributes.emplace(input.getName(), std::move(input));
+    m_vertexAttributes.emplace(input.getName(), std::move(input));
   }
 
-  for(auto&& uniform : shaderProgram->m_handle.getUniforms())
+  for(auto&& uniform : m_handle.getUniforms())
   {
     if(uniform.getLocation() < 0)
       continue; // only accept directly accessible uniforms
 
     BOOST_LOG_TRIVIAL(debug) << "  uniform " << uniform.getName() << ", location=" << uniform.getLocation();
 
-    shaderProgram->m_uniforms.emplace(uniform.getName(), std::move(uniform));
+    m_uniforms.emplace(uniform.getName(), std::move(uniform));
   }
 
-  for(auto&& ub : shaderProgram->m_handle.getUniformBlocks())
+  for(auto&& ub : m_handle.getUniformBlocks())
   {
     BOOST_LOG_TRIVIAL(debug) << "  uniform block " << ub.getName() << ", binding=" << ub.getBinding();
-    shaderProgram->m_uniformBlocks.emplace(ub.getName(), std::move(ub));
+    m_uniformBlocks.emplace(ub.getName(), std::move(ub));
   }
 
-  for(auto&& ssb : shaderProgram->m_handle.getShaderStorageBlocks())
+  for(auto&& ssb : m_handle.getShaderStorageBlocks())
   {
     BOOST_LOG_TRIVIAL(debug) << "  shader storage block " << ssb.getName() << ", binding=" << ssb.getBinding();
-    shaderProgram->m_shaderStorageBlocks.emplace(ssb.getName(), std::move(ssb));
+    m_shaderStorageBlocks.emplace(ssb.getName(), std::move(ssb));
   }
 
-  for(auto&& output : shaderProgram->m_handle.getOutputs())
+  for(auto&& output : m_handle.getOutputs())
   {
     BOOST_LOG_TRIVIAL(debug) << "  output " << output.getName() << ", location=" << output.getLocation();
   }
-
-  return shaderProgram;
 }
 
 void ShaderProgram::bind() const
@@ -3,6 +3,7 @@
 #include <boost/container/flat_map.hpp>
 #include <filesystem>
 #include <gl/program.h>
+#include <gl/shader.h>
 #include <map>
 #include <memory>
 #include <vector>
@@ -21,10 +22,32 @@ public:
 
   ~ShaderProgram();
 
-  static gsl::not_null<std::shared_ptr<ShaderProgram>> createFromFile(const std::string& id,
-                                                                      const std::filesystem::path& vshPath,
-                                                                      const std::filesystem::path& fshPath,
-                                                                      const std::vector<std::string>& defines);
+  //! The complete sources passed to the compiler, with resolved includes and prepended defines.
+  struct Sources
+  {
+    std::string vertex;
+    std::string fragment;
+  };
+
+  static Sources loadSources(const std::filesystem::path& vshPath,
+                             const std::filesystem::path& fshPath,
+                             const std::vector<std::string>& defines);
+
+  //! Starts compiling and linking; finalize() must be called before the program is used.
+  static gsl::not_null<std::shared_ptr<ShaderProgram>>
+    compile(const std::string& id, const Sources& sources, bool binaryRetrievable);
+
+  //! Creates a linked program from a binary returned by getBinary(); returns nullptr if the driver rejects it.
+  static std::shared_ptr<ShaderProgram>
+    createFromBinary(const std::string& id, gl::api::core::EnumType format, const std::vector<uint8_t>& binary);
+
+  //! Waits until linking has finished and looks up the program resources; throws if compiling or linking failed.
+  void finalize();
+
+  [[nodiscard]] std::vector<uint8_t> getBinary(gl::api::core::EnumType& format) const
+  {
+    return m_handle.getBinary(format);
+  }
 
   [[nodiscard]] const std::string& getId() const
   {
@@ -69,14 +92,11 @@ public:
   }
 
 private:
-  static std::shared_ptr<ShaderProgram> createFromSource(const std::filesystem::path& vshPath,
-                                                         const std::string& vshSource,
-                                                         const std::filesystem::path& fshPath,
-                                                         const std::string& fshSource,
-                                                         const std::vector<std::string>& defines = {});
-
   std::string m_id;
   gl::Program m_handle;
+  //! Only kept until the program is finalized, to report compile errors.
+  std::unique_ptr<gl::VertexShader> m_vertexShader;
+  std::unique_ptr<gl::FragmentShader> m_fragmentShader;
 
   boost::container::flat_map<std::string, gl::ProgramInput> m_vertexAttributes;
   boost::container::flat_map<std::string, gl::Uniform> m_uniforms;
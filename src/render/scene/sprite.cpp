@@ -7,6 +7,7 @@
 #include "node.h"
 
 #include <gl/vertexarray.h>
+#include <limits>
 
 namespace render::scene
 {
@@ -65,12 +66,89 @@ gsl::not_null<std::shared_ptr<Mesh>> createSpriteMesh(const float x0,
   return mesh;
 }
 
+gsl::not_null<std::shared_ptr<Mesh>>
+  createInstancedSpriteMesh(const float x0,
+                            const float y0,
+                            const float x1,
+                            const float y1,
+                            const glm::vec2& t0,
+                            const glm::vec2& t1,
+                            const gsl::not_null<std::shared_ptr<Material>>& materialFull,
+                            const int textureIdx,
+                            const gsl::not_null<std::shared_ptr<gl::VertexBuffer<SpriteInstance>>>& instances,
+                            const std::string& label)
+{
+  const auto vertices = createSpriteVertices(x0, y0, x1, y1, t0, t1, textureIdx);
+  auto vb = std::make_shared<gl::VertexBuffer<SpriteVertex>>(SpriteVertex::getInstancedLayout(), 0, label);
+  vb->setData(&vertices[0], 4, gl::api::BufferUsage::StaticDraw);
+
+  static const std::array<uint16_t, 6> indices{0, 1, 2, 0, 2, 3};
+
+  auto indexBuffer = std::make_shared<gl::ElementArrayBuffer<uint16_t>>(label);
+  indexBuffer->setData(gsl::not_null(&indices[0]), 6, gl::api::BufferUsage::StaticDraw);
+
+  using VertexArray = gl::VertexArray<uint16_t, SpriteVertex, SpriteInstance>;
+  auto vao = std::make_shared<VertexArray>(indexBuffer,
+                                           VertexArray::VertexBuffers{vb, instances},
+                                           std::vector{&materialFull->getShaderProgram()->getHandle()},
+                                           label);
+  auto mesh = std::make_shared<MeshImpl<uint16_t, SpriteVertex, SpriteInstance>>(vao);
+  mesh->getMaterialGroup().set(RenderMode::Full, materialFull);
+
+  return mesh;
+}
+
+gsl::not_null<std::shared_ptr<Mesh>> createSpriteBatchMesh(const std::vector<SpriteVertex>& vertices,
+                                                           const gsl::not_null<std::shared_ptr<Material>>& materialFull,
+                                                           const std::string& label)
+{
+  Expects(!vertices.empty() && vertices.size() % 4 == 0);
+  Expects(vertices.size() <= std::numeric_limits<uint16_t>::max());
+
+  auto vb = std::make_shared<gl::VertexBuffer<SpriteVertex>>(SpriteVertex::getLayout(), 0, label);
+  vb->setData(vertices, gl::api::BufferUsage::StaticDraw);
+
+  std::vector<uint16_t> indices;
+  indices.reserve(vertices.size() / 4 * 6);
+  for(size_t first = 0; first < vertices.size(); first += 4)
+  {
+    for(size_t i : {0, 1, 2, 0, 2, 3})
+    {
+      // cppcheck-suppress useStlAlgorithm
+      indices.emplace_back(gsl::narrow<uint16_t>(first + i));
+    }
+  }
+
+  auto indexBuffer = std::make_shared<gl::ElementArrayBuffer<uint16_t>>(label);
+  indexBuffer->setData(indices, gl::api::BufferUsage::StaticDraw);
+
+  auto vao = std::make_shared<gl::VertexArray<uint16_t, SpriteVertex>>(
+    indexBuffer, vb, std::vector{&materialFull->getShaderProgram()->getHandle()}, label);
+  auto mesh = std::make_shared<MeshImpl<uint16_t, SpriteVertex>>(vao);
+  mesh->getMaterialGroup().set(RenderMode::Full, materialFull);
+
+  return mesh;
+}
+
 gl::VertexLayout<SpriteVertex> SpriteVertex::getLayout()
 {
   return {{VERTEX_ATTRIBUTE_POSITION_NAME, &SpriteVertex::pos},
           {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, &SpriteVertex::uv},
           {VERTEX_ATTRIBUTE_TEXINDEX_NAME, &SpriteVertex::textureIdx},
-          {VERTEX_ATTRIBUTE_COLOR_NAME, &SpriteVertex::color},
-          {VERTEX_ATTRIBUTE_NORMAL_NAME, &SpriteVertex::normal}};
+          {VERTEX_ATTRIBUTE_COLOR_NAME, gl::VertexAttribute{&SpriteVertex::color, true}},
+          {VERTEX_ATTRIBUTE_NORMAL_NAME, gl::VertexAttribute{&SpriteVertex::normal, true}},
+          {VERTEX_ATTRIBUTE_SPRITE_CENTER_NAME, &SpriteVertex::center}};
+}
+
+gl::VertexLayout<SpriteVertex> SpriteVertex::getInstancedLayout()
+{
+  auto layout = getLayout();
+  layout.erase(VERTEX_ATTRIBUTE_SPRITE_CENTER_NAME);
+  return layout;
+}
+
+gl::VertexLayout<SpriteInstance> SpriteInstance::getLayout()
+{
+  return {{VERTEX_ATTRIBUTE_SPRITE_CENTER_NAME, &SpriteInstance::center}};
 }
 } // namespace render::scene
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "vertexpacking.h"
+
 #include <gl/vertexbuffer.h>
 #include <glm/glm.hpp>
 #include <gsl/gsl-lite.hpp>
@@ -15,10 +17,23 @@ struct SpriteVertex
   glm::vec3 pos;
   glm::vec2 uv;
   int textureIdx;
-  glm::vec4 color{1.0f};
-  glm::vec3 normal{0, 0, 1};
+  glm::u8vec4 color{packColor(glm::vec4{1.0f})};
+  //! Octahedral encoding of +Z, see packNormal.
+  glm::i16vec2 normal{0, 0};
+  //! The point the sprite is billboarded around; allows drawing multiple sprites with one call.
+  glm::vec3 center{0};
 
   [[nodiscard]] static gl::VertexLayout<SpriteVertex> getLayout();
+  //! Like getLayout(), but without the center, which instanced sprites take from SpriteInstance.
+  [[nodiscard]] static gl::VertexLayout<SpriteVertex> getInstancedLayout();
+};
+
+//! The per-instance data of a sprite mesh created by createInstancedSpriteMesh().
+struct SpriteInstance
+{
+  glm::vec3 center{0};
+
+  [[nodiscard]] static gl::VertexLayout<SpriteInstance> getLayout();
 };
 
 extern std::array<SpriteVertex, 4> createSpriteVertices(
@@ -43,4 +58,27 @@ extern gsl::not_null<std::shared_ptr<Mesh>>
                    const gsl::not_null<std::shared_ptr<Material>>& materialFull,
                    int textureIdx,
                    const std::string& label);
+
+/**
+ * @brief Creates a sprite mesh that is drawn once per element of @a instances.
+ *
+ * The number of instances to draw must be set with Mesh::setInstanceCount() before rendering.
+ */
+extern gsl::not_null<std::shared_ptr<Mesh>>
+  createInstancedSpriteMesh(float x0,
+                            float y0,
+                            float x1,
+                            float y1,
+                            const glm::vec2& t0,
+                            const glm::vec2& t1,
+                            const gsl::not_null<std::shared_ptr<Material>>& materialFull,
+                            int textureIdx,
+                            const gsl::not_null<std::shared_ptr<gl::VertexBuffer<SpriteInstance>>>& instances,
+                            const std::string& label);
+
+//! Creates a single mesh from multiple sprites, each consisting of 4 consecutive vertices.
+extern gsl::not_null<std::shared_ptr<Mesh>>
+  createSpriteBatchMesh(const std::vector<SpriteVertex>& vertices,
+                        const gsl::not_null<std::shared_ptr<Material>>& materialFull,
+                        const std::string& label);
 } // namespace render::scene
@@ -10,10 +10,10 @@ bool UniformParameter::bind(const Node& node,
                             const Mesh& mesh,
                             const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram)
 {
-  auto setter = mesh.findUniformSetter(getName());
+  auto setter = mesh.findUniformSetter(getSlot());
   if(!m_valueSetter && setter == nullptr)
   {
-    setter = node.findUniformSetter(getName());
+    setter = node.findUniformSetter(getSlot());
     if(!m_valueSetter && setter == nullptr)
     {
       // don't have an explicit setter present on material, node or mesh level, assuming it's set on shader level
@@ -37,10 +37,10 @@ bool UniformBlockParameter::bind(const Node& node,
                                  const Mesh& mesh,
                                  const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram)
 {
-  auto binder = mesh.findUniformBlockBinder(getName());
+  auto binder = mesh.findUniformBlockBinder(getSlot());
   if(!m_bufferBinder && binder == nullptr)
   {
-    binder = node.findUniformBlockBinder(getName());
+    binder = node.findUniformBlockBinder(getSlot());
     if(!m_bufferBinder && binder == nullptr)
     {
       // don't have an explicit binder present on material, node or mesh level, assuming it's set on shader level
@@ -60,10 +60,11 @@ bool UniformBlockParameter::bind(const Node& node,
   return true;
 }
 
-void UniformBlockParameter::bindTransformBuffer()
+void UniformBlockParameter::bindTransformBuffer(const gsl::not_null<std::shared_ptr<FrameArena>>& arena)
 {
-  m_bufferBinder
-    = [](const Node& node, const Mesh& /*mesh*/, gl::UniformBlock& ub) { ub.bind(node.getTransformBuffer()); };
+  m_bufferBinder = [arena](const Node& node, const Mesh& /*mesh*/, gl::UniformBlock& ub) {
+    arena->bind(ub, node.getTransformRange(*arena));
+  };
 }
 
 void UniformBlockParameter::bindCameraBuffer(const gsl::not_null<std::shared_ptr<Camera>>& camera)
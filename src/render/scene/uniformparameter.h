@@ -6,10 +6,12 @@
 #include <boost/log/trivial.hpp>
 #include <gl/program.h>
 #include <gsl/gsl-lite.hpp>
+#include <utility>
 
 namespace render::scene
 {
 class Camera;
+class FrameArena;
 
 class UniformParameter final : public MaterialParameter
 {
@@ -60,18 +62,25 @@ public:
             const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) override;
 
 private:
-  [[nodiscard]] gl::Uniform* findUniform(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) const
+  [[nodiscard]] gl::Uniform* findUniform(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram)
   {
-    if(const auto uniform = shaderProgram->findUniform(getName().c_str()))
-      return uniform;
+    if(std::exchange(m_resolvedProgram, shaderProgram.get().get()) == shaderProgram.get().get())
+      return m_uniform;
 
-    BOOST_LOG_TRIVIAL(warning) << "Uniform '" << getName() << "' not found in program '" << shaderProgram->getId()
-                               << "'";
+    m_uniform = shaderProgram->findUniform(getName());
+    if(m_uniform == nullptr)
+    {
+      BOOST_LOG_TRIVIAL(warning) << "Uniform '" << getName() << "' not found in program '" << shaderProgram->getId()
+                                 << "'";
+    }
 
-    return nullptr;
+    return m_uniform;
   }
 
   std::function<UniformValueSetter> m_valueSetter;
+  //! The uniform is only looked up by name when the program changes.
+  const ShaderProgram* m_resolvedProgram = nullptr;
+  gl::Uniform* m_uniform = nullptr;
 };
 
 class UniformBlockParameter : public MaterialParameter
@@ -114,22 +123,28 @@ public:
             const Mesh& mesh,
             const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) override;
 
-  void bindTransformBuffer();
+  void bindTransformBuffer(const gsl::not_null<std::shared_ptr<FrameArena>>& arena);
   void bindCameraBuffer(const gsl::not_null<std::shared_ptr<Camera>>& camera);
 
 private:
-  [[nodiscard]] gl::UniformBlock*
-    findUniformBlock(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram) const
+  [[nodiscard]] gl::UniformBlock* findUniformBlock(const gsl::not_null<std::shared_ptr<ShaderProgram>>& shaderProgram)
   {
-    if(const auto block = shaderProgram->findUniformBlock(getName().c_str()))
-      return block;
+    if(std::exchange(m_resolvedProgram, shaderProgram.get().get()) == shaderProgram.get().get())
+      return m_uniformBlock;
 
-    BOOST_LOG_TRIVIAL(warning) << "Uniform block '" << getName() << "' not found in program '" << shaderProgram->getId()
-                               << "'";
+    m_uniformBlock = shaderProgram->findUniformBlock(getName());
+    if(m_uniformBlock == nullptr)
+    {
+      BOOST_LOG_TRIVIAL(warning) << "Uniform block '" << getName() << "' not found in program '"
+                                 << shaderProgram->getId() << "'";
+    }
 
-    return nullptr;
+    return m_uniformBlock;
   }
 
   std::function<BufferBinder> m_bufferBinder;
+  //! The uniform block is only looked up by name when the program changes.
+  const ShaderProgram* m_resolvedProgram = nullptr;
+  gl::UniformBlock* m_uniformBlock = nullptr;
 };
 } // namespace render::scene
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <limits>
+
+namespace render::scene
+{
+//! Vertex colors are stored with 8 bits per channel, but vertex brightness may exceed 1, so they cover 0..ColorScale.
+constexpr float ColorScale = 2.0f;
+
+[[nodiscard]] inline glm::u8vec4 packColor(const glm::vec4& color)
+{
+  const glm::vec4 scaled{glm::vec3{color} / ColorScale, color.a};
+  return glm::u8vec4{glm::round(glm::clamp(scaled, 0.0f, 1.0f) * 255.0f)};
+}
+
+//! Positions are integral world units relative to the mesh or room origin, so they fit into 16 bits.
+[[nodiscard]] inline glm::i16vec3 packPosition(const glm::vec3& position)
+{
+  static const glm::vec3 min{std::numeric_limits<int16_t>::lowest()};
+  static const glm::vec3 max{std::numeric_limits<int16_t>::max()};
+  return glm::i16vec3{glm::clamp(glm::round(position), min, max)};
+}
+
+[[nodiscard]] inline glm::u16vec2 packUv(const glm::vec2& uv)
+{
+  return glm::u16vec2{glm::round(glm::clamp(uv, 0.0f, 1.0f) * 65535.0f)};
+}
+
+//! Octahedral normal encoding, see "A Survey of Efficient Representations for Independent Unit Vectors".
+[[nodiscard]] inline glm::i16vec2 packNormal(const glm::vec3& normal)
+{
+  const auto l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if(l1 <= 0)
+    return glm::i16vec2{0, 0};
+
+  auto p = glm::vec2{normal} / l1;
+  if(normal.z < 0)
+  {
+    const glm::vec2 signs{p.x >= 0 ? 1.0f : -1.0f, p.y >= 0 ? 1.0f : -1.0f};
+    p = (1.0f - glm::abs(glm::vec2{p.y, p.x})) * signs;
+  }
+  return glm::i16vec2{glm::round(glm::clamp(p, -1.0f, 1.0f) * 32767.0f)};
+}
+
+[[nodiscard]] inline glm::vec3 unpackNormal(const glm::i16vec2& packed)
+{
+  const auto p = glm::max(glm::vec2{packed} / 32767.0f, -1.0f);
+  glm::vec3 normal{p, 1.0f - std::abs(p.x) - std::abs(p.y)};
+  if(normal.z < 0)
+  {
+    const glm::vec2 signs{normal.x >= 0 ? 1.0f : -1.0f, normal.y >= 0 ? 1.0f : -1.0f};
+    const auto xy = (1.0f - glm::abs(glm::vec2{normal.y, normal.x})) * signs;
+    normal.x = xy.x;
+    normal.y = xy.y;
+  }
+  return glm::normalize(normal);
+}
+
+/**
+ * @brief A quad that needs perspective correct texturing, referenced by the vertices of its face.
+ *
+ * Only few faces are distorted, so this is kept out of the vertices. The layout matches the b_quads buffer.
+ */
+struct DistortedQuad
+{
+  std::array<glm::vec4, 4> vertices{};
+  //! The UV coordinates of the four vertices, two per element.
+  std::array<glm::vec4, 2> uvs{};
+
+  DistortedQuad(const std::array<glm::vec3, 4>& quadVertices, const std::array<glm::vec2, 4>& quadUvs)
+      : vertices{glm::vec4{quadVertices[0], 1.0f},
+                 glm::vec4{quadVertices[1], 1.0f},
+                 glm::vec4{quadVertices[2], 1.0f},
+                 glm::vec4{quadVertices[3], 1.0f}}
+      , uvs{glm::vec4{quadUvs[0], quadUvs[1]}, glm::vec4{quadUvs[2], quadUvs[3]}}
+  {
+  }
+};
+} // namespace render::scene
@@ -17,6 +17,11 @@ void Visitor::visit(Node& node)
     SOGLB_DEBUGGROUP(node.getName() + " <culled>");
     return;
   }
+  if(const auto* hiZBuffer = m_context.getHiZBuffer(); hiZBuffer != nullptr && node.isOccluded(*hiZBuffer, m_context.getHiZMargin()))
+  {
+    SOGLB_DEBUGGROUP(node.getName() + " <occluded>");
+    return;
+  }
 
   node.accept(*this);
 }
@@ -0,0 +1,279 @@
+#include "binarytree.h"
+
+#include <array>
+#include <boost/throw_exception.hpp>
+#include <cstring>
+#include <gsl/gsl-lite.hpp>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <zlib.h>
+
+namespace serialization
+{
+namespace
+{
+constexpr std::array<char, 4> Magic{'E', 'E', 'S', 'G'};
+//! Increase whenever the layout of the encoded data changes.
+constexpr uint32_t Version = 1;
+constexpr size_t HeaderSize = Magic.size() + sizeof(uint32_t) + sizeof(uint64_t);
+
+enum NodeFlags : uint8_t
+{
+  HasKey = 1u << 0u,
+  HasVal = 1u << 1u,
+  IsMap = 1u << 2u,
+  IsSeq = 1u << 3u,
+  HasKeyTag = 1u << 4u,
+  HasValTag = 1u << 5u,
+};
+
+template<typename T>
+void writeFixed(std::vector<uint8_t>& dst, T value)
+{
+  for(size_t i = 0; i < sizeof(T); ++i)
+  {
+    dst.emplace_back(static_cast<uint8_t>(value & 0xffu));
+    value >>= 8u;
+  }
+}
+
+template<typename T>
+T readFixed(const uint8_t* src)
+{
+  T value = 0;
+  for(size_t i = 0; i < sizeof(T); ++i)
+    value |= static_cast<T>(src[i]) << (8u * i);
+  return value;
+}
+
+void writeVarint(std::vector<uint8_t>& dst, size_t value)
+{
+  while(value >= 0x80u)
+  {
+    dst.emplace_back(static_cast<uint8_t>(value | 0x80u));
+    value >>= 7u;
+  }
+  dst.emplace_back(static_cast<uint8_t>(value));
+}
+
+class Encoder final
+{
+public:
+  explicit Encoder(const ryml::Tree& tree)
+      : m_tree{tree}
+  {
+  }
+
+  void encode(const size_t id)
+  {
+    uint8_t flags = 0;
+    if(m_tree.has_key(id))
+      flags |= HasKey;
+    if(m_tree.has_val(id))
+      flags |= HasVal;
+    if(m_tree.is_map(id))
+      flags |= IsMap;
+    if(m_tree.is_seq(id))
+      flags |= IsSeq;
+    if(m_tree.has_key_tag(id))
+      flags |= HasKeyTag;
+    if(m_tree.has_val_tag(id))
+      flags |= HasValTag;
+
+    m_nodes.emplace_back(flags);
+    if((flags & HasKey) != 0)
+      writeVarint(m_nodes, intern(m_tree.key(id)));
+    if((flags & HasVal) != 0)
+      writeVarint(m_nodes, intern(m_tree.val(id)));
+    if((flags & HasKeyTag) != 0)
+      writeVarint(m_nodes, intern(m_tree.key_tag(id)));
+    if((flags & HasValTag) != 0)
+      writeVarint(m_nodes, intern(m_tree.val_tag(id)));
+
+    if((flags & (IsMap | IsSeq)) == 0)
+      return;
+
+    writeVarint(m_nodes, m_tree.num_children(id));
+    for(auto child = m_tree.first_child(id); child != ryml::NONE; child = m_tree.next_sibling(child))
+      encode(child);
+  }
+
+  [[nodiscard]] std::vector<uint8_t> finish() const
+  {
+    std::vector<uint8_t> payload;
+    writeVarint(payload, m_strings.size());
+    for(const auto& str : m_strings)
+    {
+      writeVarint(payload, str.size());
+      payload.insert(payload.end(), str.begin(), str.end());
+    }
+    payload.insert(payload.end(), m_nodes.begin(), m_nodes.end());
+    return payload;
+  }
+
+private:
+  const ryml::Tree& m_tree;
+  std::map<std::string, size_t, std::less<>> m_stringIndices;
+  std::vector<std::string_view> m_strings;
+  std::vector<uint8_t> m_nodes;
+
+  size_t intern(const ryml::csubstr& str)
+  {
+    const std::string_view view{str.str, str.len};
+    if(auto it = m_stringIndices.find(view); it != m_stringIndices.end())
+      return it->second;
+
+    const auto index = m_strings.size();
+    auto it = m_stringIndices.emplace(std::string{view}, index).first;
+    m_strings.emplace_back(it->first);
+    return index;
+  }
+};
+
+class Decoder final
+{
+public:
+  Decoder(const std::vector<uint8_t>& payload, ryml::Tree& tree)
+      : m_payload{payload}
+      , m_tree{tree}
+  {
+  }
+
+  void decode()
+  {
+    const auto count = readVarint();
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.reserve(count);
+    size_t total = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+      const auto size = readVarint();
+      ensureAvailable(size);
+      ranges.emplace_back(m_position, size);
+      m_position += size;
+      total += size;
+    }
+
+    // growing the arena relocates its contents, which would invalidate the strings taken from it
+    m_tree.reserve_arena(total);
+    m_strings.reserve(count);
+    for(const auto& [offset, size] : ranges)
+    {
+      m_strings.emplace_back(m_tree.copy_to_arena(
+        ryml::csubstr{reinterpret_cast<const char*>(&m_payload[offset]), size})); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    decodeNode(m_tree.rootref());
+    if(m_position != m_payload.size())
+      BOOST_THROW_EXCEPTION(std::runtime_error("Trailing data in binary tree"));
+  }
+
+private:
+  const std::vector<uint8_t>& m_payload;
+  ryml::Tree& m_tree;
+  size_t m_position = 0;
+  std::vector<ryml::csubstr> m_strings;
+
+  void ensureAvailable(const size_t size) const
+  {
+    if(size > m_payload.size() - m_position)
+      BOOST_THROW_EXCEPTION(std::runtime_error("Unexpected end of binary tree"));
+  }
+
+  size_t readVarint()
+  {
+    size_t value = 0;
+    for(uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      ensureAvailable(1);
+      const auto byte = m_payload[m_position++];
+      value |= static_cast<size_t>(byte & 0x7fu) << shift;
+      if((byte & 0x80u) == 0)
+        return value;
+    }
+    BOOST_THROW_EXCEPTION(std::runtime_error("Invalid varint in binary tree"));
+  }
+
+  const ryml::csubstr& readString()
+  {
+    const auto index = readVarint();
+    if(index >= m_strings.size())
+      BOOST_THROW_EXCEPTION(std::runtime_error("Invalid string index in binary tree"));
+    return m_strings[index];
+  }
+
+  void decodeNode(ryml::NodeRef node)
+  {
+    ensureAvailable(1);
+    const auto flags = m_payload[m_position++];
+    if((flags & HasKey) != 0)
+      node.set_key(readString());
+    if((flags & HasVal) != 0)
+      node.set_val(readString());
+    if((flags & HasKeyTag) != 0)
+      node.set_key_tag(readString());
+    if((flags & HasValTag) != 0)
+      node.set_val_tag(readString());
+
+    if((flags & IsMap) != 0)
+      node |= ryml::MAP;
+    else if((flags & IsSeq) != 0)
+      node |= ryml::SEQ;
+    else
+      return;
+
+    const auto children = readVarint();
+    for(size_t i = 0; i < children; ++i)
+      decodeNode(node.append_child());
+  }
+};
+} // namespace
+
+std::vector<uint8_t> encodeBinaryTree(const ryml::Tree& tree)
+{
+  Encoder encoder{tree};
+  encoder.encode(tree.root_id());
+  const auto payload = encoder.finish();
+
+  auto compressedSize = compressBound(static_cast<uLong>(payload.size()));
+  std::vector<uint8_t> result;
+  result.insert(result.end(), Magic.begin(), Magic.end());
+  writeFixed(result, Version);
+  writeFixed(result, static_cast<uint64_t>(payload.size()));
+  result.resize(HeaderSize + compressedSize);
+  if(compress2(&result[HeaderSize], &compressedSize, payload.data(), static_cast<uLong>(payload.size()), Z_BEST_SPEED)
+     != Z_OK)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Compression failed"));
+  result.resize(HeaderSize + compressedSize);
+  return result;
+}
+
+bool isBinaryTree(const std::string& data)
+{
+  return data.size() >= HeaderSize && std::memcmp(data.data(), Magic.data(), Magic.size()) == 0;
+}
+
+void decodeBinaryTree(const std::string& data, ryml::Tree& tree)
+{
+  Expects(isBinaryTree(data));
+
+  const auto* header = reinterpret_cast<const uint8_t*>(data.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  if(const auto version = readFixed<uint32_t>(header + Magic.size()); version != Version)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Unsupported binary tree version " + std::to_string(version)));
+
+  const auto payloadSize = gsl::narrow<size_t>(readFixed<uint64_t>(header + Magic.size() + sizeof(uint32_t)));
+  std::vector<uint8_t> payload(payloadSize);
+  auto size = static_cast<uLongf>(payloadSize);
+  if(uncompress(payload.data(), &size, header + HeaderSize, static_cast<uLong>(data.size() - HeaderSize)) != Z_OK)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Decompression failed"));
+  if(size != payloadSize)
+    BOOST_THROW_EXCEPTION(std::runtime_error("Decompressed size mismatch"));
+
+  tree.clear();
+  tree.clear_arena();
+  // an empty tree has no root yet
+  tree.reserve(16);
+  Decoder{payload, tree}.decode();
+}
+} // namespace serialization
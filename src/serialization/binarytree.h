@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <ryml.hpp>
+#include <string>
+#include <vector>
+
+namespace serialization
+{
+/**
+ * @brief Encodes a tree into a compressed binary representation.
+ *
+ * Keys, values and tags are stored once in a string table and referenced by index, so the repetitive structure of
+ * savegames compresses well and doesn't need to be parsed on load.
+ */
+[[nodiscard]] extern std::vector<uint8_t> encodeBinaryTree(const ryml::Tree& tree);
+
+//! Checks whether @a data starts with the header of an encoded tree.
+[[nodiscard]] extern bool isBinaryTree(const std::string& data);
+
+/**
+ * @brief Replaces the contents of @a tree with the decoded @a data.
+ *
+ * Strings are copied into the tree's arena, so @a data doesn't need to outlive the tree.
+ */
+extern void decodeBinaryTree(const std::string& data, ryml::Tree& tree);
+} // namespace serialization
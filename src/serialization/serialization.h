@@ -13,6 +13,8 @@
 #include <ryml.hpp>
 #include <ryml_std.hpp>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 
 // #define SERIALIZATION_TRACE
 
@@ -62,11 +64,22 @@ struct Default;
 template<typename T>
 struct OptionalValue;
 
+//! Fills the node with the given id of a saved tree, see Serializer::deferSave().
+using DeferredSave = std::pair<size_t, std::function<void(const ryml::NodeRef&)>>;
+using DeferredSaveList = std::vector<DeferredSave>;
+
+//! The context of values saved by Serializer::deferSave(), which must not depend on any context.
+struct NoContext final
+{
+};
+
 template<typename TContext>
 class Serializer final
 {
   template<bool>
   friend class YAMLDocument;
+  template<typename>
+  friend class Serializer;
 
   using LazyWithContext = std::function<void()>;
   using LazyQueue = std::queue<LazyWithContext>;
@@ -74,24 +87,32 @@ class Serializer final
   explicit Serializer(const ryml::NodeRef& node,
                       TContext& context,
                       bool loading,
-                      const std::shared_ptr<LazyQueue>& lazyQueue)
+                      const std::shared_ptr<LazyQueue>& lazyQueue,
+                      const std::shared_ptr<DeferredSaveList>& deferredSaves)
       : m_lazyQueue{lazyQueue == nullptr ? std::make_shared<LazyQueue>() : lazyQueue}
+      , m_deferredSaves{deferredSaves == nullptr ? std::make_shared<DeferredSaveList>() : deferredSaves}
       , node{node}
       , context{context}
       , loading{loading}
   {
-    ryml::set_callbacks(ryml::Callbacks{
-      nullptr,
-      [](size_t length, void* /*hint*/, void* /*user_data*/) -> gsl::owner<void*> { return new char[length]; },
-      [](gsl::owner<void*> mem, size_t /*length*/, void* /*user_data*/) { delete[] static_cast<char*>(mem); },
-      [](const char* msg, size_t msg_len, ryml::Location /*location*/, void* /*user_data*/)
-      {
-        const std::string msgStr{msg, msg_len};
-        SERIALIZER_EXCEPTION(msgStr);
-      }});
+    // set only once, as deferred saves may create serializers on other threads
+    [[maybe_unused]] static const bool callbacksSet = []()
+    {
+      ryml::set_callbacks(ryml::Callbacks{
+        nullptr,
+        [](size_t length, void* /*hint*/, void* /*user_data*/) -> gsl::owner<void*> { return new char[length]; },
+        [](gsl::owner<void*> mem, size_t /*length*/, void* /*user_data*/) { delete[] static_cast<char*>(mem); },
+        [](const char* msg, size_t msg_len, ryml::Location /*location*/, void* /*user_data*/)
+        {
+          const std::string msgStr{msg, msg_len};
+          SERIALIZER_EXCEPTION(msgStr);
+        }});
+      return true;
+    }();
   }
 
   std::shared_ptr<LazyQueue> m_lazyQueue;
+  std::shared_ptr<DeferredSaveList> m_deferredSaves;
   mutable std::string m_tag;
 
   void processQueues()
@@ -227,6 +248,30 @@ public:
     lazy([pdata = &data, name = name](const Serializer<TContext>& ser) { ser(name, *pdata); });
   }
 
+  /**
+   * @brief Saves @a data into this node only when the saved tree is finished, which may happen on another thread.
+   *
+   * @a data is kept until then, so it must be a copy that doesn't refer to anything that may change in the meantime.
+   * It is saved with a NoContext serializer, and without switching to the "C" locale, so it should only consist of
+   * integers, booleans and strings.
+   */
+  template<typename T>
+  void deferSave(T&& data) const
+  {
+    Expects(!loading);
+    Expects(!node.is_seed());
+    m_deferredSaves->emplace_back(
+      node.id(),
+      [data = std::forward<T>(data)](const ryml::NodeRef& target) mutable
+      {
+        NoContext noContext{};
+        Serializer<NoContext> ser{target, noContext, false, nullptr, nullptr};
+        access<std::decay_t<T>>::callSerializeOrSave(data, ser);
+        ser.processQueues();
+        Expects(ser.m_deferredSaves->empty());
+      });
+  }
+
   template<typename T, typename... Ts>
   const Serializer<TContext>& operator()(const gsl::not_null<gsl::czstring>& headName, T&& headData, Ts&&... tail) const
   {
@@ -337,7 +382,7 @@ public:
 
   Serializer<TContext> withNode(const ryml::NodeRef& otherNode) const
   {
-    return Serializer{otherNode, context, loading, m_lazyQueue};
+    return Serializer{otherNode, context, loading, m_lazyQueue, m_deferredSaves};
   }
 
   Serializer<TContext> newChild() const
@@ -0,0 +1,122 @@
+#define BOOST_TEST_MODULE serialization
+
+#include "binarytree.h"
+
+#include <boost/test/included/unit_test.hpp>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+ryml::NodeRef appendChild(ryml::NodeRef& parent, const char* key)
+{
+  auto child = parent.append_child();
+  child.set_key(ryml::to_csubstr(key));
+  return child;
+}
+
+std::string toYaml(const ryml::Tree& tree)
+{
+  std::ostringstream stream;
+  stream << tree.rootref();
+  return stream.str();
+}
+
+std::string encode(const ryml::Tree& tree)
+{
+  const auto data = serialization::encodeBinaryTree(tree);
+  return std::string{data.begin(), data.end()};
+}
+
+//! Builds a tree the way the serializer does, including the nodes that are easy to get wrong.
+ryml::Tree createTree()
+{
+  ryml::Tree tree;
+  auto root = tree.rootref();
+  root |= ryml::MAP;
+
+  auto tagged = appendChild(root, "tagged");
+  tagged << 42;
+  tagged.set_val_tag("!<box>");
+
+  auto null = appendChild(root, "null");
+  null.set_val("~");
+  null.set_val_tag("!!null");
+
+  appendChild(root, "emptyMap") |= ryml::MAP;
+  appendChild(root, "emptySeq") |= ryml::SEQ;
+  appendChild(root, "emptyString").set_val("");
+
+  auto seq = appendChild(root, "seq");
+  seq |= ryml::SEQ;
+  for(int i = 0; i < 3; ++i)
+  {
+    auto element = seq.append_child();
+    element |= ryml::MAP;
+    appendChild(element, "key") << i;
+    // repeated strings are only stored once
+    appendChild(element, "value").set_val("repeated");
+  }
+
+  return tree;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(binarytree_tests)
+
+BOOST_AUTO_TEST_CASE(test_round_trip)
+{
+  const auto tree = createTree();
+  const auto data = encode(tree);
+  BOOST_REQUIRE(serialization::isBinaryTree(data));
+
+  ryml::Tree decoded;
+  serialization::decodeBinaryTree(data, decoded);
+  BOOST_CHECK_EQUAL(toYaml(decoded), toYaml(tree));
+
+  const auto root = decoded.rootref();
+  BOOST_REQUIRE(root.is_map());
+  BOOST_REQUIRE_EQUAL(root.num_children(), 6);
+
+  BOOST_CHECK(root["tagged"].val() == "42");
+  BOOST_REQUIRE(root["tagged"].has_val_tag());
+  BOOST_CHECK(root["tagged"].val_tag() == "!<box>");
+
+  BOOST_CHECK(root["null"].val() == "~");
+  BOOST_REQUIRE(root["null"].has_val_tag());
+  BOOST_CHECK(root["null"].val_tag() == "!!null");
+
+  BOOST_CHECK(root["emptyMap"].is_map());
+  BOOST_CHECK_EQUAL(root["emptyMap"].num_children(), 0);
+  BOOST_CHECK(root["emptySeq"].is_seq());
+  BOOST_CHECK_EQUAL(root["emptySeq"].num_children(), 0);
+  BOOST_CHECK(root["emptyString"].has_val());
+  BOOST_CHECK(root["emptyString"].val().empty());
+
+  const auto seq = root["seq"];
+  BOOST_REQUIRE(seq.is_seq());
+  BOOST_REQUIRE_EQUAL(seq.num_children(), 3);
+  BOOST_CHECK(seq[2]["key"].val() == "2");
+  BOOST_CHECK(seq[2]["value"].val() == "repeated");
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_replaces_contents)
+{
+  ryml::Tree decoded = createTree();
+  ryml::Tree empty;
+  empty.rootref() |= ryml::MAP;
+  serialization::decodeBinaryTree(encode(empty), decoded);
+  BOOST_CHECK(decoded.rootref().is_map());
+  BOOST_CHECK_EQUAL(decoded.rootref().num_children(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_reject_invalid_data)
+{
+  BOOST_CHECK(!serialization::isBinaryTree("data: 42\n"));
+
+  const auto data = encode(createTree());
+  ryml::Tree decoded;
+  BOOST_CHECK_THROW(serialization::decodeBinaryTree(data.substr(0, data.size() - 1), decoded), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,15 +1,47 @@
 #pragma once
 
-#include "serialization_fwd.h"
+#include "binarytree.h"
+#include "serialization.h"
 
 #include <filesystem>
 #include <fstream>
 #include <gsl/gsl-lite.hpp>
 #include <ryml.hpp>
 #include <type_traits>
+#include <utility>
 
 namespace serialization
 {
+/**
+ * @brief A saved tree whose deferred nodes are not filled yet, see Serializer::deferSave().
+ *
+ * It owns everything the deferred nodes are filled from, so it can be finished on another thread.
+ */
+class SavedTree final
+{
+public:
+  SavedTree() = default;
+
+  explicit SavedTree(ryml::Tree tree, DeferredSaveList deferredSaves)
+      : m_tree{std::move(tree)}
+      , m_deferredSaves{std::move(deferredSaves)}
+  {
+  }
+
+  //! Fills the deferred nodes, and hands over the complete tree.
+  [[nodiscard]] ryml::Tree finish() &&
+  {
+    for(auto& [id, save] : m_deferredSaves)
+      save(ryml::NodeRef{&m_tree, id});
+    m_deferredSaves.clear();
+    return std::move(m_tree);
+  }
+
+private:
+  ryml::Tree m_tree;
+  DeferredSaveList m_deferredSaves;
+};
+
 template<bool Loading>
 class YAMLDocument
 {
@@ -17,14 +49,29 @@ private:
   const std::filesystem::path m_filename;
   std::string m_buffer;
   ryml::Tree m_tree;
+  std::shared_ptr<DeferredSaveList> m_deferredSaves = std::make_shared<DeferredSaveList>();
 
 public:
+  //! Creates an empty document that is kept in memory, to be taken over by release().
+  template<bool DelayLoading = Loading, typename = std::enable_if_t<!DelayLoading>>
+  YAMLDocument()
+  {
+    m_tree.rootref() |= ryml::MAP;
+  }
+
+  //! Loads from a tree in memory, e.g. one taken over from another document by release().
+  template<bool DelayLoading = Loading, typename = std::enable_if_t<DelayLoading>>
+  explicit YAMLDocument(ryml::Tree tree)
+      : m_tree{std::move(tree)}
+  {
+  }
+
   explicit YAMLDocument(const std::filesystem::path& filename)
       : m_filename{filename}
   {
     if constexpr(Loading)
     {
-      std::ifstream file{filename, std::ios::in};
+      std::ifstream file{filename, std::ios::in | std::ios::binary};
       Expects(file.is_open());
       file.seekg(0, std::ios::end);
       const auto size = static_cast<std::size_t>(file.tellg());
@@ -32,12 +79,14 @@ public:
 
       m_buffer.resize(size);
       file.read(&m_buffer[0], size);
-      m_tree = ryml::parse(c4::to_csubstr(filename.string()), c4::to_csubstr(m_buffer));
+      if(isBinaryTree(m_buffer))
+        decodeBinaryTree(m_buffer, m_tree);
+      else
+        m_tree = ryml::parse(c4::to_csubstr(filename.string()), c4::to_csubstr(m_buffer));
     }
     else
     {
-      std::ofstream file{filename, std::ios::out | std::ios::trunc};
-      Expects(file.is_open());
+      // the file is only touched when writing, so a failing save doesn't destroy an existing file
       m_tree.rootref() |= ryml::MAP;
     }
   }
@@ -48,7 +97,7 @@ public:
     const std::string oldLocale = setlocale(LC_NUMERIC, nullptr);
     setlocale(LC_NUMERIC, "C");
 
-    Serializer<TContext> ser{m_tree.rootref()[c4::to_csubstr(key)], context, true, nullptr};
+    Serializer<TContext> ser{m_tree.rootref()[c4::to_csubstr(key)], context, true, nullptr, nullptr};
     auto result = access<T>::callCreate(ser);
     ser.processQueues();
 
@@ -62,7 +111,7 @@ public:
     const std::string oldLocale = setlocale(LC_NUMERIC, nullptr);
     setlocale(LC_NUMERIC, "C");
 
-    Serializer<TContext> ser{m_tree.rootref()[c4::to_csubstr(key)], context, true, nullptr};
+    Serializer<TContext> ser{m_tree.rootref()[c4::to_csubstr(key)], context, true, nullptr, nullptr};
     access<T>::callSerializeOrLoad(data, ser);
     ser.processQueues();
 
@@ -75,7 +124,11 @@ public:
     const std::string oldLocale = setlocale(LC_NUMERIC, nullptr);
     setlocale(LC_NUMERIC, "C");
 
-    Serializer ser{m_tree.rootref()[m_tree.copy_to_arena(c4::to_csubstr(key))], context, false, nullptr};
+    Serializer ser{m_tree.rootref()[m_tree.copy_to_arena(c4::to_csubstr(key))],
+                   context,
+                   false,
+                   nullptr,
+                   m_deferredSaves};
     access<T>::callSerializeOrSave(data, ser);
     ser.processQueues();
 
@@ -83,13 +136,28 @@ public:
   }
 
   template<bool DelayLoading = Loading>
-  auto write() const -> std::enable_if_t<!DelayLoading, void>
+  auto write() -> std::enable_if_t<!DelayLoading, void>
   {
+    m_tree = releaseSaved().finish();
     std::ofstream file{m_filename, std::ios::out | std::ios::trunc};
     Expects(file.is_open());
     file << m_tree.rootref();
   }
 
+  //! Hands over the serialized tree, e.g. for writing it in the background; the document is empty afterwards.
+  template<bool DelayLoading = Loading>
+  auto releaseSaved() -> std::enable_if_t<!DelayLoading, SavedTree>
+  {
+    return SavedTree{std::move(m_tree), std::exchange(*m_deferredSaves, {})};
+  }
+
+  //! Like releaseSaved(), but fills the deferred nodes right away.
+  template<bool DelayLoading = Loading>
+  auto release() -> std::enable_if_t<!DelayLoading, ryml::Tree>
+  {
+    return releaseSaved().finish();
+  }
+
   template<bool DelayLoading = Loading>
   auto operator[](const std::string& key) -> std::enable_if_t<DelayLoading, ryml::NodeRef>
   {
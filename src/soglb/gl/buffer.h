@@ -34,6 +34,34 @@ public:
     GL_ASSERT(api::unmapNamedBuffer(getHandle()));
   }
 
+  /**
+   * @brief Allocates immutable storage that stays mapped for writing for the lifetime of the buffer.
+   *
+   * Writes are visible to the GPU without flushing, but the caller must make sure the GPU doesn't read any data
+   * that is being overwritten. The storage cannot be re-specified with setData afterwards.
+   */
+  [[nodiscard]] T* allocatePersistent(const api::core::SizeType size)
+  {
+    Expects(size > 0);
+    Expects(m_size == 0);
+
+    m_size = size;
+    const auto bytes = gsl::narrow<std::size_t>(sizeof(T) * m_size);
+    GL_ASSERT(api::namedBufferStorage(getHandle(),
+                                      bytes,
+                                      nullptr,
+                                      api::BufferStorageMask::MapWriteBit | api::BufferStorageMask::MapPersistentBit
+                                        | api::BufferStorageMask::MapCoherentBit));
+    void* data = GL_ASSERT_FN(api::mapNamedBufferRange(getHandle(),
+                                                       0,
+                                                       bytes,
+                                                       api::MapBufferAccessMask::MapWriteBit
+                                                         | api::MapBufferAccessMask::MapPersistentBit
+                                                         | api::MapBufferAccessMask::MapCoherentBit));
+    Ensures(data != nullptr);
+    return static_cast<T*>(data);
+  }
+
   void setData(const T& data, const api::BufferUsage usage)
   {
     setData(&data, 1, usage);
@@ -124,8 +152,11 @@ public:
 
   void drawElements(api::PrimitiveType primitiveType, api::core::SizeType instances) const
   {
-    GL_ASSERT(api::drawElementsInstance(
-      primitiveType, Buffer<T, api::BufferTarget::ElementArrayBuffer>::size(), DrawElementsType<T>, instances));
+    GL_ASSERT(api::drawElementsInstance(primitiveType,
+                                        Buffer<T, api::BufferTarget::ElementArrayBuffer>::size(),
+                                        DrawElementsType<T>,
+                                        nullptr,
+                                        instances));
   }
 };
 } // namespace gl
@@ -0,0 +1,40 @@
+#include "fence.h"
+
+#include "api/gl_api_provider.hpp"
+#include "glassert.h"
+
+#include <boost/assert.hpp>
+
+namespace gl
+{
+Fence::Fence()
+{
+  // glFenceSync is not part of the generated bindings, see soglb_gen.py
+  m_sync = static_cast<api::core::Sync>(GL_ASSERT_FN(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)));
+  BOOST_ASSERT(m_sync != nullptr);
+}
+
+Fence::~Fence()
+{
+  if(m_sync != nullptr)
+    GL_ASSERT(api::deleteSync(m_sync));
+}
+
+void Fence::wait() const
+{
+  static constexpr uint64_t Timeout = 1000000000; // 1 second, in nanoseconds
+
+  // flushing once is enough to guarantee the fence will eventually be signaled
+  auto status = GL_ASSERT_FN(api::clientWaitSync(m_sync, api::SyncObjectMask::SyncFlushCommandsBit, Timeout));
+  while(status == api::SyncStatus::TimeoutExpired)
+    status = GL_ASSERT_FN(api::clientWaitSync(m_sync, {}, Timeout));
+  BOOST_ASSERT(status != api::SyncStatus::WaitFailed);
+}
+
+bool Fence::isSignaled() const
+{
+  const auto status = GL_ASSERT_FN(api::clientWaitSync(m_sync, api::SyncObjectMask::SyncFlushCommandsBit, 0));
+  BOOST_ASSERT(status != api::SyncStatus::WaitFailed);
+  return status == api::SyncStatus::AlreadySignaled || status == api::SyncStatus::ConditionSatisfied;
+}
+} // namespace gl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "api/gl.hpp"
+
+#include <utility>
+
+namespace gl
+{
+//! A sync object that becomes signaled when all commands submitted before its creation have completed.
+class Fence final
+{
+public:
+  explicit Fence();
+
+  Fence(const Fence&) = delete;
+  Fence& operator=(const Fence&) = delete;
+
+  Fence(Fence&& rhs) noexcept
+      : m_sync{std::exchange(rhs.m_sync, nullptr)}
+  {
+  }
+
+  Fence& operator=(Fence&& rhs) noexcept
+  {
+    std::swap(m_sync, rhs.m_sync);
+    return *this;
+  }
+
+  ~Fence();
+
+  //! Blocks until the fence is signaled.
+  void wait() const;
+
+  //! Returns immediately whether the fence is signaled.
+  [[nodiscard]] bool isSignaled() const;
+
+private:
+  api::core::Sync m_sync = nullptr;
+};
+} // namespace gl
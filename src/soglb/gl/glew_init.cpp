@@ -5,6 +5,7 @@
 
 #include <GL/glew.h>
 #include <boost/log/trivial.hpp>
+#include <limits>
 
 using namespace gl;
 
@@ -110,6 +111,14 @@ void gl::initializeGl()
 
   GL_ASSERT(api::enable(api::EnableCap::FramebufferSrgb));
 
+  if(GLEW_KHR_parallel_shader_compile == GL_TRUE)
+    GL_ASSERT(glMaxShaderCompilerThreadsKHR(std::numeric_limits<GLuint>::max()));
+  else if(GLEW_ARB_parallel_shader_compile == GL_TRUE)
+    GL_ASSERT(glMaxShaderCompilerThreadsARB(std::numeric_limits<GLuint>::max()));
+  BOOST_LOG_TRIVIAL(info) << "Parallel shader compilation is "
+                          << (hasParallelShaderCompileExtension() ? "supported" : "not supported")
+                          << " on this platform";
+
   if(!hasAnisotropicFilteringExtension())
     BOOST_LOG_TRIVIAL(info) << "Anisotropic filtering is not supported on this platform";
   else
@@ -129,3 +138,28 @@ float gl::getMaxAnisotropyLevel()
   GL_ASSERT(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &value));
   return value;
 }
+
+bool gl::hasParallelShaderCompileExtension()
+{
+  return GLEW_KHR_parallel_shader_compile == GL_TRUE || GLEW_ARB_parallel_shader_compile == GL_TRUE;
+}
+
+bool gl::hasProgramBinarySupport()
+{
+  int32_t formats = 0;
+  GL_ASSERT(api::getIntegerv(api::GetPName::NumProgramBinaryFormats, &formats));
+  return formats > 0;
+}
+
+std::string gl::getDriverId()
+{
+  std::string result;
+  for(const auto name : {api::StringName::Vendor, api::StringName::Renderer, api::StringName::Version})
+  {
+    if(!result.empty())
+      result += ';';
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    result += reinterpret_cast<const char*>(GL_ASSERT_FN(api::getString(name)));
+  }
+  return result;
+}
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <string>
+
 namespace gl
 {
 extern void initializeGl();
 extern bool hasAnisotropicFilteringExtension();
 extern float getMaxAnisotropyLevel();
+extern bool hasParallelShaderCompileExtension();
+//! Whether program binaries can be retrieved and loaded again.
+extern bool hasProgramBinarySupport();
+//! Identifies the driver; program binaries are only valid for the driver they were created with.
+extern std::string getDriverId();
 } // namespace gl
@@ -117,6 +117,15 @@ public:
     GL_ASSERT(api::bindBufferBase(_Target, m_binding, buffer.getHandle()));
   }
 
+  //! Binds a part of a buffer; the buffer may have been created for a different target.
+  // NOLINTNEXTLINE(bugprone-reserved-identifier)
+  template<typename T, api::BufferTarget _BufferTarget>
+  void bindRange(const Buffer<T, _BufferTarget>& buffer, const std::intptr_t offset, const std::size_t size)
+  {
+    Expects(m_binding >= 0);
+    GL_ASSERT(api::bindBufferRange(_Target, m_binding, buffer.getHandle(), offset, size));
+  }
+
   [[nodiscard]] auto getBinding() const noexcept
   {
     return m_binding;
@@ -389,6 +398,36 @@ public:
     return success == static_cast<int32_t>(api::Boolean::True);
   }
 
+  //! Must be set before linking so that getBinary() can be used.
+  // ReSharper disable once CppMemberFunctionMayBeConst
+  void setBinaryRetrievable()
+  {
+    GL_ASSERT(api::programParameter(getHandle(), api::ProgramParameterPName::ProgramBinaryRetrievableHint, 1));
+  }
+
+  [[nodiscard]] std::vector<uint8_t> getBinary(api::core::EnumType& format) const
+  {
+    int32_t length = 0;
+    GL_ASSERT(api::getProgram(getHandle(), api::ProgramProperty::ProgramBinaryLength, &length));
+    std::vector<uint8_t> binary(gsl::narrow<size_t>(length));
+    if(binary.empty())
+      return binary;
+
+    api::core::SizeType written = 0;
+    GL_ASSERT(api::getProgramBinary(getHandle(), length, &written, &format, binary.data()));
+    binary.resize(gsl::narrow<size_t>(written));
+    return binary;
+  }
+
+  //! Replaces the program with a binary from getBinary(); drivers may reject it, check getLinkStatus() afterwards.
+  // ReSharper disable once CppMemberFunctionMayBeConst
+  void setBinary(const api::core::EnumType format, const std::vector<uint8_t>& binary, const std::string& label = {})
+  {
+    GL_ASSERT(api::programBinary(getHandle(), format, binary.data(), gsl::narrow<api::core::SizeType>(binary.size())));
+
+    setLabel(api::ObjectIdentifier::Program, label);
+  }
+
   [[nodiscard]] std::string getInfoLog() const
   {
     int32_t length = 0;
@@ -2,8 +2,32 @@
 
 #include "glassert.h"
 
+#include <boost/container_hash/hash.hpp>
+#include <tuple>
+#include <type_traits>
+
 namespace gl
 {
+namespace
+{
+template<typename T>
+void hashValue(size_t& seed, const T& value)
+{
+  if constexpr(std::is_enum_v<T>)
+    boost::hash_combine(seed, static_cast<std::underlying_type_t<T>>(value));
+  else
+    boost::hash_combine(seed, value);
+}
+
+template<typename T>
+void hashOptional(size_t& seed, const std::optional<T>& value)
+{
+  boost::hash_combine(seed, value.has_value());
+  if(value.has_value())
+    hashValue(seed, *value);
+}
+} // namespace
+
 inline RenderState& getCurrentState()
 {
   static RenderState currentState{};
@@ -148,6 +172,25 @@ void RenderState::merge(const RenderState& other)
 #undef MERGE_OPT
 }
 
+size_t RenderState::getSortKey() const
+{
+  size_t seed = 0;
+  hashOptional(seed, m_cullFaceEnabled);
+  hashOptional(seed, m_depthTestEnabled);
+  hashOptional(seed, m_depthWriteEnabled);
+  hashOptional(seed, m_depthClampEnabled);
+  hashOptional(seed, m_depthFunction);
+  hashOptional(seed, m_blendEnabled);
+  boost::hash_combine(seed, m_blendFactors.has_value());
+  if(m_blendFactors.has_value())
+    std::apply([&seed](const auto&... factors) { (hashValue(seed, factors), ...); }, *m_blendFactors);
+  hashOptional(seed, m_cullFaceSide);
+  hashOptional(seed, m_frontFace);
+  hashOptional(seed, m_lineWidth);
+  hashOptional(seed, m_lineSmooth);
+  return seed;
+}
+
 RenderState& RenderState::getWantedState()
 {
   static RenderState wantedState;
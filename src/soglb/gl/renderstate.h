@@ -106,6 +106,14 @@ public:
 
   void merge(const RenderState& other);
 
+  [[nodiscard]] bool isBlendEnabled() const
+  {
+    return m_blendEnabled.value_or(false);
+  }
+
+  //! A hash of all explicitly set states, equal for states that result in the same GL state changes.
+  [[nodiscard]] size_t getSortKey() const;
+
 private:
   void apply(bool force = false) const;
 
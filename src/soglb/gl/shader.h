@@ -15,6 +15,12 @@ class Shader final
 public:
   static constexpr api::ShaderType Type = _Type;
 
+  /**
+   * @brief Starts compiling the shader.
+   *
+   * The compile status isn't queried here, so drivers supporting parallel shader compilation can compile multiple
+   * shaders in the background; check it with getCompileStatus() if linking a program using this shader fails.
+   */
   explicit Shader(const gsl::span<gsl::czstring>& src, const std::string& label = {})
       : m_handle{GL_ASSERT_FN(api::createShader(Type))}
   {
@@ -22,34 +28,36 @@ public:
     GL_ASSERT(api::shaderSource(m_handle, gsl::narrow<api::core::SizeType>(src.size()), src.data(), nullptr));
     GL_ASSERT(api::compileShader(m_handle));
 
-    auto success = static_cast<int>(api::Boolean::False);
-    GL_ASSERT(api::getShader(m_handle, api::ShaderParameterName::CompileStatus, &success));
-    if(success != static_cast<int>(api::Boolean::True))
+    if(!label.empty())
     {
-      BOOST_LOG_TRIVIAL(error) << "Failed to compile shader program " << label;
+      GL_ASSERT(api::objectLabel(api::ObjectIdentifier::Shader, m_handle, -1, label.c_str()));
+    }
+  }
 
-      int32_t length = 0;
-      GL_ASSERT(api::getShader(m_handle, api::ShaderParameterName::InfoLogLength, &length));
-      if(length == 0)
-      {
-        length = 4096;
-      }
-      if(length > 0)
-      {
-        std::vector<char> infoLog(length, '\0');
-        GL_ASSERT(api::getShaderInfoLog(m_handle, length, nullptr, infoLog.data()));
-        infoLog.back() = '\0';
-        std::string result = infoLog.data();
-        BOOST_LOG_TRIVIAL(error) << infoLog.data();
-      }
+  [[nodiscard]] bool getCompileStatus() const
+  {
+    auto success = static_cast<int>(api::Boolean::False);
+    GL_ASSERT(api::getShader(m_handle, api::ShaderParameterName::CompileStatus, &success));
+    return success == static_cast<int>(api::Boolean::True);
+  }
 
-      BOOST_THROW_EXCEPTION(std::runtime_error("Failed to compile shader program"));
+  [[nodiscard]] std::string getInfoLog() const
+  {
+    int32_t length = 0;
+    GL_ASSERT(api::getShader(m_handle, api::ShaderParameterName::InfoLogLength, &length));
+    if(length == 0)
+    {
+      length = 4096;
     }
-
-    if(!label.empty())
+    if(length > 0)
     {
-      GL_ASSERT(api::objectLabel(api::ObjectIdentifier::Shader, m_handle, -1, label.c_str()));
+      std::vector<char> infoLog(length, '\0');
+      GL_ASSERT(api::getShaderInfoLog(m_handle, length, nullptr, infoLog.data()));
+      infoLog.back() = '\0';
+      return infoLog.data();
     }
+
+    return {};
   }
 
   Shader(const Shader&) = delete;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "api/gl.hpp"
+#include "glassert.h"
+
+#include <boost/assert.hpp>
+#include <cstdint>
+#include <utility>
+
+namespace gl
+{
+class TimestampQuery final
+{
+public:
+  explicit TimestampQuery()
+  {
+    GL_ASSERT(api::genQuerie(1, &m_handle));
+    BOOST_ASSERT(m_handle != 0);
+  }
+
+  TimestampQuery(const TimestampQuery&) = delete;
+  TimestampQuery& operator=(const TimestampQuery&) = delete;
+
+  TimestampQuery(TimestampQuery&& rhs) noexcept
+      : m_handle{std::exchange(rhs.m_handle, 0)}
+  {
+  }
+
+  TimestampQuery& operator=(TimestampQuery&& rhs) noexcept
+  {
+    std::swap(m_handle, rhs.m_handle);
+    return *this;
+  }
+
+  ~TimestampQuery()
+  {
+    if(m_handle != 0)
+      GL_ASSERT(api::deleteQuerie(1, &m_handle));
+  }
+
+  //! Records the GPU time when all previously submitted commands have completed.
+  void record()
+  {
+    GL_ASSERT(api::queryCounter(m_handle, api::QueryCounterTarget::Timestamp));
+  }
+
+  [[nodiscard]] bool isAvailable() const
+  {
+    int32_t available = 0;
+    GL_ASSERT(api::getQueryObject(m_handle, api::QueryObjectParameterName::QueryResultAvailable, &available));
+    return available != 0;
+  }
+
+  //! GPU time in nanoseconds; blocks until the result is available.
+  [[nodiscard]] uint64_t getTimestamp() const
+  {
+    uint64_t timestamp = 0;
+    GL_ASSERT(api::getQueryObject(m_handle, api::QueryObjectParameterName::QueryResult, &timestamp));
+    return timestamp;
+  }
+
+  //! The current GPU time in nanoseconds, without waiting for submitted commands.
+  [[nodiscard]] static int64_t getCurrentTimestamp()
+  {
+    int64_t timestamp = 0;
+    GL_ASSERT(api::getInteger64v(api::GetPName::Timestamp, &timestamp));
+    return timestamp;
+  }
+
+private:
+  uint32_t m_handle = 0;
+};
+} // namespace gl
@@ -18,9 +18,10 @@ void glErrorCallback(const int err, const gsl::czstring msg)
 }
 } // namespace
 
-Window::Window(const glm::ivec2& resolution)
+Window::Window(const glm::ivec2& resolution, bool visible)
     : m_windowPos{0, 0}
     , m_windowSize{resolution}
+    , m_visible{visible}
 {
   glfwSetErrorCallback(&glErrorCallback);
 
@@ -41,6 +42,7 @@ Window::Window(const glm::ivec2& resolution)
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+  glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 #ifdef SOGLB_DEBUGGING
   glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
 #else
@@ -106,7 +108,7 @@ void Window::swapBuffers() const
 
 void Window::setFullscreen()
 {
-  if(m_isFullscreen)
+  if(m_isFullscreen || !m_visible)
     return;
 
   const auto mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
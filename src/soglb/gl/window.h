@@ -9,7 +9,7 @@ namespace gl
 class Window final
 {
 public:
-  explicit Window(const glm::ivec2& resolution = {1280, 800});
+  explicit Window(const glm::ivec2& resolution = {1280, 800}, bool visible = true);
   ~Window();
 
   [[nodiscard]] bool isVsync() const;
@@ -53,6 +53,11 @@ public:
     return m_viewport.x <= 0 || m_viewport.y <= 0;
   }
 
+  [[nodiscard]] bool isVisible() const noexcept
+  {
+    return m_visible;
+  }
+
 private:
   GLFWwindow* m_window = nullptr;
   bool m_vsync = false;
@@ -60,5 +65,6 @@ private:
   glm::ivec2 m_windowSize{0};
   glm::ivec2 m_viewport{0};
   bool m_isFullscreen = false;
+  bool m_visible = true;
 };
 } // namespace gl